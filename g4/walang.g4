@@ -83,57 +83,27 @@ prefixExpression: prefixOperator expression;
 
 parenthesesExpression: '(' expression ')';
 
-binaryExpressionRightWithOp:
-	binaryOperator binaryExpressionRight;
-binaryExpressionLeft:
-	identifier
-	| prefixExpression
-	| parenthesesExpression
-	// | binaryExpression | ternaryExpression
-	| callExpression
-	| memberExpression;
-binaryExpressionRight:
-	identifier
-	| prefixExpression
-	| parenthesesExpression
-	| binaryExpression
-	//| ternaryExpression
-	| callExpression
-	| memberExpression;
-binaryExpression:
-	binaryExpressionLeft binaryExpressionRightWithOp+;
-
-ternaryExpressionBody: '?' expression ':' expression;
-ternaryExpressionCondition:
-	identifier
-	| prefixExpression
-	| parenthesesExpression
-	| binaryExpression
-	// | ternaryExpression
-	| callExpression
-	| memberExpression;
-ternaryExpression:
-	ternaryExpressionCondition ternaryExpressionBody+;
-
 callOrMemberExpressionLeft: identifier | parenthesesExpression;
 callExpressionRight: '(' (expression (',' expression)*)? ')';
 memberExpressionRight: '.' Identifier;
 callOrMemberExpressionRight:
 	callExpressionRight
 	| memberExpressionRight;
-callExpression:
-	callOrMemberExpressionLeft callOrMemberExpressionRight* callExpressionRight;
-memberExpression:
-	callOrMemberExpressionLeft callOrMemberExpressionRight* memberExpressionRight;
+callOrMemberExpression:
+	callOrMemberExpressionLeft callOrMemberExpressionRight*;
+
+// prefix operator after binary operator only applies to the next operand
+binaryOperand: prefixOperator binaryOperand | callOrMemberExpression;
+binaryExpressionRightWithOp: binaryOperator binaryOperand;
+binaryExpression:
+	callOrMemberExpression binaryExpressionRightWithOp*;
+
+ternaryExpressionBody: '?' expression ':' expression;
 
+// expression alternatives are factored so that they are predicted by the next token
 expression:
-	identifier
-	| prefixExpression
-	| parenthesesExpression
-	| binaryExpression
-	| ternaryExpression
-	| callExpression
-	| memberExpression;
+	prefixExpression
+	| binaryExpression ternaryExpressionBody?;
 
 // Keyword
 
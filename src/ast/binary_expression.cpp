@@ -7,35 +7,25 @@ namespace walang::ast {
 BinaryExpression::BinaryExpression() noexcept
     : Expression(ExpressionType::TypeBinaryExpression), op_(static_cast<BinaryOp>(0)), leftExpr_(nullptr),
       rightExpr_(nullptr) {}
-BinaryExpression::BinaryExpression(walangParser::BinaryExpressionContext *ctx,
-                                   std::unordered_map<antlr4::ParserRuleContext *, std::shared_ptr<Node>> const &map)
-    : Expression(ExpressionType::TypeBinaryExpression) {
-
-  auto leftChild = dynamic_cast<antlr4::ParserRuleContext *>(ctx->binaryExpressionLeft()->children.at(0));
-  assert(map.count(leftChild) == 1);
-  leftExpr_ = std::dynamic_pointer_cast<Expression>(map.find(leftChild)->second);
-
-  auto binaryRightWithOps = ctx->binaryExpressionRightWithOp();
+BinaryExpression::BinaryExpression(Expression *leftExpr,
+                                   std::vector<std::pair<BinaryOp, Expression *>> const &rightExprs, Arena &arena)
+    : Expression(ExpressionType::TypeBinaryExpression), leftExpr_(leftExpr) {
+  assert(!rightExprs.empty());
   bool firstRight = true;
-  for (auto binaryRightWithOp : binaryRightWithOps) {
-    BinaryOp op = Operator::getOp(binaryRightWithOp->binaryOperator());
-    auto rightCtx =
-        dynamic_cast<antlr4::ParserRuleContext *>(binaryRightWithOp->binaryExpressionRight()->children.at(0));
-    assert(map.count(rightCtx) == 1);
-    auto rightExpr = std::dynamic_pointer_cast<Expression>(map.find(rightCtx)->second);
+  for (auto const &[op, rightExpr] : rightExprs) {
     if (firstRight) {
       firstRight = false;
       op_ = op;
       rightExpr_ = rightExpr;
     } else {
-      appendExpr(op, rightExpr);
+      appendExpr(op, rightExpr, arena);
     }
   }
 }
-void BinaryExpression::appendExpr(BinaryOp op, const std::shared_ptr<Expression> &rightExpr) {
+void BinaryExpression::appendExpr(BinaryOp op, Expression *rightExpr, Arena &arena) {
   if (Operator::getOpPriority(op_) <= Operator::getOpPriority(op)) {
     // self as new operator's left
-    auto newLeft = std::make_shared<BinaryExpression>();
+    auto *newLeft = arena.make<BinaryExpression>();
     newLeft->op_ = this->op_;
     newLeft->leftExpr_ = this->leftExpr_;
     newLeft->rightExpr_ = this->rightExpr_;
@@ -44,10 +34,10 @@ void BinaryExpression::appendExpr(BinaryOp op, const std::shared_ptr<Expression>
     this->rightExpr_ = rightExpr;
   } else {
     // combine new operator with right as new right
-    if (std::dynamic_pointer_cast<BinaryExpression>(this->rightExpr_) != nullptr) {
-      std::dynamic_pointer_cast<BinaryExpression>(this->rightExpr_)->appendExpr(op, rightExpr);
+    if (this->rightExpr_->type() == ExpressionType::TypeBinaryExpression) {
+      static_cast<BinaryExpression *>(this->rightExpr_)->appendExpr(op, rightExpr, arena);
     } else {
-      auto newRight = std::make_shared<BinaryExpression>();
+      auto *newRight = arena.make<BinaryExpression>();
       newRight->op_ = op;
       newRight->leftExpr_ = this->rightExpr_;
       newRight->rightExpr_ = rightExpr;
@@ -1,4 +1,3 @@
-#include "generated/walangParser.h"
 #include "statement.hpp"
 #include <cassert>
 #include <fmt/core.h>
@@ -9,19 +8,6 @@
 
 namespace walang::ast {
 
-ClassStatement::ClassStatement(walangParser::ClassStatementContext *ctx,
-                               std::unordered_map<antlr4::ParserRuleContext *, std::shared_ptr<Node>> const &map)
-    : Statement(StatementType::TypeClassStatement) {
-  name_ = ctx->Identifier()->getText();
-
-  for (walangParser::MemberContext *memberCtx : ctx->member()) {
-    members_.push_back(Member{memberCtx->Identifier()->getText(), memberCtx->type()->getText()});
-  }
-  for (walangParser::FunctionStatementContext *functionCtx : ctx->functionStatement()) {
-    assert(map.count(functionCtx) == 1);
-    methods_.push_back(std::dynamic_pointer_cast<FunctionStatement>(map.find(functionCtx)->second));
-  }
-}
 std::string ClassStatement::to_string() const {
   std::vector<std::string> memberStrings{};
   memberStrings.reserve(members_.size());
@@ -30,7 +16,7 @@ std::string ClassStatement::to_string() const {
   }
   std::vector<std::string> functionStrings{};
   functionStrings.reserve(methods_.size());
-  for (std::shared_ptr<FunctionStatement> const &func : methods_) {
+  for (FunctionStatement const *func : methods_) {
     functionStrings.push_back(func->to_string());
   }
 
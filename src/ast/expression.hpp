@@ -1,6 +1,6 @@
 #pragma once
 
-#include "generated/walangParser.h"
+#include "helper/arena.hpp"
 #include "node.hpp"
 #include "op.hpp"
 #include <cassert>
@@ -8,6 +8,7 @@
 #include <memory>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -35,8 +36,8 @@ private:
 
 class Identifier final : public Expression {
 public:
-  Identifier(walangParser::IdentifierContext *ctx,
-             std::unordered_map<antlr4::ParserRuleContext *, std::shared_ptr<ast::Node>> const &);
+  explicit Identifier(std::variant<uint64_t, double, std::string> identifier)
+      : Expression(ExpressionType::TypeIdentifier), identifier_(std::move(identifier)) {}
   ~Identifier() override = default;
   [[nodiscard]] std::string to_string() const override;
 
@@ -48,87 +49,85 @@ private:
 
 class PrefixExpression : public Expression {
 public:
-  PrefixExpression(walangParser::PrefixExpressionContext *ctx,
-                   std::unordered_map<antlr4::ParserRuleContext *, std::shared_ptr<Node>> const &map);
+  PrefixExpression(PrefixOp op, Expression *expr) noexcept
+      : Expression(ExpressionType::TypePrefixExpression), op_(op), expr_(expr) {}
   ~PrefixExpression() override = default;
   [[nodiscard]] std::string to_string() const override;
   [[nodiscard]] PrefixOp op() const noexcept { return op_; }
-  [[nodiscard]] std::shared_ptr<Expression> const &expr() const noexcept { return expr_; }
+  [[nodiscard]] Expression *expr() const noexcept { return expr_; }
 
 private:
   PrefixOp op_;
-  std::shared_ptr<Expression> expr_;
+  Expression *expr_{};
 };
 
 class BinaryExpression final : public Expression {
 public:
   BinaryExpression() noexcept;
-  BinaryExpression(walangParser::BinaryExpressionContext *ctx,
-                   std::unordered_map<antlr4::ParserRuleContext *, std::shared_ptr<Node>> const &map);
+  /// @brief fold `left op1 right1 op2 right2 ...` by operator priority, intermediate nodes are allocated in arena
+  BinaryExpression(Expression *leftExpr, std::vector<std::pair<BinaryOp, Expression *>> const &rightExprs,
+                   Arena &arena);
   ~BinaryExpression() override = default;
   [[nodiscard]] std::string to_string() const override;
   [[nodiscard]] BinaryOp op() const noexcept { return op_; }
-  [[nodiscard]] std::shared_ptr<Expression> const &leftExpr() const noexcept { return leftExpr_; }
-  [[nodiscard]] std::shared_ptr<Expression> const &rightExpr() const noexcept { return rightExpr_; }
+  [[nodiscard]] Expression *leftExpr() const noexcept { return leftExpr_; }
+  [[nodiscard]] Expression *rightExpr() const noexcept { return rightExpr_; }
 
 private:
   BinaryOp op_;
-  std::shared_ptr<Expression> leftExpr_;
-  std::shared_ptr<Expression> rightExpr_;
+  Expression *leftExpr_{};
+  Expression *rightExpr_{};
 
-  void appendExpr(BinaryOp op, const std::shared_ptr<Expression> &rightExpr);
+  void appendExpr(BinaryOp op, Expression *rightExpr, Arena &arena);
 };
 
 class TernaryExpression : public Expression {
 public:
-  TernaryExpression() noexcept;
-  TernaryExpression(walangParser::TernaryExpressionContext *ctx,
-                    std::unordered_map<antlr4::ParserRuleContext *, std::shared_ptr<Node>> const &map);
+  TernaryExpression(Expression *conditionExpr, Expression *leftExpr, Expression *rightExpr) noexcept
+      : Expression(ExpressionType::TypeTernaryExpression), conditionExpr_(conditionExpr), leftExpr_(leftExpr),
+        rightExpr_(rightExpr) {}
   ~TernaryExpression() override = default;
   [[nodiscard]] std::string to_string() const override;
 
-  std::shared_ptr<Expression> const &conditionExpr() { return conditionExpr_; }
-  std::shared_ptr<Expression> const &leftExpr() { return leftExpr_; }
-  std::shared_ptr<Expression> const &rightExpr() { return rightExpr_; }
+  [[nodiscard]] Expression *conditionExpr() const noexcept { return conditionExpr_; }
+  [[nodiscard]] Expression *leftExpr() const noexcept { return leftExpr_; }
+  [[nodiscard]] Expression *rightExpr() const noexcept { return rightExpr_; }
 
 private:
-  std::shared_ptr<Expression> conditionExpr_;
-  std::shared_ptr<Expression> leftExpr_;
-  std::shared_ptr<Expression> rightExpr_;
+  Expression *conditionExpr_{};
+  Expression *leftExpr_{};
+  Expression *rightExpr_{};
 };
 
 class CallExpression : public Expression {
 public:
   CallExpression() noexcept;
-  CallExpression(std::shared_ptr<Expression> caller, walangParser::CallExpressionRightContext *ctx,
-                 std::unordered_map<antlr4::ParserRuleContext *, std::shared_ptr<Node>> const &map);
-  CallExpression(walangParser::CallExpressionContext *ctx,
-                 std::unordered_map<antlr4::ParserRuleContext *, std::shared_ptr<Node>> const &map);
+  CallExpression(Expression *caller, std::vector<Expression *> arguments)
+      : Expression(ExpressionType::TypeCallExpression), caller_(caller), arguments_(std::move(arguments)) {}
   ~CallExpression() override = default;
   [[nodiscard]] std::string to_string() const override;
 
-  [[nodiscard]] std::shared_ptr<Expression> const &caller() const noexcept { return caller_; }
-  [[nodiscard]] std::vector<std::shared_ptr<Expression>> const &arguments() const noexcept { return arguments_; }
+  [[nodiscard]] Expression *caller() const noexcept { return caller_; }
+  [[nodiscard]] std::vector<Expression *> const &arguments() const noexcept { return arguments_; }
 
 private:
-  std::shared_ptr<Expression> caller_;
-  std::vector<std::shared_ptr<Expression>> arguments_;
+  Expression *caller_{};
+  std::vector<Expression *> arguments_;
 };
 
 class MemberExpression : public Expression {
 public:
   MemberExpression() noexcept;
-  MemberExpression(std::shared_ptr<Expression> expr, walangParser::MemberExpressionRightContext *ctx);
-  MemberExpression(walangParser::MemberExpressionContext *ctx,
-                   std::unordered_map<antlr4::ParserRuleContext *, std::shared_ptr<Node>> const &map);
+  MemberExpression(Expression *expr, std::string member)
+      : Expression(ExpressionType::TypeMemberExpression), expr_(expr), member_(std::move(member)) {}
   ~MemberExpression() override = default;
   [[nodiscard]] std::string to_string() const override;
 
-  [[nodiscard]] std::shared_ptr<Expression> const &expr() const noexcept { return expr_; }
+  [[nodiscard]] Expression *expr() const noexcept { return expr_; }
   [[nodiscard]] std::string const &member() const noexcept { return member_; }
 
 private:
-  std::shared_ptr<Expression> expr_;
+  Expression *expr_{};
   std::string member_;
 };
 
@@ -1,25 +1,29 @@
 #pragma once
 
+#include "helper/arena.hpp"
 #include "node.hpp"
 #include "statement.hpp"
-#include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
 namespace walang::ast {
 
+/// @brief root of the AST, owns every node of the file through its arena
 class File : public Node {
 public:
   explicit File(std::string filename) : filename_(std::move(filename)) {}
-  void update(walangParser::WalangContext *ctx,
-              std::unordered_map<antlr4::ParserRuleContext *, std::shared_ptr<Node>> const &map);
+  void setStatements(std::vector<Statement *> statements) { statements_ = std::move(statements); }
   [[nodiscard]] std::string to_string() const override;
-  [[nodiscard]] std::vector<std::shared_ptr<Statement>> const &statement() const noexcept { return statements_; }
+  [[nodiscard]] std::vector<Statement *> const &statement() const noexcept { return statements_; }
   [[nodiscard]] std::string const &filename() const noexcept { return filename_; }
+  [[nodiscard]] Arena &arena() noexcept { return arena_; }
+  [[nodiscard]] Arena const &arena() const noexcept { return arena_; }
 
 private:
   std::string filename_;
-  std::vector<std::shared_ptr<Statement>> statements_;
+  Arena arena_{};
+  std::vector<Statement *> statements_;
 };
 
 } // namespace walang::ast
@@ -1,4 +1,3 @@
-#include "generated/walangParser.h"
 #include "statement.hpp"
 #include <algorithm>
 #include <cassert>
@@ -10,26 +9,6 @@
 
 namespace walang::ast {
 
-FunctionStatement::FunctionStatement(walangParser::FunctionStatementContext *ctx,
-                                     std::unordered_map<antlr4::ParserRuleContext *, std::shared_ptr<Node>> const &map)
-    : Statement(StatementType::TypeFunctionStatement) {
-  name_ = ctx->Identifier()->getText();
-
-  for (auto decorator : ctx->decorator()) {
-    decorators_.push_back(decorator->Identifier()->getText());
-  }
-  auto parameterContexts = ctx->parameterList()->parameter();
-  std::transform(parameterContexts.cbegin(), parameterContexts.cend(), std::back_inserter(arguments_),
-                 [](walangParser::ParameterContext *parameterCtx) {
-                   return Argument{parameterCtx->Identifier()->getText(), parameterCtx->type()->getText()};
-                 });
-
-  returnType_ = ctx->type() == nullptr ? std::nullopt : std::optional<std::string>{ctx->type()->getText()};
-
-  assert(map.count(ctx->blockStatement()) == 1);
-  body_ = std::dynamic_pointer_cast<BlockStatement>(map.find(ctx->blockStatement())->second);
-}
-
 std::string FunctionStatement::to_string() const {
   std::vector<std::string> argumentStrings{};
   std::transform(arguments_.cbegin(), arguments_.cend(), std::back_inserter(argumentStrings),
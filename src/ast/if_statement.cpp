@@ -1,4 +1,3 @@
-#include "generated/walangParser.h"
 #include "statement.hpp"
 #include <cassert>
 #include <fmt/core.h>
@@ -7,26 +6,6 @@
 
 namespace walang::ast {
 
-IfStatement::IfStatement(walangParser::IfStatementContext *ctx,
-                         std::unordered_map<antlr4::ParserRuleContext *, std::shared_ptr<Node>> const &map)
-    : Statement(StatementType::TypeIfStatement) {
-  assert(map.count(ctx->expression()) == 1);
-  condition_ = std::dynamic_pointer_cast<Expression>(map.find(ctx->expression())->second);
-  auto blockStatements = ctx->blockStatement();
-  assert(!blockStatements.empty());
-  assert(map.count(blockStatements.at(0)) == 1);
-  thenBlock_ = std::dynamic_pointer_cast<BlockStatement>(map.find(blockStatements.at(0))->second);
-  if (blockStatements.size() == 2U) {
-    // if - then - else
-    elseBlock_ = std::dynamic_pointer_cast<BlockStatement>(map.find(blockStatements.at(0))->second);
-  } else if (ctx->ifStatement() != nullptr) {
-    // if - then - else if ...
-    elseBlock_ = std::dynamic_pointer_cast<IfStatement>(map.find(ctx->ifStatement())->second);
-  } else {
-    elseBlock_ = nullptr;
-  }
-}
-
 std::string IfStatement::to_string() const {
   std::string elseStr;
   if (elseBlock_ != nullptr) {
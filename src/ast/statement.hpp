@@ -1,7 +1,6 @@
 #pragma once
 
 #include "expression.hpp"
-#include "generated/walangParser.h"
 #include "node.hpp"
 #include <cassert>
 #include <cstdint>
@@ -40,86 +39,88 @@ private:
 
 class DeclareStatement final : public Statement {
 public:
-  DeclareStatement(walangParser::DeclareStatementContext *ctx,
-                   std::unordered_map<antlr4::ParserRuleContext *, std::shared_ptr<Node>> const &map);
+  DeclareStatement(std::string variantName, std::string variantType, Expression *initExpr)
+      : Statement(StatementType::TypeDeclareStatement), variantName_(std::move(variantName)),
+        variantType_(std::move(variantType)), initExpr_(initExpr) {}
   ~DeclareStatement() override = default;
   [[nodiscard]] std::string to_string() const override;
   [[nodiscard]] std::string variantName() const noexcept { return variantName_; }
   [[nodiscard]] std::string variantType() const noexcept { return variantType_; }
-  [[nodiscard]] std::shared_ptr<Expression> init() const noexcept { return initExpr_; }
+  [[nodiscard]] Expression *init() const noexcept { return initExpr_; }
 
 private:
   std::string variantName_;
   std::string variantType_;
-  std::shared_ptr<Expression> initExpr_;
+  Expression *initExpr_{};
 };
 
 class AssignStatement final : public Statement {
 public:
-  AssignStatement(walangParser::AssignStatementContext *ctx,
-                  std::unordered_map<antlr4::ParserRuleContext *, std::shared_ptr<Node>> const &map);
+  AssignStatement(Expression *varExpr, Expression *valueExpr) noexcept
+      : Statement(StatementType::TypeAssignStatement), varExpr_(varExpr), valueExpr_(valueExpr) {}
   ~AssignStatement() override = default;
   [[nodiscard]] std::string to_string() const override;
-  [[nodiscard]] std::shared_ptr<Expression> variant() const noexcept { return varExpr_; }
-  [[nodiscard]] std::shared_ptr<Expression> value() const noexcept { return valueExpr_; }
+  [[nodiscard]] Expression *variant() const noexcept { return varExpr_; }
+  [[nodiscard]] Expression *value() const noexcept { return valueExpr_; }
 
 private:
-  std::shared_ptr<Expression> varExpr_;
-  std::shared_ptr<Expression> valueExpr_;
+  Expression *varExpr_{};
+  Expression *valueExpr_{};
 };
 
 class ExpressionStatement : public Statement {
 public:
-  ExpressionStatement(walangParser::ExpressionStatementContext *ctx,
-                      std::unordered_map<antlr4::ParserRuleContext *, std::shared_ptr<Node>> const &map);
+  explicit ExpressionStatement(Expression *expr) noexcept
+      : Statement(StatementType::TypeExpressionStatement), expr_(expr) {}
   ~ExpressionStatement() override = default;
   [[nodiscard]] std::string to_string() const override;
-  [[nodiscard]] std::shared_ptr<Expression> expr() const noexcept { return expr_; }
+  [[nodiscard]] Expression *expr() const noexcept { return expr_; }
 
 private:
-  std::shared_ptr<Expression> expr_;
+  Expression *expr_{};
 };
 
 class BlockStatement : public Statement {
 public:
-  BlockStatement(walangParser::BlockStatementContext *ctx,
-                 std::unordered_map<antlr4::ParserRuleContext *, std::shared_ptr<Node>> const &map);
+  explicit BlockStatement(std::vector<Statement *> statements)
+      : Statement(StatementType::TypeBlockStatement), statements_(std::move(statements)) {}
   ~BlockStatement() override = default;
   [[nodiscard]] std::string to_string() const override;
-  [[nodiscard]] std::vector<std::shared_ptr<Statement>> const &statements() const noexcept { return statements_; }
+  [[nodiscard]] std::vector<Statement *> const &statements() const noexcept { return statements_; }
 
 private:
-  std::vector<std::shared_ptr<Statement>> statements_;
+  std::vector<Statement *> statements_;
 };
 
 class IfStatement : public Statement {
 public:
-  IfStatement(walangParser::IfStatementContext *ctx,
-              std::unordered_map<antlr4::ParserRuleContext *, std::shared_ptr<Node>> const &map);
+  IfStatement(Expression *condition, BlockStatement *thenBlock, Statement *elseBlock) noexcept
+      : Statement(StatementType::TypeIfStatement), condition_(condition), thenBlock_(thenBlock),
+        elseBlock_(elseBlock) {}
   ~IfStatement() override = default;
   [[nodiscard]] std::string to_string() const override;
-  [[nodiscard]] std::shared_ptr<Expression> const &condition() const noexcept { return condition_; }
-  [[nodiscard]] std::shared_ptr<BlockStatement> const &thenBlock() const noexcept { return thenBlock_; }
-  [[nodiscard]] std::shared_ptr<Statement> const &elseBlock() const noexcept { return elseBlock_; }
+  [[nodiscard]] Expression *condition() const noexcept { return condition_; }
+  [[nodiscard]] BlockStatement *thenBlock() const noexcept { return thenBlock_; }
+  [[nodiscard]] Statement *elseBlock() const noexcept { return elseBlock_; }
 
 private:
-  std::shared_ptr<Expression> condition_;
-  std::shared_ptr<BlockStatement> thenBlock_;
-  std::shared_ptr<Statement> elseBlock_;
+  Expression *condition_{};
+  BlockStatement *thenBlock_{};
+  Statement *elseBlock_{};
 };
 
 class WhileStatement : public Statement {
 public:
-  WhileStatement(walangParser::WhileStatementContext *ctx,
-                 std::unordered_map<antlr4::ParserRuleContext *, std::shared_ptr<Node>> const &map);
+  WhileStatement(Expression *condition, BlockStatement *block) noexcept
+      : Statement(StatementType::TypeWhileStatement), condition_(condition), block_(block) {}
   ~WhileStatement() override = default;
   [[nodiscard]] std::string to_string() const override;
-  [[nodiscard]] std::shared_ptr<Expression> const &condition() const noexcept { return condition_; }
-  [[nodiscard]] std::shared_ptr<BlockStatement> const &block() const noexcept { return block_; }
+  [[nodiscard]] Expression *condition() const noexcept { return condition_; }
+  [[nodiscard]] BlockStatement *block() const noexcept { return block_; }
 
 private:
-  std::shared_ptr<Expression> condition_;
-  std::shared_ptr<BlockStatement> block_;
+  Expression *condition_{};
+  BlockStatement *block_{};
 };
 
 class BreakStatement : public Statement {
@@ -138,14 +139,13 @@ public:
 
 class ReturnStatement : public Statement {
 public:
-  ReturnStatement(walangParser::ReturnStatementContext *ctx,
-                  std::unordered_map<antlr4::ParserRuleContext *, std::shared_ptr<Node>> const &map);
+  explicit ReturnStatement(Expression *expr) noexcept : Statement(StatementType::TypeReturnStatement), expr_(expr) {}
   ~ReturnStatement() override = default;
   [[nodiscard]] std::string to_string() const override;
-  [[nodiscard]] std::shared_ptr<Expression> const &expr() { return expr_; }
+  [[nodiscard]] Expression *expr() const noexcept { return expr_; }
 
 private:
-  std::shared_ptr<Expression> expr_;
+  Expression *expr_{};
 };
 
 class FunctionStatement : public Statement {
@@ -155,15 +155,17 @@ public:
     std::string type_;
   };
 
-  FunctionStatement(walangParser::FunctionStatementContext *ctx,
-                    std::unordered_map<antlr4::ParserRuleContext *, std::shared_ptr<Node>> const &map);
+  FunctionStatement(std::string name, std::vector<Argument> arguments, std::vector<std::string> decorators,
+                    std::optional<std::string> returnType, BlockStatement *body)
+      : Statement(StatementType::TypeFunctionStatement), name_(std::move(name)), arguments_(std::move(arguments)),
+        decorators_(std::move(decorators)), returnType_(std::move(returnType)), body_(body) {}
   ~FunctionStatement() override = default;
   [[nodiscard]] std::string to_string() const override;
 
   [[nodiscard]] std::string const &name() const noexcept { return name_; }
   [[nodiscard]] std::vector<Argument> const &arguments() const noexcept { return arguments_; }
   [[nodiscard]] std::optional<std::string> const &returnType() const noexcept { return returnType_; }
-  [[nodiscard]] std::shared_ptr<BlockStatement> const &body() const noexcept { return body_; };
+  [[nodiscard]] BlockStatement *body() const noexcept { return body_; };
   [[nodiscard]] std::vector<std::string> const &decorators() const noexcept { return decorators_; };
 
 private:
@@ -171,7 +173,7 @@ private:
   std::vector<Argument> arguments_;
   std::vector<std::string> decorators_;
   std::optional<std::string> returnType_;
-  std::shared_ptr<BlockStatement> body_;
+  BlockStatement *body_{};
 };
 
 class ClassStatement : public Statement {
@@ -181,18 +183,19 @@ public:
     std::string type_;
   };
 
-  ClassStatement(walangParser::ClassStatementContext *ctx,
-                 std::unordered_map<antlr4::ParserRuleContext *, std::shared_ptr<Node>> const &map);
+  ClassStatement(std::string name, std::vector<Member> members, std::vector<FunctionStatement *> methods)
+      : Statement(StatementType::TypeClassStatement), name_(std::move(name)), members_(std::move(members)),
+        methods_(std::move(methods)) {}
   ~ClassStatement() override = default;
   [[nodiscard]] std::string to_string() const override;
   [[nodiscard]] std::string const &name() const { return name_; }
   [[nodiscard]] std::vector<Member> const &members() const { return members_; }
-  [[nodiscard]] std::vector<std::shared_ptr<FunctionStatement>> const &methods() const { return methods_; }
+  [[nodiscard]] std::vector<FunctionStatement *> const &methods() const { return methods_; }
 
 private:
   std::string name_;
   std::vector<Member> members_;
-  std::vector<std::shared_ptr<FunctionStatement>> methods_;
+  std::vector<FunctionStatement *> methods_;
 };
 
 } // namespace walang::ast
\ No newline at end of file
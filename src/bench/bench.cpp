@@ -0,0 +1,141 @@
+#include "binaryen/optimize_options.hpp"
+#include "compiler.hpp"
+#include "fmt/core.h"
+#include "parser.hpp"
+#include "synthetic_program.hpp"
+#include <algorithm>
+#include <binaryen-c.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <sys/resource.h>
+#include <type_traits>
+
+namespace {
+
+[[noreturn]] void printHelpAndExit() {
+  std::cerr << "walang-bench [-f functions] [-c classes] [-d depth] [-e expression length] [-l locals] [-r repeat] "
+               "[-j jobs] [-O0|-O1|-O2|-O3|-O4|-Os|-Oz] [--dump file]"
+            << std::endl;
+  std::exit(-1);
+}
+
+/// @brief peak resident set size of the process in KiB, it is a high-water mark and never decreases
+uint64_t peakRss() {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return static_cast<uint64_t>(usage.ru_maxrss) / 1024U;
+#else
+  return static_cast<uint64_t>(usage.ru_maxrss);
+#endif
+}
+
+struct Phase {
+  char const *name_;
+  double bestSeconds_{std::numeric_limits<double>::max()};
+  /// @brief largest growth of the process peak RSS while this phase ran
+  /// memory that reuses pages freed by an earlier phase is not visible, so it is a lower bound of the phase peak
+  uint64_t peakRssGrowth_{0U};
+
+  template <class F> auto measure(F &&f) {
+    uint64_t const rssBefore = peakRss();
+    auto start = std::chrono::steady_clock::now();
+    auto finish = [this, start, rssBefore] {
+      double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      bestSeconds_ = std::min(bestSeconds_, seconds);
+      peakRssGrowth_ = std::max(peakRssGrowth_, peakRss() - rssBefore);
+    };
+    if constexpr (std::is_void_v<decltype(f())>) {
+      f();
+      finish();
+    } else {
+      auto result = f();
+      finish();
+      return result;
+    }
+  }
+};
+
+} // namespace
+
+int main(int argc, const char *argv[]) {
+  walang::bench::SyntheticProgramOptions programOptions{};
+  walang::binaryen::OptimizeOptions optimizeOptions = walang::binaryen::OptimizeOptions::fromLevel("-O2").value();
+  uint32_t repeat = 3U;
+  uint32_t jobs = 1U;
+  std::string dumpPath{};
+  for (int i = 1; i < argc; i++) {
+    std::string argument{argv[i]};
+    auto optimizeLevel = walang::binaryen::OptimizeOptions::fromLevel(argument);
+    if (optimizeLevel.has_value()) {
+      optimizeOptions = optimizeLevel.value();
+      continue;
+    }
+    if (i + 1 >= argc) {
+      printHelpAndExit();
+    }
+    if (argument == "--dump") {
+      dumpPath = argv[++i];
+      continue;
+    }
+    int value = std::atoi(argv[++i]);
+    if (value < 0) {
+      printHelpAndExit();
+    }
+    auto unsignedValue = static_cast<uint32_t>(value);
+    if (argument == "-f") {
+      programOptions.functions_ = unsignedValue;
+    } else if (argument == "-c") {
+      programOptions.classes_ = unsignedValue;
+    } else if (argument == "-d") {
+      programOptions.depth_ = unsignedValue;
+    } else if (argument == "-e") {
+      programOptions.expressionLength_ = unsignedValue;
+    } else if (argument == "-l") {
+      programOptions.locals_ = unsignedValue;
+    } else if (argument == "-r" && unsignedValue > 0U) {
+      repeat = unsignedValue;
+    } else if (argument == "-j" && unsignedValue > 0U) {
+      jobs = unsignedValue;
+    } else {
+      printHelpAndExit();
+    }
+  }
+
+  std::string source = walang::bench::generateSyntheticProgram(programOptions);
+  if (!dumpPath.empty()) {
+    std::ofstream{dumpPath} << source;
+  }
+  auto lines = static_cast<uint64_t>(std::count(source.begin(), source.end(), '\n'));
+  fmt::print("{} lines, {} bytes\n", lines, source.size());
+
+  optimizeOptions.apply();
+  Phase parse{"parse"};
+  Phase compile{"compile"};
+  Phase optimize{"optimize"};
+  Phase emit{"emit"};
+  for (uint32_t i = 0; i < repeat; i++) {
+    auto file = parse.measure([&source] { return walang::FileParser("bench.wa", source).parse(); });
+    walang::Compiler compiler{{file}};
+    compiler.setThreads(jobs);
+    compile.measure([&compiler] { compiler.compile(); });
+    optimize.measure([&compiler, &optimizeOptions] { optimizeOptions.run(compiler.module()); });
+    emit.measure([&compiler] {
+      std::ostringstream binary{};
+      compiler.writeWasm(binary);
+    });
+  }
+  fmt::print("{:<10} {:>12} {:>14} {:>18}\n", "phase", "seconds", "lines/s", "peak RSS +KiB");
+  for (Phase const *phase : {&parse, &compile, &optimize, &emit}) {
+    fmt::print("{:<10} {:>12.4f} {:>14.0f} {:>18}\n", phase->name_, phase->bestSeconds_,
+               static_cast<double>(lines) / phase->bestSeconds_, phase->peakRssGrowth_);
+  }
+  fmt::print("process peak RSS {} KiB\n", peakRss());
+  return 0;
+}
@@ -0,0 +1,106 @@
+#include "fmt/core.h"
+#include "generated/walangLexer.h"
+#include "parser.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+[[noreturn]] void printHelpAndExit() {
+  std::cerr << "walang-parse-bench [-n functions] [-r repeat] [source...]" << std::endl;
+  std::exit(-1);
+}
+
+std::string readFile(std::string const &path) {
+  std::ifstream file{path, std::ios::binary};
+  if (!file.is_open()) {
+    printHelpAndExit();
+  }
+  std::ostringstream tmp;
+  tmp << file.rdbuf();
+  return tmp.str();
+}
+
+/// @brief expression heavy program, nested parentheses, calls and member accesses stress the prediction
+std::string generateSource(uint32_t functionCount) {
+  std::string source = "class Vec {\n  x: i32;\n  y: i32;\n  function dot(v: Vec): i32 {\n"
+                       "    return this.x * v.x + this.y * v.y;\n  }\n}\n";
+  for (uint32_t i = 0; i < functionCount; i++) {
+    source += fmt::format("function f{0}(a: i32, b: i32, v: Vec): i32 {{\n"
+                          "  let c: i32 = (a + b) * (a - (b * 3 + {0})) / ((a % 7) + 1);\n"
+                          "  let d = a > b ? (a == {0} ? c : -c) : b << 2;\n"
+                          "  while (c < 100 && not (d == 0)) {{\n"
+                          "    c = c + v.dot(v) * ((d ^ a) | (b & {0}));\n"
+                          "    if (c > {0}) {{ break; }} else if (c == 0) {{ continue; }}\n"
+                          "  }}\n"
+                          "  return c + d;\n"
+                          "}}\n",
+                          i);
+  }
+  return source;
+}
+
+size_t countTokens(std::string const &source) {
+  antlr4::ANTLRInputStream inputStream(source);
+  walangLexer lexer(&inputStream);
+  antlr4::CommonTokenStream tokens(&lexer);
+  tokens.fill();
+  return tokens.size();
+}
+
+double measure(std::vector<std::string> const &sources, uint32_t repeat, bool sllFirst) {
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < repeat; i++) {
+    for (std::string const &source : sources) {
+      walang::FileParser parser("bench.wa", source);
+      parser.setSllFirst(sllFirst);
+      parser.parse();
+    }
+  }
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, const char *argv[]) {
+  uint32_t functionCount = 1000U;
+  uint32_t repeat = 5U;
+  std::vector<std::string> sources{};
+  for (int i = 1; i < argc; i++) {
+    std::string argument{argv[i]};
+    if ((argument == "-n" || argument == "-r") && i + 1 < argc) {
+      int value = std::atoi(argv[++i]);
+      if (value <= 0) {
+        printHelpAndExit();
+      }
+      (argument == "-n" ? functionCount : repeat) = static_cast<uint32_t>(value);
+    } else if (argument.rfind('-', 0) == 0) {
+      printHelpAndExit();
+    } else {
+      sources.push_back(readFile(argument));
+    }
+  }
+  if (sources.empty()) {
+    sources.push_back(generateSource(functionCount));
+  }
+
+  size_t tokenCount = 0;
+  for (std::string const &source : sources) {
+    tokenCount += countTokens(source);
+  }
+  tokenCount *= repeat;
+  fmt::print("{} tokens\n", tokenCount);
+  // the DFA cache is shared by all parsers, fill it before measuring
+  measure(sources, 1U, true);
+  for (bool sllFirst : {false, true}) {
+    double seconds = measure(sources, repeat, sllFirst);
+    fmt::print("{:<8} {:>12.0f} tokens/s {:>10.3f} s\n", sllFirst ? "SLL->LL" : "LL", tokenCount / seconds, seconds);
+  }
+  return 0;
+}
@@ -0,0 +1,269 @@
+#include "binaryen/instruction_counter.hpp"
+#include "binaryen/optimize_options.hpp"
+#include "binaryen/runner.hpp"
+#include "compiler.hpp"
+#include "fmt/core.h"
+#include "helper/json.hpp"
+#include "parser.hpp"
+#include <algorithm>
+#include <binaryen-c.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+[[noreturn]] void printHelpAndExit() {
+  std::cerr << "walang-runtime-bench kernel.wa... [-r repeat] [-o results.json] [-b baseline.json [-t percent]]\n"
+               "  every kernel is compiled at each optimization level and `main` is executed in the interpreter\n"
+               "  -b fails when a result differs from the baseline or the instruction count grows by more than "
+               "-t percent (default 2)"
+            << std::endl;
+  std::exit(-1);
+}
+
+constexpr char const *levels[] = {"-O0", "-O1", "-O2", "-O3", "-O4", "-Os", "-Oz"};
+
+struct Measurement {
+  std::string kernel_;
+  std::string level_;
+  std::string result_;
+  uint64_t instructions_;
+  double bestSeconds_;
+};
+
+std::string readFile(std::string const &path) {
+  std::ifstream file{path, std::ios::binary};
+  if (!file.is_open()) {
+    throw std::runtime_error("invalid path " + path);
+  }
+  std::ostringstream tmp;
+  tmp << file.rdbuf();
+  return tmp.str();
+}
+
+/// @brief compile and optimize `source`, `main` is exported so that the optimizer keeps it
+std::unique_ptr<walang::Compiler> compileKernel(std::string const &path, std::string const &source,
+                                                walang::binaryen::OptimizeOptions const &optimizeOptions) {
+  auto compiler = std::make_unique<walang::Compiler>(
+      std::vector<std::shared_ptr<walang::ast::File>>{walang::FileParser(path, source).parse()});
+  compiler->compile();
+  BinaryenAddFunctionExport(compiler->module(), "main", "main");
+  optimizeOptions.apply();
+  optimizeOptions.run(compiler->module());
+  if (!BinaryenModuleValidate(compiler->module())) {
+    throw std::runtime_error("invalid module");
+  }
+  return compiler;
+}
+
+Measurement measure(std::string const &path, std::string const &source, char const *level, uint32_t repeat) {
+  auto optimizeOptions = walang::binaryen::OptimizeOptions::fromLevel(level).value();
+  Measurement measurement{std::filesystem::path{path}.stem().string(), level, "", 0U,
+                          std::numeric_limits<double>::max()};
+  auto compiler = compileKernel(path, source, optimizeOptions);
+  for (uint32_t i = 0; i < repeat; i++) {
+    // every run starts from a fresh instance, instantiation and `_start` are not measured
+    std::ostringstream hostOutput{};
+    walang::binaryen::Runner runner{compiler->module(), hostOutput};
+    auto start = std::chrono::steady_clock::now();
+    auto results = runner.invoke("main", {});
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    measurement.bestSeconds_ = std::min(measurement.bestSeconds_, seconds);
+    measurement.result_ = results.empty() ? std::string{} : results.front();
+  }
+  // counting slows down execution, so it runs on a separate instrumented module
+  auto instrumented = compileKernel(path, source, optimizeOptions);
+  walang::binaryen::InstructionCounter::instrument(instrumented->module());
+  std::ostringstream hostOutput{};
+  walang::binaryen::Runner runner{instrumented->module(), hostOutput};
+  runner.invoke("main", {});
+  auto instructions = runner.invoke(walang::binaryen::InstructionCounter::counterFunction, {});
+  measurement.instructions_ = std::stoull(instructions.front());
+  return measurement;
+}
+
+void writeBaseline(std::ostream &os, std::vector<Measurement> const &measurements) {
+  os << "[";
+  char const *separator = "";
+  for (Measurement const &measurement : measurements) {
+    os << fmt::format("{}\n  {{\"kernel\": \"{}\", \"level\": \"{}\", \"result\": \"{}\", \"instructions\": {}, "
+                      "\"seconds\": {:.6f}}}",
+                      separator, walang::escapeJson(measurement.kernel_), measurement.level_,
+                      walang::escapeJson(measurement.result_), measurement.instructions_, measurement.bestSeconds_);
+    separator = ",";
+  }
+  os << "\n]\n";
+}
+
+/// @brief value of `"key": ` in one line written by `writeBaseline`, strings are unescaped
+std::string baselineField(std::string const &line, std::string const &key) {
+  std::string const prefix = "\"" + key + "\": ";
+  auto position = line.find(prefix);
+  if (position == std::string::npos) {
+    throw std::runtime_error("baseline entry without " + key + ": " + line);
+  }
+  position += prefix.size();
+  std::string value{};
+  if (line[position] != '"') {
+    auto end = line.find_first_of(",}", position);
+    return line.substr(position, end - position);
+  }
+  for (position++; position < line.size() && line[position] != '"'; position++) {
+    if (line[position] == '\\' && position + 1 < line.size()) {
+      position++;
+    }
+    value.push_back(line[position]);
+  }
+  return value;
+}
+
+/// @brief measurements of a baseline file keyed by kernel and level
+std::map<std::string, Measurement> readBaseline(std::string const &path) {
+  std::istringstream baseline{readFile(path)};
+  std::map<std::string, Measurement> measurements{};
+  std::string line{};
+  while (std::getline(baseline, line)) {
+    if (line.find("\"kernel\"") == std::string::npos) {
+      continue;
+    }
+    Measurement measurement{baselineField(line, "kernel"), baselineField(line, "level"),
+                            baselineField(line, "result"), std::stoull(baselineField(line, "instructions")),
+                            std::stod(baselineField(line, "seconds"))};
+    measurements.emplace(measurement.kernel_ + " " + measurement.level_, measurement);
+  }
+  return measurements;
+}
+
+double percentChange(double current, double base) { return base == 0.0 ? 0.0 : (current - base) * 100.0 / base; }
+
+/// @brief instruction counts are deterministic and gate regressions, wall time is too noisy and is only reported
+bool compareWithBaseline(std::vector<Measurement> const &measurements,
+                         std::map<std::string, Measurement> const &baseline, double thresholdPercent) {
+  bool regressed = false;
+  fmt::print("\n{:<12} {:<5} {:>14} {:>14} {:>9} {:>9}\n", "kernel", "level", "instructions", "baseline", "delta",
+             "time");
+  for (Measurement const &measurement : measurements) {
+    auto it = baseline.find(measurement.kernel_ + " " + measurement.level_);
+    if (it == baseline.end()) {
+      std::cerr << fmt::format("{} {}: missing from the baseline\n", measurement.kernel_, measurement.level_);
+      regressed = true;
+      continue;
+    }
+    Measurement const &base = it->second;
+    double delta = percentChange(static_cast<double>(measurement.instructions_),
+                                 static_cast<double>(base.instructions_));
+    double timeDelta = percentChange(measurement.bestSeconds_, base.bestSeconds_);
+    fmt::print("{:<12} {:<5} {:>14} {:>14} {:>+8.2f}% {:>+8.2f}%\n", measurement.kernel_, measurement.level_,
+               measurement.instructions_, base.instructions_, delta, timeDelta);
+    if (measurement.result_ != base.result_) {
+      std::cerr << fmt::format("{} {}: result {} differs from baseline result {}\n", measurement.kernel_,
+                               measurement.level_, measurement.result_, base.result_);
+      regressed = true;
+    } else if (delta > thresholdPercent) {
+      std::cerr << fmt::format("{} {}: instruction count regressed by {:.2f}%, threshold is {:.2f}%\n",
+                               measurement.kernel_, measurement.level_, delta, thresholdPercent);
+      regressed = true;
+    }
+  }
+  return !regressed;
+}
+
+} // namespace
+
+int main(int argc, const char *argv[]) {
+  std::vector<std::string> kernelPaths{};
+  std::string outputPath{};
+  std::string baselinePath{};
+  double thresholdPercent = 2.0;
+  uint32_t repeat = 3U;
+  for (int i = 1; i < argc; i++) {
+    std::string argument{argv[i]};
+    if (argument == "-o" || argument == "-r" || argument == "-b" || argument == "-t") {
+      if (i + 1 >= argc) {
+        printHelpAndExit();
+      }
+      if (argument == "-o") {
+        outputPath = argv[++i];
+      } else if (argument == "-b") {
+        baselinePath = argv[++i];
+      } else if (argument == "-t") {
+        char *end = nullptr;
+        thresholdPercent = std::strtod(argv[++i], &end);
+        if (*end != '\0' || thresholdPercent < 0.0) {
+          printHelpAndExit();
+        }
+      } else {
+        int value = std::atoi(argv[++i]);
+        if (value <= 0) {
+          printHelpAndExit();
+        }
+        repeat = static_cast<uint32_t>(value);
+      }
+      continue;
+    }
+    kernelPaths.push_back(argument);
+  }
+  if (kernelPaths.empty()) {
+    printHelpAndExit();
+  }
+  std::sort(kernelPaths.begin(), kernelPaths.end());
+
+  std::vector<Measurement> measurements{};
+  bool failed = false;
+  fmt::print("{:<12} {:<5} {:>14} {:>12}  {}\n", "kernel", "level", "instructions", "seconds", "result");
+  for (std::string const &path : kernelPaths) {
+    std::string source = readFile(path);
+    std::string expectedResult{};
+    for (char const *level : levels) {
+      try {
+        Measurement measurement = measure(path, source, level, repeat);
+        fmt::print("{:<12} {:<5} {:>14} {:>12.6f}  {}\n", measurement.kernel_, measurement.level_,
+                   measurement.instructions_, measurement.bestSeconds_, measurement.result_);
+        // optimization must not change what the kernel computes
+        if (expectedResult.empty()) {
+          expectedResult = measurement.result_;
+        } else if (measurement.result_ != expectedResult) {
+          std::cerr << fmt::format("{} {}: result {} differs from -O0 result {}\n", path, level, measurement.result_,
+                                   expectedResult);
+          failed = true;
+        }
+        measurements.push_back(measurement);
+      } catch (std::exception const &e) {
+        std::cerr << fmt::format("{} {}: {}\n", path, level, e.what());
+        failed = true;
+      }
+    }
+  }
+  if (!outputPath.empty()) {
+    std::ofstream output{outputPath};
+    if (!output.is_open()) {
+      std::cerr << "output path invalid " << outputPath << std::endl;
+      return -1;
+    }
+    writeBaseline(output, measurements);
+  }
+  if (!baselinePath.empty() && !std::filesystem::exists(baselinePath)) {
+    fmt::print("\nno baseline at {}, record one with `cmake --build <build> --target benchmarks-update-baseline`\n",
+               baselinePath);
+  } else if (!baselinePath.empty()) {
+    try {
+      failed = !compareWithBaseline(measurements, readBaseline(baselinePath), thresholdPercent) || failed;
+    } catch (std::exception const &e) {
+      std::cerr << e.what() << std::endl;
+      return -1;
+    }
+  }
+  return failed ? -1 : 0;
+}
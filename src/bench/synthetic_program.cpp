@@ -0,0 +1,145 @@
+#include "synthetic_program.hpp"
+#include "fmt/core.h"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace walang::bench {
+
+namespace {
+
+class Generator {
+public:
+  explicit Generator(SyntheticProgramOptions const &options) : options_(options), random_(options.seed_) {}
+
+  std::string generate() {
+    for (uint32_t i = 0; i < options_.classes_; i++) {
+      generateClass(i);
+    }
+    for (uint32_t i = 0; i < options_.functions_; i++) {
+      generateFunction(i);
+    }
+    if (options_.functions_ > 0U) {
+      source_ += fmt::format("let result = f{}(1, 2);\n", options_.functions_ - 1U);
+    }
+    return std::move(source_);
+  }
+
+private:
+  SyntheticProgramOptions const &options_;
+  std::mt19937 random_;
+  std::string source_{};
+  std::vector<std::string> operands_{};
+  uint32_t currentFunction_{0U};
+
+  uint32_t next(std::size_t bound) {
+    return std::uniform_int_distribution<uint32_t>{0U, static_cast<uint32_t>(bound) - 1U}(random_);
+  }
+  std::string const &variable() { return operands_[next(operands_.size())]; }
+  void line(uint32_t indent, std::string const &text) {
+    source_.append(indent * 2U, ' ');
+    source_ += text;
+    source_ += '\n';
+  }
+
+  void generateClass(uint32_t index) {
+    line(0U, fmt::format("class C{} {{", index));
+    line(1U, "m0: i32;");
+    line(1U, "m1: i32;");
+    line(1U, "m2: i32;");
+    line(1U, "function sum(): i32 {");
+    line(2U, "return this.m0 + this.m1 * this.m2;");
+    line(1U, "}");
+    line(1U, "function scale(v: i32): void {");
+    line(2U, "this.m0 = this.m0 * v + this.m1;");
+    line(1U, "}");
+    line(0U, "}");
+  }
+
+  std::string operand() {
+    switch (next(8U)) {
+    case 0U:
+      return std::to_string(next(1000U));
+    case 1U:
+      if (currentFunction_ > 0U) {
+        uint32_t callee = next(currentFunction_);
+        return fmt::format("f{}({}, {})", callee, variable(), variable());
+      }
+      break;
+    case 2U:
+      if (options_.classes_ > 0U) {
+        return next(2U) == 0U ? "o.sum()" : "o.m1";
+      }
+      break;
+    case 3U:
+      return fmt::format("({} - {})", variable(), next(100U));
+    default:
+      break;
+    }
+    return variable();
+  }
+  std::string expression() {
+    static constexpr char const *binaryOperators[] = {"+", "-", "*", "&", "|", "^", "<<", ">>"};
+    std::string expr = operand();
+    for (uint32_t i = 0; i < options_.expressionLength_; i++) {
+      expr += fmt::format(" {} {}", binaryOperators[next(std::size(binaryOperators))], operand());
+    }
+    return expr;
+  }
+  std::string condition() {
+    static constexpr char const *compareOperators[] = {"<", ">", "<=", ">=", "==", "!="};
+    return fmt::format("({}) {} ({})", expression(), compareOperators[next(std::size(compareOperators))],
+                       expression());
+  }
+
+  void generateBlock(uint32_t indent, uint32_t depth) {
+    line(indent, fmt::format("{} = {};", operands_[2U + next(options_.locals_)], expression()));
+    if (options_.classes_ > 0U) {
+      line(indent, fmt::format("o.scale({});", operand()));
+    }
+    if (depth == 0U) {
+      return;
+    }
+    bool isLoop = depth % 2U == 1U;
+    line(indent, fmt::format("{} ({}) {{", isLoop ? "while" : "if", condition()));
+    generateBlock(indent + 1U, depth - 1U);
+    if (isLoop) {
+      line(indent + 1U, fmt::format("if ({}) {{", condition()));
+      line(indent + 2U, "break;");
+      line(indent + 1U, "}");
+    }
+    line(indent, "}");
+  }
+
+  void generateFunction(uint32_t index) {
+    currentFunction_ = index;
+    operands_ = {"a", "b"};
+    line(0U, fmt::format("function f{}(a: i32, b: i32): i32 {{", index));
+    if (options_.classes_ > 0U) {
+      line(1U, fmt::format("let o = C{}();", index % options_.classes_));
+      line(1U, "o.m0 = a;");
+      line(1U, "o.m1 = b;");
+      line(1U, "o.m2 = a + b;");
+    }
+    for (uint32_t i = 0; i < options_.locals_; i++) {
+      std::string init = expression();
+      line(1U, fmt::format("let l{}: i32 = {};", i, init));
+      operands_.push_back(fmt::format("l{}", i));
+    }
+    if (options_.locals_ > 0U) {
+      generateBlock(1U, options_.depth_);
+    }
+    line(1U, fmt::format("return {};", expression()));
+    line(0U, "}");
+  }
+};
+
+} // namespace
+
+std::string generateSyntheticProgram(SyntheticProgramOptions const &options) { return Generator{options}.generate(); }
+
+} // namespace walang::bench
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace walang::bench {
+
+/// @brief knobs of the generated program, every generated program compiles
+struct SyntheticProgramOptions {
+  uint32_t functions_{200U};
+  uint32_t classes_{20U};
+  /// @brief nesting depth of while / if blocks in each function
+  uint32_t depth_{3U};
+  /// @brief number of binary operators in each generated expression
+  uint32_t expressionLength_{8U};
+  uint32_t locals_{8U};
+  uint32_t seed_{1U};
+};
+
+/// @brief deterministic program with classes, methods, calls, nested control flow and long expressions
+std::string generateSyntheticProgram(SyntheticProgramOptions const &options);
+
+} // namespace walang::bench
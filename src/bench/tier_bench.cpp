@@ -0,0 +1,127 @@
+#include "binaryen/runner.hpp"
+#include "compiler.hpp"
+#include "fmt/core.h"
+#include "interpreter.hpp"
+#include "parser.hpp"
+#include <algorithm>
+#include <binaryen-c.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+[[noreturn]] void printHelpAndExit() {
+  std::cerr << "walang-tier-bench kernel.wa... [-r repeat]\n"
+               "  compare the time from source to the result of `main` between the -O0 wasm tier and the interpreter"
+            << std::endl;
+  std::exit(-1);
+}
+
+struct Measurement {
+  std::string result_;
+  double bestSeconds_{std::numeric_limits<double>::max()};
+};
+
+std::string readFile(std::string const &path) {
+  std::ifstream file{path, std::ios::binary};
+  if (!file.is_open()) {
+    throw std::runtime_error("invalid path " + path);
+  }
+  std::ostringstream tmp;
+  tmp << file.rdbuf();
+  return tmp.str();
+}
+
+std::string firstResult(std::vector<std::string> const &results) {
+  return results.empty() ? std::string{} : results.front();
+}
+
+/// @brief parse, compile, validate, instantiate and invoke `main` like `walang run -O0`
+std::string runWasm(std::string const &path, std::string const &source) {
+  walang::Compiler compiler{{walang::FileParser(path, source).parse()}};
+  compiler.compile();
+  BinaryenAddFunctionExport(compiler.module(), "main", "main");
+  if (!BinaryenModuleValidate(compiler.module())) {
+    throw std::runtime_error("invalid module");
+  }
+  std::ostringstream hostOutput{};
+  walang::binaryen::Runner runner{compiler.module(), hostOutput};
+  return firstResult(runner.invoke("main", {}));
+}
+
+/// @brief parse, lower, execute top level statements and invoke `main` like `walang run --tier=interp`
+std::string runInterpreter(std::string const &path, std::string const &source) {
+  walang::Interpreter interpreter{{walang::FileParser(path, source).parse()}};
+  interpreter.start();
+  return firstResult(interpreter.invoke("main", {}));
+}
+
+template <class Run> Measurement measure(Run run, std::string const &path, std::string const &source, uint32_t repeat) {
+  Measurement measurement{};
+  for (uint32_t i = 0; i < repeat; i++) {
+    auto start = std::chrono::steady_clock::now();
+    measurement.result_ = run(path, source);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    measurement.bestSeconds_ = std::min(measurement.bestSeconds_, seconds);
+  }
+  return measurement;
+}
+
+} // namespace
+
+int main(int argc, const char *argv[]) {
+  std::vector<std::string> kernelPaths{};
+  uint32_t repeat = 3U;
+  for (int i = 1; i < argc; i++) {
+    std::string argument{argv[i]};
+    if (argument == "-r") {
+      if (i + 1 >= argc) {
+        printHelpAndExit();
+      }
+      int value = std::atoi(argv[++i]);
+      if (value <= 0) {
+        printHelpAndExit();
+      }
+      repeat = static_cast<uint32_t>(value);
+      continue;
+    }
+    kernelPaths.push_back(argument);
+  }
+  if (kernelPaths.empty()) {
+    printHelpAndExit();
+  }
+  std::sort(kernelPaths.begin(), kernelPaths.end());
+
+  bool failed = false;
+  fmt::print("{:<12} {:>12} {:>12} {:>8}  {}\n", "kernel", "wasm -O0", "interp", "speedup", "result");
+  for (std::string const &path : kernelPaths) {
+    try {
+      std::string source = readFile(path);
+      Measurement wasm = measure(runWasm, path, source, repeat);
+      Measurement interp = measure(runInterpreter, path, source, repeat);
+      fmt::print("{:<12} {:>12.6f} {:>12.6f} {:>7.2f}x  {}\n", std::filesystem::path{path}.stem().string(),
+                 wasm.bestSeconds_, interp.bestSeconds_, wasm.bestSeconds_ / interp.bestSeconds_, wasm.result_);
+      // both tiers must compute the same result
+      if (interp.result_ != wasm.result_) {
+        std::cerr << fmt::format("{}: interpreter result {} differs from wasm result {}\n", path, interp.result_,
+                                 wasm.result_);
+        failed = true;
+      }
+    } catch (std::exception const &e) {
+      std::cerr << fmt::format("{}: {}\n", path, e.what());
+      failed = true;
+    }
+  }
+  return failed ? -1 : 0;
+}
@@ -0,0 +1,193 @@
+#include "function_cache.hpp"
+#include "helper/hash.hpp"
+#include "ir/find_all.h"
+#include "wasm.h"
+#include <binaryen-c.h>
+#include <cstdint>
+#include <cstdlib>
+#include <fmt/core.h>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace walang::binaryen {
+
+namespace {
+
+constexpr std::string_view entryMagic{"WLFC"};
+constexpr std::size_t headerSize = entryMagic.size() + sizeof(uint64_t) * 2;
+
+void writeU64(std::string &out, uint64_t value) {
+  for (std::size_t i = 0; i < sizeof(value); i++) {
+    out.push_back(static_cast<char>(value & 0xffU));
+    value >>= 8U;
+  }
+}
+uint64_t readU64(std::string_view in) {
+  uint64_t value = 0;
+  for (std::size_t i = sizeof(value); i > 0; i--) {
+    value = (value << 8U) | static_cast<uint8_t>(in[i - 1]);
+  }
+  return value;
+}
+
+} // namespace
+
+FunctionCache::FunctionCache(std::filesystem::path directory, OptimizeOptions optimizeOptions)
+    : directory_(std::move(directory)), optimizeOptions_(std::move(optimizeOptions)) {
+  std::filesystem::create_directories(directory_);
+}
+
+std::filesystem::path FunctionCache::entryPath(uint64_t key) const {
+  return directory_ / fmt::format("{:016x}.wfc", key);
+}
+
+bool FunctionCache::contains(uint64_t key) const {
+  std::error_code ec{};
+  return std::filesystem::is_regular_file(entryPath(key), ec);
+}
+
+bool FunctionCache::load(BinaryenModuleRef module, std::string const &name, uint64_t key) {
+  std::ifstream file{entryPath(key), std::ios::binary};
+  if (!file.is_open()) {
+    return false;
+  }
+  std::string entry{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+  // binaryen aborts on malformed binary, reject truncated or foreign entries before reading it
+  if (entry.size() <= headerSize || std::string_view{entry}.substr(0, entryMagic.size()) != entryMagic) {
+    return false;
+  }
+  std::string_view header{entry.data() + entryMagic.size(), headerSize - entryMagic.size()};
+  std::string_view payload{entry.data() + headerSize, entry.size() - headerSize};
+  if (readU64(header) != key || readU64(header.substr(sizeof(uint64_t))) != Fnv1a{}.update(payload).digest()) {
+    return false;
+  }
+
+  std::vector<char> binary{payload.begin(), payload.end()};
+  BinaryenModuleRef carrier = BinaryenModuleRead(binary.data(), binary.size());
+  BinaryenFunctionRef cached = BinaryenGetFunction(carrier, name.c_str());
+  if (cached == nullptr) {
+    BinaryenModuleDispose(carrier);
+    return false;
+  }
+  std::vector<BinaryenType> vars{};
+  for (BinaryenIndex i = 0; i < BinaryenFunctionGetNumVars(cached); i++) {
+    vars.push_back(BinaryenFunctionGetVar(cached, i));
+  }
+  BinaryenExpressionRef body = BinaryenExpressionCopy(BinaryenFunctionGetBody(cached), module);
+  BinaryenFunctionRef function =
+      BinaryenAddFunction(module, name.c_str(), BinaryenFunctionGetParams(cached), BinaryenFunctionGetResults(cached),
+                          vars.data(), vars.size(), body);
+  for (BinaryenIndex i = 0; i < BinaryenFunctionGetNumLocals(cached); i++) {
+    if (BinaryenFunctionHasLocalName(cached, i)) {
+      BinaryenFunctionSetLocalName(function, i, BinaryenFunctionGetLocalName(cached, i));
+    }
+  }
+  BinaryenModuleDispose(carrier);
+  handledFunctions_.insert(name);
+  return true;
+}
+
+void FunctionCache::store(BinaryenModuleRef module, std::string const &name, uint64_t key) {
+  handledFunctions_.insert(name);
+  BinaryenFunctionRef function = BinaryenGetFunction(module, name.c_str());
+  optimizeOptions_.run(function, module);
+
+  BinaryenModuleRef carrier = BinaryenModuleCreate();
+  BinaryenModuleSetFeatures(carrier, BinaryenModuleGetFeatures(module));
+  BinaryenSetMemory(carrier, 0, 1, nullptr, nullptr, nullptr, nullptr, nullptr, 0, false, false, "0");
+  auto *functionIr = reinterpret_cast<wasm::Module *>(module)->getFunction(name);
+  std::set<std::string> imported{name};
+  for (wasm::Call *call : wasm::FindAll<wasm::Call>(functionIr->body).list) {
+    std::string callee{call->target.str};
+    if (!imported.insert(callee).second) {
+      continue;
+    }
+    BinaryenFunctionRef calleeRef = BinaryenGetFunction(module, callee.c_str());
+    BinaryenAddFunctionImport(carrier, callee.c_str(), "env", callee.c_str(), BinaryenFunctionGetParams(calleeRef),
+                              BinaryenFunctionGetResults(calleeRef));
+  }
+  auto importGlobal = [&](std::string const &globalName) {
+    if (!imported.insert(globalName).second) {
+      return;
+    }
+    BinaryenGlobalRef global = BinaryenGetGlobal(module, globalName.c_str());
+    BinaryenAddGlobalImport(carrier, globalName.c_str(), "env", globalName.c_str(), BinaryenGlobalGetType(global),
+                            BinaryenGlobalIsMutable(global));
+  };
+  for (wasm::GlobalGet *globalGet : wasm::FindAll<wasm::GlobalGet>(functionIr->body).list) {
+    importGlobal(std::string{globalGet->name.str});
+  }
+  for (wasm::GlobalSet *globalSet : wasm::FindAll<wasm::GlobalSet>(functionIr->body).list) {
+    importGlobal(std::string{globalSet->name.str});
+  }
+  std::vector<BinaryenType> vars{};
+  for (BinaryenIndex i = 0; i < BinaryenFunctionGetNumVars(function); i++) {
+    vars.push_back(BinaryenFunctionGetVar(function, i));
+  }
+  BinaryenFunctionRef copied = BinaryenAddFunction(
+      carrier, name.c_str(), BinaryenFunctionGetParams(function), BinaryenFunctionGetResults(function), vars.data(),
+      vars.size(), BinaryenExpressionCopy(BinaryenFunctionGetBody(function), carrier));
+  for (BinaryenIndex i = 0; i < BinaryenFunctionGetNumLocals(function); i++) {
+    if (BinaryenFunctionHasLocalName(function, i)) {
+      BinaryenFunctionSetLocalName(copied, i, BinaryenFunctionGetLocalName(function, i));
+    }
+  }
+
+  // names section is required to find the function and its imports again
+  bool const debugInfo = BinaryenGetDebugInfo();
+  BinaryenSetDebugInfo(true);
+  BinaryenModuleAllocateAndWriteResult result = BinaryenModuleAllocateAndWrite(carrier, nullptr);
+  BinaryenSetDebugInfo(debugInfo);
+  BinaryenModuleDispose(carrier);
+
+  std::string_view payload{static_cast<char const *>(result.binary), result.binaryBytes};
+  std::string entry{entryMagic};
+  writeU64(entry, key);
+  writeU64(entry, Fnv1a{}.update(payload).digest());
+  entry.append(payload);
+  std::free(result.binary);
+
+  // other compiler processes may share the directory, publish the entry atomically
+  std::filesystem::path path = entryPath(key);
+  std::filesystem::path temporaryPath = path;
+  temporaryPath += fmt::format(".{:08x}.tmp", std::random_device{}());
+  {
+    std::ofstream file{temporaryPath, std::ios::binary | std::ios::trunc};
+    if (!file.is_open()) {
+      return;
+    }
+    file.write(entry.data(), static_cast<std::streamsize>(entry.size()));
+    if (!file.good()) {
+      file.close();
+      std::error_code ec{};
+      std::filesystem::remove(temporaryPath, ec);
+      return;
+    }
+  }
+  std::error_code ec{};
+  std::filesystem::rename(temporaryPath, path, ec);
+  if (ec) {
+    std::filesystem::remove(temporaryPath, ec);
+  }
+}
+
+void FunctionCache::optimizeRemaining(BinaryenModuleRef module) const {
+  if (!optimizeOptions_.enabled()) {
+    return;
+  }
+  for (BinaryenIndex i = 0; i < BinaryenGetNumFunctions(module); i++) {
+    BinaryenFunctionRef function = BinaryenGetFunctionByIndex(module, i);
+    if (handledFunctions_.count(BinaryenFunctionGetName(function)) == 0) {
+      optimizeOptions_.run(function, module);
+    }
+  }
+}
+
+} // namespace walang::binaryen
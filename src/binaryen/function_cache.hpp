@@ -0,0 +1,38 @@
+#pragma once
+
+#include "optimize_options.hpp"
+#include <binaryen-c.h>
+#include <cstdint>
+#include <filesystem>
+#include <set>
+#include <string>
+
+namespace walang::binaryen {
+
+/// @brief persistent cache of lowered (and optionally optimized) functions
+/// every entry is a standalone wasm binary which contains the function and imports for the functions and globals it
+/// refers to, so it can be copied into another module with the same symbols
+class FunctionCache {
+public:
+  FunctionCache(std::filesystem::path directory, OptimizeOptions optimizeOptions);
+
+  [[nodiscard]] OptimizeOptions const &optimizeOptions() const noexcept { return optimizeOptions_; }
+  [[nodiscard]] bool contains(uint64_t key) const;
+
+  /// @brief add the function stored under `key` to `module` as `name`
+  /// @return false when there is no usable entry
+  bool load(BinaryenModuleRef module, std::string const &name, uint64_t key);
+  /// @brief optimize function `name` of `module` if required and store it under `key`
+  void store(BinaryenModuleRef module, std::string const &name, uint64_t key);
+  /// @brief optimize the functions which are not managed by cache, e.g. `_start` and constructors
+  void optimizeRemaining(BinaryenModuleRef module) const;
+
+private:
+  std::filesystem::path directory_;
+  OptimizeOptions optimizeOptions_;
+  std::set<std::string> handledFunctions_{};
+
+  [[nodiscard]] std::filesystem::path entryPath(uint64_t key) const;
+};
+
+} // namespace walang::binaryen
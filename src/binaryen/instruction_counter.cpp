@@ -0,0 +1,70 @@
+#include "instruction_counter.hpp"
+#include "ir/find_all.h"
+#include "ir/iteration.h"
+#include "wasm-builder.h"
+#include "wasm.h"
+#include <binaryen-c.h>
+#include <cstdint>
+
+namespace walang::binaryen {
+
+namespace {
+
+constexpr char const *counterGlobal = "walang$instructionCount";
+
+/// @brief size of the expressions executed unconditionally when `expression` runs, nested blocks and loops are
+/// counted when they are entered
+uint64_t measureStraightLine(wasm::Expression *expression) {
+  if (expression->is<wasm::Block>() || expression->is<wasm::Loop>()) {
+    return 1U;
+  }
+  if (auto *ifExpression = expression->dynCast<wasm::If>()) {
+    return 1U + measureStraightLine(ifExpression->condition);
+  }
+  uint64_t size = 1U;
+  for (wasm::Expression *child : wasm::ChildIterator(expression)) {
+    size += measureStraightLine(child);
+  }
+  return size;
+}
+
+} // namespace
+
+void InstructionCounter::instrument(BinaryenModuleRef module) {
+  auto &wasmModule = *reinterpret_cast<wasm::Module *>(module);
+  wasm::Builder builder{wasmModule};
+  wasmModule.addGlobal(
+      builder.makeGlobal(counterGlobal, wasm::Type::i64, builder.makeConst(int64_t{0}), wasm::Builder::Mutable));
+  auto asBlock = [&builder](wasm::Expression *&expression) {
+    if (expression != nullptr && !expression->is<wasm::Block>()) {
+      expression = builder.makeBlock(expression);
+    }
+  };
+  for (auto &function : wasmModule.functions) {
+    if (function->imported()) {
+      continue;
+    }
+    // every region which is entered becomes a block, so that only blocks need a counter
+    for (wasm::If *ifExpression : wasm::FindAll<wasm::If>(function->body).list) {
+      asBlock(ifExpression->ifTrue);
+      asBlock(ifExpression->ifFalse);
+    }
+    for (wasm::Loop *loop : wasm::FindAll<wasm::Loop>(function->body).list) {
+      asBlock(loop->body);
+    }
+    asBlock(function->body);
+    for (wasm::Block *block : wasm::FindAll<wasm::Block>(function->body).list) {
+      uint64_t size = 0U;
+      for (wasm::Expression *child : block->list) {
+        size += measureStraightLine(child);
+      }
+      wasm::Expression *count = builder.makeBinary(
+          wasm::AddInt64, builder.makeGlobalGet(counterGlobal, wasm::Type::i64), builder.makeConst(int64_t(size)));
+      block->list.insertAt(0, builder.makeGlobalSet(counterGlobal, count));
+    }
+  }
+  wasmModule.addFunction(builder.makeFunction(counterFunction, wasm::Signature(wasm::Type::none, wasm::Type::i64), {},
+                                              builder.makeGlobalGet(counterGlobal, wasm::Type::i64)));
+}
+
+} // namespace walang::binaryen
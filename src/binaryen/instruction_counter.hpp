@@ -0,0 +1,18 @@
+#pragma once
+
+#include <binaryen-c.h>
+
+namespace walang::binaryen {
+
+/// @brief approximate the dynamic instruction count of a module executed by the interpreter
+/// every block, loop iteration and if arm adds the size of its own expressions (nested control flow counts as one) to
+/// a global when it is entered, early exits by branches are not subtracted
+class InstructionCounter {
+public:
+  /// @brief function added by `instrument` which returns the instruction count as i64
+  static constexpr char const *counterFunction = "walang$instructions";
+
+  static void instrument(BinaryenModuleRef module);
+};
+
+} // namespace walang::binaryen
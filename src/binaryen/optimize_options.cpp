@@ -0,0 +1,104 @@
+#include "optimize_options.hpp"
+#include "helper/hash.hpp"
+#include <binaryen-c.h>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace walang::binaryen {
+
+namespace {
+
+std::vector<char const *> passNames(std::vector<std::string> const &passes) {
+  std::vector<char const *> names{};
+  names.reserve(passes.size());
+  for (std::string const &pass : passes) {
+    names.push_back(pass.c_str());
+  }
+  return names;
+}
+
+/// @brief inline sizes of binaryen before the first `apply`, an unset option restores them
+struct InlineMaxSizes {
+  BinaryenIndex alwaysInline_;
+  BinaryenIndex flexibleInline_;
+  BinaryenIndex oneCallerInline_;
+};
+InlineMaxSizes const &defaultInlineMaxSizes() {
+  static InlineMaxSizes const sizes{BinaryenGetAlwaysInlineMaxSize(), BinaryenGetFlexibleInlineMaxSize(),
+                                    BinaryenGetOneCallerInlineMaxSize()};
+  return sizes;
+}
+
+} // namespace
+
+std::optional<OptimizeOptions> OptimizeOptions::fromLevel(std::string const &level) {
+  if (level == "-Os") {
+    return OptimizeOptions{2U, 1U};
+  }
+  if (level == "-Oz") {
+    return OptimizeOptions{2U, 2U};
+  }
+  if (level.size() == 3U && level.rfind("-O", 0) == 0 && level[2] >= '0' && level[2] <= '4') {
+    return OptimizeOptions{static_cast<uint32_t>(level[2] - '0'), 0U};
+  }
+  return std::nullopt;
+}
+
+void OptimizeOptions::apply() const {
+  BinaryenSetOptimizeLevel(static_cast<int>(optimizeLevel_));
+  BinaryenSetShrinkLevel(static_cast<int>(shrinkLevel_));
+  // the sizes are process wide, an earlier `apply` must not leak into this pipeline
+  InlineMaxSizes const &defaults = defaultInlineMaxSizes();
+  BinaryenSetAlwaysInlineMaxSize(alwaysInlineMaxSize_.value_or(defaults.alwaysInline_));
+  BinaryenSetFlexibleInlineMaxSize(flexibleInlineMaxSize_.value_or(defaults.flexibleInline_));
+  BinaryenSetOneCallerInlineMaxSize(oneCallerInlineMaxSize_.value_or(defaults.oneCallerInline_));
+}
+
+void OptimizeOptions::run(BinaryenModuleRef module) const {
+  if (!enabled()) {
+    return;
+  }
+  if (passes_.empty()) {
+    BinaryenModuleOptimize(module);
+  } else {
+    std::vector<char const *> names = passNames(passes_);
+    BinaryenModuleRunPasses(module, names.data(), names.size());
+  }
+}
+void OptimizeOptions::run(BinaryenFunctionRef function, BinaryenModuleRef module) const {
+  if (!enabled()) {
+    return;
+  }
+  if (passes_.empty()) {
+    BinaryenFunctionOptimize(function, module);
+  } else {
+    std::vector<char const *> names = passNames(passes_);
+    BinaryenFunctionRunPasses(function, module, names.data(), names.size());
+  }
+}
+
+void OptimizeOptions::hash(Fnv1a &hash) const {
+  hash.update(optimizeLevel_).update(shrinkLevel_);
+  for (std::optional<uint32_t> const &size : {alwaysInlineMaxSize_, flexibleInlineMaxSize_, oneCallerInlineMaxSize_}) {
+    hash.update(size.has_value() ? static_cast<uint64_t>(size.value()) : UINT64_MAX);
+  }
+  hash.update(static_cast<uint64_t>(passes_.size()));
+  for (std::string const &pass : passes_) {
+    hash.update(pass);
+  }
+}
+
+void OptimizeOptions::setPassThreads(uint32_t threads) {
+  // binaryen sizes its thread pool from BINARYEN_CORES when the pool is created
+  std::string value = std::to_string(threads);
+#ifdef _WIN32
+  _putenv_s("BINARYEN_CORES", value.c_str());
+#else
+  setenv("BINARYEN_CORES", value.c_str(), 1);
+#endif
+}
+
+} // namespace walang::binaryen
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "helper/hash.hpp"
+#include <binaryen-c.h>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace walang::binaryen {
+
+/// @brief optimization pipeline of binaryen, levels follow wasm-opt (-Os is 2/1, -Oz is 2/2)
+/// binaryen keeps pass options in globals, `apply` must be called before any pass runs and resets every unset option
+struct OptimizeOptions {
+  uint32_t optimizeLevel_{0U};
+  uint32_t shrinkLevel_{0U};
+  std::optional<uint32_t> alwaysInlineMaxSize_{};
+  std::optional<uint32_t> flexibleInlineMaxSize_{};
+  std::optional<uint32_t> oneCallerInlineMaxSize_{};
+  /// @brief run exactly these passes instead of the default pipeline of the levels
+  std::vector<std::string> passes_{};
+
+  /// @brief parse -O0..-O4, -Os and -Oz
+  static std::optional<OptimizeOptions> fromLevel(std::string const &level);
+
+  [[nodiscard]] bool enabled() const noexcept { return optimizeLevel_ > 0U || shrinkLevel_ > 0U || !passes_.empty(); }
+  void apply() const;
+  void run(BinaryenModuleRef module) const;
+  void run(BinaryenFunctionRef function, BinaryenModuleRef module) const;
+  void hash(Fnv1a &hash) const;
+
+  /// @brief number of threads used by binaryen for parallel passes, must be set before the first pass runs
+  static void setPassThreads(uint32_t threads);
+};
+
+} // namespace walang::binaryen
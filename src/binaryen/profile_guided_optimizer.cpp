@@ -0,0 +1,114 @@
+#include "profile_guided_optimizer.hpp"
+#include "ir/utils.h"
+#include "optimize_options.hpp"
+#include "profile.hpp"
+#include "wasm.h"
+#include <algorithm>
+#include <binaryen-c.h>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace walang::binaryen {
+
+ProfileGuidedOptimizer::ProfileGuidedOptimizer(OptimizeOptions options, Profile const &profile)
+    : options_(std::move(options)) {
+  for (Profile::Counter const &counter : profile.counters()) {
+    // loop counters are named `function@line:column`
+    std::string function = counter.kind_ == Profile::Kind::Call ? counter.name_
+                                                                : counter.name_.substr(0, counter.name_.rfind('@'));
+    weights_[function] += counter.count_;
+  }
+  std::vector<uint64_t> weights{};
+  uint64_t total = 0U;
+  for (auto const &[function, weight] : weights_) {
+    weights.push_back(weight);
+    total += weight;
+  }
+  std::sort(weights.begin(), weights.end(), std::greater<>{});
+  uint64_t covered = 0U;
+  for (uint64_t weight : weights) {
+    if (weight == 0U || static_cast<double>(covered) >= hotCoverage * static_cast<double>(total)) {
+      break;
+    }
+    covered += weight;
+    hotThreshold_ = weight;
+  }
+}
+
+ProfileGuidedOptimizer::Temperature ProfileGuidedOptimizer::temperature(std::string const &function) const {
+  auto it = weights_.find(function);
+  if (it == weights_.end()) {
+    return Temperature::Warm;
+  }
+  if (it->second == 0U) {
+    return Temperature::Cold;
+  }
+  return it->second >= hotThreshold_ ? Temperature::Hot : Temperature::Warm;
+}
+
+OptimizeOptions ProfileGuidedOptimizer::optionsFor(Temperature temperature) const {
+  OptimizeOptions options = options_;
+  switch (temperature) {
+  case Temperature::Hot:
+    options.optimizeLevel_ = std::max(options.optimizeLevel_, 3U);
+    options.shrinkLevel_ = 0U;
+    break;
+  case Temperature::Warm:
+    break;
+  case Temperature::Cold:
+    options.shrinkLevel_ = 2U;
+    break;
+  }
+  return options;
+}
+
+void ProfileGuidedOptimizer::run(BinaryenModuleRef module) const {
+  if (options_.enabled()) {
+    options_.apply();
+    uint32_t const defaultFlexibleInlineMaxSize = BinaryenGetFlexibleInlineMaxSize();
+    uint32_t flexibleInlineMaxSize = defaultFlexibleInlineMaxSize;
+    // raise the flexible inlining limit so that lightweight hot callees up to `hotInlineMaxSize` fit
+    for (BinaryenIndex i = 0; i < BinaryenGetNumFunctions(module); i++) {
+      BinaryenFunctionRef function = BinaryenGetFunctionByIndex(module, i);
+      BinaryenExpressionRef body = BinaryenFunctionGetBody(function);
+      if (body != nullptr && temperature(BinaryenFunctionGetName(function)) == Temperature::Hot) {
+        auto size = static_cast<uint32_t>(wasm::Measurer::measure(reinterpret_cast<wasm::Expression *>(body)));
+        flexibleInlineMaxSize = std::max(flexibleInlineMaxSize, std::min(size, hotInlineMaxSize));
+      }
+    }
+    for (BinaryenIndex i = 0; i < BinaryenGetNumFunctions(module); i++) {
+      BinaryenFunctionRef function = BinaryenGetFunctionByIndex(module, i);
+      if (BinaryenFunctionGetBody(function) == nullptr) {
+        continue;
+      }
+      OptimizeOptions options = optionsFor(temperature(BinaryenFunctionGetName(function)));
+      options.apply();
+      options.run(function, module);
+    }
+    options_.apply();
+    BinaryenSetFlexibleInlineMaxSize(flexibleInlineMaxSize);
+    char const *passes[] = {"inlining-optimizing", "remove-unused-module-elements"};
+    BinaryenModuleRunPasses(module, passes, 2U);
+    BinaryenSetFlexibleInlineMaxSize(defaultFlexibleInlineMaxSize);
+  }
+  reorderFunctions(module);
+}
+
+void ProfileGuidedOptimizer::reorderFunctions(BinaryenModuleRef module) const {
+  auto rank = [this](wasm::Function const &function) {
+    std::string name{function.name.str};
+    auto it = weights_.find(name);
+    // hotter first within the same temperature, functions missing in the profile last
+    return std::make_pair(static_cast<int>(temperature(name)),
+                          it == weights_.end() ? UINT64_MAX : UINT64_MAX - it->second);
+  };
+  auto &functions = reinterpret_cast<wasm::Module *>(module)->functions;
+  std::stable_sort(functions.begin(), functions.end(),
+                   [&rank](auto const &a, auto const &b) { return rank(*a) < rank(*b); });
+}
+
+} // namespace walang::binaryen
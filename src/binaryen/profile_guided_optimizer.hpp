@@ -0,0 +1,41 @@
+#pragma once
+
+#include "optimize_options.hpp"
+#include "profile.hpp"
+#include <binaryen-c.h>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace walang::binaryen {
+
+/// @brief optimize a module with recorded execution counts
+/// hot functions are optimized for speed and may grow when their callees are inlined, cold functions are optimized
+/// for size, and functions are ordered hottest first in the emitted module
+class ProfileGuidedOptimizer {
+public:
+  enum class Temperature { Hot, Warm, Cold };
+
+  /// @brief share of the total count covered by the hot functions
+  static constexpr double hotCoverage = 0.9;
+  /// @brief size limit of hot callees for flexible inlining
+  static constexpr uint32_t hotInlineMaxSize = 100U;
+
+  ProfileGuidedOptimizer(OptimizeOptions options, Profile const &profile);
+
+  /// @brief functions executed in the profile are hot until they cover `hotCoverage` of all counts, functions which
+  /// are never executed are cold, functions missing in the profile are warm
+  [[nodiscard]] Temperature temperature(std::string const &function) const;
+  void run(BinaryenModuleRef module) const;
+
+private:
+  OptimizeOptions options_;
+  /// @brief entries plus loop back-edges of each function
+  std::map<std::string, uint64_t> weights_{};
+  uint64_t hotThreshold_{UINT64_MAX};
+
+  [[nodiscard]] OptimizeOptions optionsFor(Temperature temperature) const;
+  void reorderFunctions(BinaryenModuleRef module) const;
+};
+
+} // namespace walang::binaryen
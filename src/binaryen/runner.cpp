@@ -0,0 +1,113 @@
+#include "runner.hpp"
+#include "ir/module-utils.h"
+#include "shell-interface.h"
+#include "wasm-interpreter.h"
+#include "wasm.h"
+#include <binaryen-c.h>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fmt/core.h>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace walang::binaryen {
+
+class Runner::HostInterface : public wasm::ShellExternalInterface {
+public:
+  explicit HostInterface(std::ostream &hostOutput) : hostOutput_(hostOutput) {}
+
+  void importGlobals(std::map<wasm::Name, wasm::Literals> &globals, wasm::Module &wasm) override {
+    wasm::ModuleUtils::iterImportedGlobals(
+        wasm, [&globals](wasm::Global *import) { globals[import->name] = wasm::Literal::makeZeros(import->type); });
+  }
+  wasm::Literals callImport(wasm::Function *import, wasm::Literals &arguments) override {
+    hostOutput_ << import->module << "." << import->base << "(";
+    for (std::size_t i = 0; i < arguments.size(); i++) {
+      hostOutput_ << (i == 0 ? "" : ", ") << arguments[i];
+    }
+    hostOutput_ << ")\n";
+    return wasm::Literal::makeZeros(import->getResults());
+  }
+  void trap(char const *why) override { throw RuntimeTrap(fmt::format("trap: {}", why)); }
+  void hostLimit(char const *why) override { throw RuntimeTrap(fmt::format("host limit: {}", why)); }
+
+private:
+  std::ostream &hostOutput_;
+};
+
+wasm::Literal parseArgument(wasm::Type type, std::string const &argument) {
+  // reject trailing characters such as `1x` or `1.5` for an integer
+  std::size_t parsed = 0U;
+  try {
+    if (type == wasm::Type::i32) {
+      auto value = static_cast<int32_t>(std::stoi(argument, &parsed));
+      if (parsed == argument.size()) {
+        return wasm::Literal(value);
+      }
+    }
+    if (type == wasm::Type::i64) {
+      auto value = static_cast<int64_t>(std::stoll(argument, &parsed));
+      if (parsed == argument.size()) {
+        return wasm::Literal(value);
+      }
+    }
+    if (type == wasm::Type::f32) {
+      auto value = std::stof(argument, &parsed);
+      if (parsed == argument.size()) {
+        return wasm::Literal(value);
+      }
+    }
+    if (type == wasm::Type::f64) {
+      auto value = std::stod(argument, &parsed);
+      if (parsed == argument.size()) {
+        return wasm::Literal(value);
+      }
+    }
+  } catch (std::exception const &) {
+  }
+  throw std::invalid_argument(fmt::format("cannot pass '{}' as {}", argument, type.toString()));
+}
+
+Runner::Runner(BinaryenModuleRef module, std::ostream &hostOutput)
+    : module_(module), host_(std::make_unique<HostInterface>(hostOutput)),
+      instance_(std::make_unique<wasm::ModuleRunner>(*reinterpret_cast<wasm::Module *>(module), host_.get())) {}
+
+Runner::~Runner() = default;
+
+std::vector<std::string> Runner::invoke(std::string const &name, std::vector<std::string> const &arguments) {
+  auto *wasmModule = reinterpret_cast<wasm::Module *>(module_);
+  wasm::Function *function = nullptr;
+  wasm::Export *exported = wasmModule->getExportOrNull(name);
+  if (exported != nullptr && exported->kind == wasm::ExternalKind::Function) {
+    function = wasmModule->getFunction(exported->value);
+  } else {
+    function = wasmModule->getFunctionOrNull(name);
+  }
+  if (function == nullptr || function->imported()) {
+    throw std::invalid_argument(fmt::format("unknown function '{}'", name));
+  }
+  wasm::Type params = function->getParams();
+  if (params.size() != arguments.size()) {
+    throw std::invalid_argument(
+        fmt::format("function '{}' expects {} arguments but got {}", name, params.size(), arguments.size()));
+  }
+  wasm::Literals literals{};
+  for (std::size_t i = 0; i < arguments.size(); i++) {
+    literals.push_back(parseArgument(params[i], arguments[i]));
+  }
+  std::vector<std::string> results{};
+  for (wasm::Literal const &result : instance_->callFunction(function->name, literals)) {
+    std::ostringstream value{};
+    value << result;
+    results.push_back(value.str());
+  }
+  return results;
+}
+
+} // namespace walang::binaryen
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <binaryen-c.h>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace wasm {
+class Literal;
+class ModuleRunner;
+class Type;
+} // namespace wasm
+
+namespace walang::binaryen {
+
+/// @brief wasm trap or host limit hit while interpreting
+class RuntimeTrap : public std::runtime_error {
+public:
+  explicit RuntimeTrap(std::string const &why) : std::runtime_error(why) {}
+};
+
+/// @brief parse an `--invoke` argument as a value of `type`, shared by every execution tier
+/// @throw std::invalid_argument when the whole argument is not a value of `type`
+wasm::Literal parseArgument(wasm::Type type, std::string const &argument);
+
+/// @brief execute a compiled module in process with the binaryen interpreter
+/// imports are stubbed by the host: calls are printed to `hostOutput` and return zero
+class Runner {
+public:
+  /// @brief instantiate `module`, which executes its start function
+  Runner(BinaryenModuleRef module, std::ostream &hostOutput);
+  Runner(Runner const &) = delete;
+  Runner &operator=(Runner const &) = delete;
+  ~Runner();
+
+  /// @brief call an export or a function by its internal name, arguments are parsed by the parameter types
+  /// @return printed result values
+  std::vector<std::string> invoke(std::string const &name, std::vector<std::string> const &arguments);
+
+private:
+  class HostInterface;
+
+  BinaryenModuleRef module_;
+  std::unique_ptr<HostInterface> host_;
+  std::unique_ptr<wasm::ModuleRunner> instance_;
+};
+
+} // namespace walang::binaryen
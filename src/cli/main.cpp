@@ -1,21 +1,76 @@
 #include "binaryen-c.h"
+#include "binaryen/function_cache.hpp"
+#include "binaryen/optimize_options.hpp"
+#include "binaryen/profile_guided_optimizer.hpp"
+#include "binaryen/runner.hpp"
 #include "compiler.hpp"
 #include "fmt/color.h"
 #include "fmt/core.h"
+#include "helper/thread_pool.hpp"
+#include "helper/trace.hpp"
+#include "interpreter.hpp"
 #include "parser.hpp"
+#include "profile.hpp"
+#include "statistics.hpp"
 #include <algorithm>
+#include <cstdint>
 #include <cstdlib>
 #include <exception>
 #include <filesystem>
+#include <fstream>
+#include <future>
 #include <iostream>
 #include <list>
+#include <memory>
+#include <optional>
+#include <sstream>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 [[noreturn]] void printHelpAndExit() {
-  std::cerr << "walang source [-o target])" << std::endl;
+  std::cerr << "walang [run] source... [-o target] [-O0|-O1|-O2|-O3|-O4|-Os|-Oz] [-j jobs] [--cache-dir dir] "
+               "[--emit=wat|wasm]\n"
+               "  [--passes=pass,...] [--pass-threads=n] [--always-inline-max-size=n] [--flexible-inline-max-size=n] "
+               "[--one-caller-inline-max-size=n]\n"
+               "  [--frontend-inline-max-size=n] [--time-passes] [--trace=out.json] [--stats=out.json] "
+               "[--instrument=calls,loops] "
+               "[--profile-use=profile.data] [--source-map] [--enable-multivalue] [--enable-bulk-memory]\n"
+               "  run: execute the module in process after compiling [--invoke=function] [--args=value,...] "
+               "[--profile-out=profile.data]\n"
+               "  [--tier=wasm|interp] interp walks the source without compiling, options about the module are "
+               "rejected"
+            << std::endl;
   std::exit(-1);
 }
 
+/// @brief remove `--name=value` from arguments
+std::optional<std::string> takeValueOption(std::list<std::string> &arguments, std::string const &name) {
+  std::string prefix = name + "=";
+  auto matches = [&prefix](std::string const &argument) { return argument.rfind(prefix, 0) == 0; };
+  if (std::count_if(arguments.cbegin(), arguments.cend(), matches) > 1) {
+    printHelpAndExit();
+  }
+  auto it = std::find_if(arguments.cbegin(), arguments.cend(), matches);
+  if (it == arguments.end()) {
+    return std::nullopt;
+  }
+  std::string value = it->substr(prefix.size());
+  arguments.erase(it);
+  return value;
+}
+std::optional<uint32_t> takeUnsignedOption(std::list<std::string> &arguments, std::string const &name) {
+  auto value = takeValueOption(arguments, name);
+  if (!value.has_value()) {
+    return std::nullopt;
+  }
+  try {
+    return static_cast<uint32_t>(std::stoul(value.value()));
+  } catch (std::exception const &) {
+    printHelpAndExit();
+  }
+}
+
 std::string readFile(std::string const &path) {
   std::ifstream file{path, std::ios::binary};
   if (!file.is_open()) {
@@ -26,15 +81,99 @@ std::string readFile(std::string const &path) {
   return tmp.str();
 }
 
+std::vector<std::shared_ptr<walang::ast::File>> parseFiles(std::vector<std::string> const &inputFilePaths,
+                                                          uint32_t jobs, walang::Tracer *tracer) {
+  auto parseFile = [tracer](std::string const &inputFilePath) {
+    std::string source = readFile(inputFilePath);
+    walang::TraceScope scope{tracer, "parse", inputFilePath};
+    walang::FileParser parser(inputFilePath, source);
+    return parser.parse();
+  };
+  std::vector<std::shared_ptr<walang::ast::File>> files{};
+  files.reserve(inputFilePaths.size());
+  if (jobs <= 1U || inputFilePaths.size() <= 1U) {
+    for (auto const &inputFilePath : inputFilePaths) {
+      files.push_back(parseFile(inputFilePath));
+    }
+    return files;
+  }
+  walang::ThreadPool pool{std::min(jobs, static_cast<uint32_t>(inputFilePaths.size()))};
+  std::vector<std::future<std::shared_ptr<walang::ast::File>>> pendingFiles{};
+  pendingFiles.reserve(inputFilePaths.size());
+  for (auto const &inputFilePath : inputFilePaths) {
+    pendingFiles.push_back(pool.submit([&parseFile, &inputFilePath] { return parseFile(inputFilePath); }));
+  }
+  // keep the input order so that top level statements are executed in the order of the command line
+  for (auto &pendingFile : pendingFiles) {
+    files.push_back(pendingFile.get());
+  }
+  return files;
+}
+
+/// @brief execute `files` with the tree-walking interpreter instead of the compiled module
+void interpret(std::vector<std::shared_ptr<walang::ast::File>> files, std::optional<std::string> const &invoke,
+               std::optional<std::string> const &invokeArguments, walang::Tracer *tracer) {
+  walang::TraceScope scope{tracer, "interpret"};
+  std::unique_ptr<walang::Interpreter> interpreter{};
+  try {
+    interpreter = std::make_unique<walang::Interpreter>(std::move(files));
+  } catch (std::exception const &e) {
+    std::cerr << fmt::format("Compile Failed:\n{}", fmt::styled(e.what(), fmt::fg(fmt::color::orange))) << "\n";
+    std::exit(-1);
+  }
+  try {
+    interpreter->start();
+    if (invoke.has_value()) {
+      std::vector<std::string> values{};
+      std::istringstream valueStream{invokeArguments.value_or("")};
+      for (std::string value; std::getline(valueStream, value, ',');) {
+        values.push_back(value);
+      }
+      for (std::string const &result : interpreter->invoke(invoke.value(), values)) {
+        std::cout << result << "\n";
+      }
+    }
+  } catch (std::exception const &e) {
+    std::cerr << fmt::format("Run Failed:\n{}", fmt::styled(e.what(), fmt::fg(fmt::color::orange))) << "\n";
+    std::exit(-1);
+  }
+}
+
+void writeTrace(walang::Tracer const *tracer, bool timePasses, std::optional<std::string> const &tracePath) {
+  if (timePasses) {
+    tracer->writeSummary(std::cerr);
+  }
+  if (tracePath.has_value()) {
+    std::ofstream traceFile{tracePath.value()};
+    if (!traceFile.is_open()) {
+      std::cerr << "trace path invalid " << tracePath.value() << std::endl;
+      std::exit(-1);
+    }
+    tracer->writeChromeTrace(traceFile);
+  }
+}
+
 int main(int argc, const char *argv[]) {
-  std::string inputFilePath;
+  std::vector<std::string> inputFilePaths;
   std::string outputFilePath;
-  bool optimize = false;
+  walang::binaryen::OptimizeOptions optimizeOptions{};
+  uint32_t jobs = 1U;
+  std::string cacheDirectory;
+  bool emitWasm = false;
+  bool timePasses = false;
+  bool sourceMap = false;
+  bool multivalue = false;
+  bool bulkMemory = false;
+  bool run = false;
 
   std::list<std::string> arguments{};
   for (int i = 1; i < argc; i++) {
     arguments.emplace_back(argv[i]);
   }
+  if (!arguments.empty() && arguments.front() == "run") {
+    run = true;
+    arguments.pop_front();
+  }
   if (std::count(arguments.cbegin(), arguments.cend(), "-o") > 1) {
     printHelpAndExit();
   }
@@ -48,39 +187,297 @@ int main(int argc, const char *argv[]) {
       printHelpAndExit();
     }
   }
-  auto optimizeIt = std::find(arguments.cbegin(), arguments.cend(), "-O2");
+  auto isOptimizeLevel = [](std::string const &argument) {
+    return walang::binaryen::OptimizeOptions::fromLevel(argument).has_value();
+  };
+  if (std::count_if(arguments.cbegin(), arguments.cend(), isOptimizeLevel) > 1) {
+    printHelpAndExit();
+  }
+  auto optimizeIt = std::find_if(arguments.cbegin(), arguments.cend(), isOptimizeLevel);
   if (optimizeIt != arguments.end()) {
-    optimize = true;
+    optimizeOptions = walang::binaryen::OptimizeOptions::fromLevel(*optimizeIt).value();
     arguments.erase(optimizeIt);
   }
+  auto passes = takeValueOption(arguments, "--passes");
+  if (passes.has_value()) {
+    std::istringstream passStream{passes.value()};
+    for (std::string pass; std::getline(passStream, pass, ',');) {
+      if (!pass.empty()) {
+        optimizeOptions.passes_.push_back(pass);
+      }
+    }
+    if (optimizeOptions.passes_.empty()) {
+      printHelpAndExit();
+    }
+  }
+  optimizeOptions.alwaysInlineMaxSize_ = takeUnsignedOption(arguments, "--always-inline-max-size");
+  optimizeOptions.flexibleInlineMaxSize_ = takeUnsignedOption(arguments, "--flexible-inline-max-size");
+  optimizeOptions.oneCallerInlineMaxSize_ = takeUnsignedOption(arguments, "--one-caller-inline-max-size");
+  auto frontendInlineMaxSize = takeUnsignedOption(arguments, "--frontend-inline-max-size");
+  auto passThreads = takeUnsignedOption(arguments, "--pass-threads");
+  if (passThreads.has_value()) {
+    walang::binaryen::OptimizeOptions::setPassThreads(
+        passThreads.value() == 0U ? walang::ThreadPool::hardwareConcurrency() : passThreads.value());
+  }
+  if (std::count(arguments.cbegin(), arguments.cend(), "-j") > 1) {
+    printHelpAndExit();
+  }
+  auto jobsIt = std::find(arguments.cbegin(), arguments.cend(), "-j");
+  if (jobsIt != arguments.end()) {
+    jobsIt = arguments.erase(jobsIt);
+    if (jobsIt == arguments.end()) {
+      printHelpAndExit();
+    }
+    try {
+      jobs = static_cast<uint32_t>(std::stoul(*jobsIt));
+    } catch (std::exception const &) {
+      printHelpAndExit();
+    }
+    if (jobs == 0U) {
+      jobs = walang::ThreadPool::hardwareConcurrency();
+    }
+    arguments.erase(jobsIt);
+  }
+  if (std::count(arguments.cbegin(), arguments.cend(), "--cache-dir") > 1) {
+    printHelpAndExit();
+  }
+  auto cacheIt = std::find(arguments.cbegin(), arguments.cend(), "--cache-dir");
+  if (cacheIt != arguments.end()) {
+    cacheIt = arguments.erase(cacheIt);
+    if (cacheIt == arguments.end()) {
+      printHelpAndExit();
+    }
+    cacheDirectory = *cacheIt;
+    arguments.erase(cacheIt);
+  }
+  auto sourceMapIt = std::find(arguments.cbegin(), arguments.cend(), "--source-map");
+  if (sourceMapIt != arguments.end()) {
+    sourceMap = true;
+    arguments.erase(sourceMapIt);
+  }
+  auto multivalueIt = std::find(arguments.cbegin(), arguments.cend(), "--enable-multivalue");
+  if (multivalueIt != arguments.end()) {
+    multivalue = true;
+    arguments.erase(multivalueIt);
+  }
+  auto bulkMemoryIt = std::find(arguments.cbegin(), arguments.cend(), "--enable-bulk-memory");
+  if (bulkMemoryIt != arguments.end()) {
+    bulkMemory = true;
+    arguments.erase(bulkMemoryIt);
+  }
+  auto timePassesIt = std::find(arguments.cbegin(), arguments.cend(), "--time-passes");
+  if (timePassesIt != arguments.end()) {
+    timePasses = true;
+    arguments.erase(timePassesIt);
+  }
+  auto tracePath = takeValueOption(arguments, "--trace");
+  auto statsPath = takeValueOption(arguments, "--stats");
+  auto emit = takeValueOption(arguments, "--emit");
+  auto invoke = takeValueOption(arguments, "--invoke");
+  auto invokeArguments = takeValueOption(arguments, "--args");
+  auto profileOutPath = takeValueOption(arguments, "--profile-out");
+  auto tier = takeValueOption(arguments, "--tier");
+  if (!run && (invoke.has_value() || invokeArguments.has_value() || profileOutPath.has_value() || tier.has_value())) {
+    printHelpAndExit();
+  }
+  if (tier.has_value() && tier.value() != "wasm" && tier.value() != "interp") {
+    printHelpAndExit();
+  }
+  bool const interpretTier = tier.value_or("wasm") == "interp";
+  walang::InstrumentOptions instrumentOptions{};
+  auto instrument = takeValueOption(arguments, "--instrument");
+  if (instrument.has_value()) {
+    auto parsedInstrumentOptions = walang::InstrumentOptions::parse(instrument.value());
+    if (!parsedInstrumentOptions.has_value()) {
+      printHelpAndExit();
+    }
+    instrumentOptions = parsedInstrumentOptions.value();
+  }
+  if (profileOutPath.has_value() && !instrumentOptions.enabled()) {
+    printHelpAndExit();
+  }
+  std::optional<walang::Profile> profile{};
+  auto profileUsePath = takeValueOption(arguments, "--profile-use");
+  if (profileUsePath.has_value()) {
+    std::ifstream profileFile{profileUsePath.value()};
+    if (!profileFile.is_open()) {
+      std::cerr << "profile path invalid " << profileUsePath.value() << std::endl;
+      std::exit(-1);
+    }
+    try {
+      profile = walang::Profile::read(profileFile);
+    } catch (std::exception const &e) {
+      std::cerr << e.what() << std::endl;
+      std::exit(-1);
+    }
+  }
+  if (emit.has_value()) {
+    if (emit.value() == "wasm") {
+      emitWasm = true;
+    } else if (emit.value() != "wat") {
+      printHelpAndExit();
+    }
+  }
 
-  if (arguments.size() != 1) {
+  if (arguments.empty() || (sourceMap && !emitWasm)) {
+    printHelpAndExit();
+  }
+  // the interpreter never builds a module
+  if (interpretTier && (!outputFilePath.empty() || emit.has_value() || statsPath.has_value() ||
+                        instrumentOptions.enabled() || profileUsePath.has_value() || !cacheDirectory.empty() ||
+                        multivalue || bulkMemory || frontendInlineMaxSize.has_value())) {
     printHelpAndExit();
   }
-  inputFilePath = arguments.front();
+  inputFilePaths.assign(arguments.begin(), arguments.end());
+  // run only writes the module when asked for
+  bool const writeModule = !run || !outputFilePath.empty();
   if (outputFilePath.empty()) {
-    outputFilePath = std::filesystem::path{inputFilePath}.replace_extension("wat").string();
+    outputFilePath =
+        std::filesystem::path{inputFilePaths.front()}.replace_extension(emitWasm ? "wasm" : "wat").string();
+  }
+  optimizeOptions.apply();
+  if (sourceMap) {
+    // keep debug locations and names through the optimizer and the binary writer
+    BinaryenSetDebugInfo(true);
+  }
+  std::shared_ptr<walang::Tracer> tracer{};
+  if (timePasses || tracePath.has_value()) {
+    tracer = std::make_shared<walang::Tracer>();
+  }
+  auto files = parseFiles(inputFilePaths, jobs, tracer.get());
+  if (interpretTier) {
+    interpret(std::move(files), invoke, invokeArguments, tracer.get());
+    writeTrace(tracer.get(), timePasses, tracePath);
+    return 0;
+  }
+  walang::Compiler compiler(files);
+  compiler.setThreads(jobs);
+  compiler.setTracer(tracer);
+  compiler.setInstrumentOptions(instrumentOptions);
+  compiler.setDebugInfo(sourceMap);
+  compiler.setMultivalue(multivalue);
+  compiler.setBulkMemory(bulkMemory);
+  if (frontendInlineMaxSize.has_value()) {
+    compiler.setInlineMaxSize(frontendInlineMaxSize.value());
+  }
+  std::shared_ptr<walang::binaryen::FunctionCache> functionCache{};
+  // cached functions are already optimized without the profile, the profile guided pass would optimize them again and
+  // the output would depend on whether the cache is warm
+  if (!cacheDirectory.empty() && !instrumentOptions.enabled() && !profile.has_value()) {
+    functionCache = std::make_shared<walang::binaryen::FunctionCache>(cacheDirectory, optimizeOptions);
+    compiler.setFunctionCache(functionCache);
   }
-  std::string source = readFile(inputFilePath);
-  walang::FileParser parser(inputFilePath, source);
-  auto file = parser.parse();
-  walang::Compiler compiler({file});
   try {
     compiler.compile();
   } catch (std::exception const &e) {
     std::cerr << fmt::format("Compile Failed:\n{}", fmt::styled(e.what(), fmt::fg(fmt::color::orange))) << "\n";
     std::exit(-1);
   }
-  std::ofstream outputFile{outputFilePath};
-  if (!outputFile.is_open()) {
-    std::cerr << "output path invalid " << outputFilePath << std::endl;
+  for (std::string const &warning : compiler.warnings()) {
+    std::cerr << fmt::format("Warning:\n{}", fmt::styled(warning, fmt::fg(fmt::color::yellow))) << "\n";
+  }
+  std::ofstream outputFile{};
+  if (writeModule) {
+    outputFile.open(outputFilePath, emitWasm ? std::ios::out | std::ios::binary : std::ios::out);
+    if (!outputFile.is_open()) {
+      std::cerr << "output path invalid " << outputFilePath << std::endl;
+    }
+  }
+  walang::Statistics statistics{};
+  if (statsPath.has_value()) {
+    compiler.collectStatistics(statistics);
   }
-  if (optimize) {
-    BinaryenModuleValidate(compiler.module());
-    BinaryenModuleOptimize(compiler.module());
-    outputFile << compiler.wat();
+  bool valid = true;
+  auto validate = [&compiler, &tracer, &valid]() {
+    walang::TraceScope scope{tracer.get(), "validate"};
+    valid = BinaryenModuleValidate(compiler.module());
+  };
+  auto writeOutput = [&compiler, &outputFile, &outputFilePath, &tracer, emitWasm, writeModule, sourceMap]() {
+    if (!writeModule) {
+      return;
+    }
+    walang::TraceScope scope{tracer.get(), "emit"};
+    if (sourceMap) {
+      std::string sourceMapPath = outputFilePath + ".map";
+      std::ofstream sourceMapFile{sourceMapPath};
+      if (!sourceMapFile.is_open()) {
+        std::cerr << "source map path invalid " << sourceMapPath << std::endl;
+        std::exit(-1);
+      }
+      // the map is next to the module, so it is referred by its file name
+      compiler.writeWasm(outputFile, std::filesystem::path{sourceMapPath}.filename().string(), sourceMapFile);
+    } else if (emitWasm) {
+      compiler.writeWasm(outputFile);
+    } else {
+      compiler.writeWat(outputFile);
+    }
+  };
+  if (optimizeOptions.enabled() || profile.has_value()) {
+    validate();
+    {
+      walang::TraceScope scope{tracer.get(), "optimize"};
+      if (profile.has_value()) {
+        walang::binaryen::ProfileGuidedOptimizer{optimizeOptions, profile.value()}.run(compiler.module());
+      } else if (functionCache != nullptr) {
+        // cached functions are optimized one by one, whole module optimization would redo them every time
+        functionCache->optimizeRemaining(compiler.module());
+      } else {
+        optimizeOptions.run(compiler.module());
+      }
+    }
+    if (statsPath.has_value()) {
+      statistics.expressionsAfterOptimization_ = walang::Statistics::countExpressions(compiler.module());
+    }
+    writeOutput();
   } else {
-    outputFile << compiler.wat();
-    BinaryenModuleValidate(compiler.module());
+    writeOutput();
+    validate();
+  }
+  if (run) {
+    if (!valid) {
+      std::cerr << "Run Failed:\ninvalid module" << std::endl;
+      std::exit(-1);
+    }
+    walang::TraceScope scope{tracer.get(), "run"};
+    try {
+      // instantiation executes `_start`
+      walang::binaryen::Runner runner{compiler.module(), std::cout};
+      if (invoke.has_value()) {
+        std::vector<std::string> values{};
+        std::istringstream valueStream{invokeArguments.value_or("")};
+        for (std::string value; std::getline(valueStream, value, ',');) {
+          values.push_back(value);
+        }
+        for (std::string const &result : runner.invoke(invoke.value(), values)) {
+          std::cout << result << "\n";
+        }
+      }
+      if (instrumentOptions.enabled()) {
+        walang::Profile profile = walang::Profile::collect(compiler.module(), runner);
+        if (profileOutPath.has_value()) {
+          std::ofstream profileFile{profileOutPath.value()};
+          if (!profileFile.is_open()) {
+            std::cerr << "profile path invalid " << profileOutPath.value() << std::endl;
+            std::exit(-1);
+          }
+          profile.write(profileFile);
+        } else {
+          profile.writeReport(std::cerr);
+        }
+      }
+    } catch (std::exception const &e) {
+      std::cerr << fmt::format("Run Failed:\n{}", fmt::styled(e.what(), fmt::fg(fmt::color::orange))) << "\n";
+      std::exit(-1);
+    }
+  }
+
+  writeTrace(tracer.get(), timePasses, tracePath);
+  if (statsPath.has_value()) {
+    std::ofstream statsFile{statsPath.value()};
+    if (!statsFile.is_open()) {
+      std::cerr << "stats path invalid " << statsPath.value() << std::endl;
+      std::exit(-1);
+    }
+    statistics.writeJson(statsFile);
   }
 }
\ No newline at end of file
@@ -2,25 +2,37 @@
 #include "ast/expression.hpp"
 #include "ast/statement.hpp"
 #include "binaryen/utils.hpp"
+#include "declaration_preparer.hpp"
 #include "helper/diagnose.hpp"
+#include "helper/hash.hpp"
 #include "helper/overload.hpp"
-#include "helper/redefined_checker.hpp"
+#include "helper/thread_pool.hpp"
+#include "helper/trace.hpp"
 #include "ir/variant.hpp"
 #include "ir/variant_type.hpp"
 #include "resolver.hpp"
 #include "variant_type_table.hpp"
+#include "wasm.h"
 #include <algorithm>
 #include <array>
 #include <binaryen-c.h>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <cstdlib>
 #include <exception>
 #include <fmt/core.h>
+#include <future>
 #include <iterator>
+#include <map>
 #include <memory>
+#include <optional>
+#include <ostream>
 #include <set>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -31,88 +43,316 @@ template <class T> static void concat(std::vector<T> &a, std::vector<T> const &b
   a.insert(a.end(), b.begin(), b.end());
 }
 
+static void hashFunctionDeclaration(Fnv1a &hash, ast::FunctionStatement const &statement) {
+  hash.update(statement.name()).update(statement.returnType().value_or(""));
+  hash.update(static_cast<uint64_t>(statement.arguments().size()));
+  for (auto const &argument : statement.arguments()) {
+    hash.update(argument.name_).update(argument.type_);
+  }
+  hash.update(static_cast<uint64_t>(statement.decorators().size()));
+  for (auto const &decorator : statement.decorators()) {
+    hash.update(decorator);
+  }
+}
+
+/// @brief collect identifiers, member names and declared types, a body can only observe symbols with these names
+static void collectNames(std::set<std::string> &names, ast::Expression const *expression) {
+  if (expression == nullptr) {
+    return;
+  }
+  switch (expression->type()) {
+  case ast::TypeIdentifier: {
+    auto const *name = std::get_if<std::string>(&static_cast<ast::Identifier const *>(expression)->identifier());
+    if (name != nullptr) {
+      names.insert(*name);
+    }
+    break;
+  }
+  case ast::TypePrefixExpression:
+    collectNames(names, static_cast<ast::PrefixExpression const *>(expression)->expr());
+    break;
+  case ast::TypeBinaryExpression:
+    collectNames(names, static_cast<ast::BinaryExpression const *>(expression)->leftExpr());
+    collectNames(names, static_cast<ast::BinaryExpression const *>(expression)->rightExpr());
+    break;
+  case ast::TypeTernaryExpression:
+    collectNames(names, static_cast<ast::TernaryExpression const *>(expression)->conditionExpr());
+    collectNames(names, static_cast<ast::TernaryExpression const *>(expression)->leftExpr());
+    collectNames(names, static_cast<ast::TernaryExpression const *>(expression)->rightExpr());
+    break;
+  case ast::TypeCallExpression:
+    collectNames(names, static_cast<ast::CallExpression const *>(expression)->caller());
+    for (ast::Expression const *argument : static_cast<ast::CallExpression const *>(expression)->arguments()) {
+      collectNames(names, argument);
+    }
+    break;
+  case ast::TypeMemberExpression:
+    names.insert(static_cast<ast::MemberExpression const *>(expression)->member());
+    collectNames(names, static_cast<ast::MemberExpression const *>(expression)->expr());
+    break;
+  }
+}
+static void collectNames(std::set<std::string> &names, ast::Statement const *statement) {
+  if (statement == nullptr) {
+    return;
+  }
+  switch (statement->type()) {
+  case ast::TypeDeclareStatement:
+    names.insert(static_cast<ast::DeclareStatement const *>(statement)->variantType());
+    collectNames(names, static_cast<ast::DeclareStatement const *>(statement)->init());
+    break;
+  case ast::TypeAssignStatement:
+    collectNames(names, static_cast<ast::AssignStatement const *>(statement)->variant());
+    collectNames(names, static_cast<ast::AssignStatement const *>(statement)->value());
+    break;
+  case ast::TypeExpressionStatement:
+    collectNames(names, static_cast<ast::ExpressionStatement const *>(statement)->expr());
+    break;
+  case ast::TypeBlockStatement:
+    for (ast::Statement const *child : static_cast<ast::BlockStatement const *>(statement)->statements()) {
+      collectNames(names, child);
+    }
+    break;
+  case ast::TypeIfStatement:
+    collectNames(names, static_cast<ast::IfStatement const *>(statement)->condition());
+    collectNames(names, static_cast<ast::IfStatement const *>(statement)->thenBlock());
+    collectNames(names, static_cast<ast::IfStatement const *>(statement)->elseBlock());
+    break;
+  case ast::TypeWhileStatement:
+    collectNames(names, static_cast<ast::WhileStatement const *>(statement)->condition());
+    collectNames(names, static_cast<ast::WhileStatement const *>(statement)->block());
+    break;
+  case ast::TypeReturnStatement:
+    collectNames(names, static_cast<ast::ReturnStatement const *>(statement)->expr());
+    break;
+  case ast::TypeFunctionStatement:
+  case ast::TypeClassStatement:
+  case ast::TypeBreakStatement:
+  case ast::TypeContinueStatement:
+    break;
+  }
+}
+
 Compiler::Compiler(std::vector<std::shared_ptr<ast::File>> files)
     : module_{BinaryenModuleCreate()}, files_{std::move(files)}, variantTypeMap_{std::make_shared<VariantTypeMap>()},
       resolver_(variantTypeMap_) {
   BinaryenMemoryRef a;
-  BinaryenSetMemory(module_, 0, 1, nullptr, nullptr, nullptr, nullptr, nullptr, 0, false, false, "0");
+  BinaryenSetMemory(module_, 1, 1, nullptr, nullptr, nullptr, nullptr, nullptr, 0, false, false, "0");
 }
+Compiler::Compiler(Compiler const &parent, std::size_t visibleGlobalCount)
+    : module_{parent.module_}, ownsModule_{false}, variantTypeMap_{parent.variantTypeMap_},
+      resolver_{parent.resolver_.createView(nullptr, visibleGlobalCount)}, startFunction_{parent.startFunction_},
+      tracer_{parent.tracer_}, instrumentOptions_{parent.instrumentOptions_},
+      profileCounters_{parent.profileCounters_}, debugInfo_{parent.debugInfo_}, debugFiles_{parent.debugFiles_},
+      multivalue_{parent.multivalue_}, bulkMemory_{parent.bulkMemory_}, stackLimit_{parent.stackLimit_} {}
 
 void Compiler::compile() {
-  for (auto const &file : files_) {
-    // prepare
-    std::vector<ast::ClassStatement *> pendingClasses{};
-    for (auto &statement : file->statement()) {
-      if (statement->type() == ast::TypeClassStatement) {
-        try {
-          prepareClassStatementLevel1(*std::dynamic_pointer_cast<ast::ClassStatement>(statement));
-        } catch (UnknownSymbol const &) {
-          pendingClasses.push_back(std::dynamic_pointer_cast<ast::ClassStatement>(statement).get());
+  TraceScope compileScope{tracer_.get(), "compile"};
+  if (instrumentOptions_.enabled()) {
+    // cached bodies would miss the counters registered during lowering
+    functionCache_ = nullptr;
+    profileCounters_ = std::make_shared<ProfileCounters>();
+  }
+  if (debugInfo_) {
+    // cache entries do not keep debug locations
+    functionCache_ = nullptr;
+    for (auto const &file : files_) {
+      debugFiles_.emplace(file.get(), BinaryenModuleAddDebugInfoFileName(module_, file->filename().c_str()));
+    }
+  }
+  if (multivalue_) {
+    BinaryenModuleSetFeatures(module_, BinaryenModuleGetFeatures(module_) | BinaryenFeatureMultivalue());
+  }
+  if (bulkMemory_) {
+    BinaryenModuleSetFeatures(module_, BinaryenModuleGetFeatures(module_) | BinaryenFeatureBulkMemory());
+  }
+  // prepare
+  DeclarationPreparer preparer{variantTypeMap_, tracer_.get()};
+  preparer.prepareClasses(
+      files_, [this](std::shared_ptr<ir::Class> const &classType) { compileClassConstructor(classType); });
+  {
+    // before methods are declared, inferred readonly methods take `this` by value like `@readonly` methods
+    TraceScope scope{tracer_.get(), "infer readonly methods"};
+    inferReadonlyMethods();
+  }
+  preparer.prepareFunctions(files_, [this](DeclarationPreparer::FunctionDeclaration const &declaration) {
+    return doPrepareFunction(declaration);
+  });
+  if (!instrumentOptions_.enabled()) {
+    // counters of inlined calls would never be hit
+    TraceScope scope{tracer_.get(), "select inline functions"};
+    selectInlineFunctions();
+  }
+  if (shadowStack_) {
+    // workers lowering in parallel cannot add globals
+    BinaryenAddGlobal(module_, stackPointerGlobal, BinaryenTypeInt32(), true,
+                      BinaryenConst(module_, BinaryenLiteralInt32(stackBase)));
+    // a returned class followed by a receiver written back is the most a call stores at the start of memory
+    uint32_t maxClassSize = 0U;
+    for (auto const &file : files_) {
+      for (auto const &statement : file->statement()) {
+        if (statement->type() == ast::TypeClassStatement) {
+          auto classType = std::dynamic_pointer_cast<ir::Class>(
+              variantTypeMap_->findVariantType(static_cast<ast::ClassStatement const *>(statement)->name()));
+          maxClassSize = std::max(maxClassSize, classType->layout().size_);
         }
       }
     }
-    fmt::print("pendingClasses1 {}\n", pendingClasses.size());
-    bool isResolved = true;
-    while (!pendingClasses.empty() && isResolved) {
-      fmt::print("pendingClasses2 {}\n", pendingClasses.size());
-      isResolved = false;
-      std::vector<ast::ClassStatement *> currentPendingClasses{};
-      std::swap(currentPendingClasses, pendingClasses);
-      for (auto &pendingClass : currentPendingClasses) {
-        try {
-          prepareClassStatementLevel1(*pendingClass);
-        } catch (UnknownSymbol const &) {
-          pendingClasses.push_back(pendingClass);
-          continue;
-        }
-        isResolved = true;
+    stackLimit_ = static_cast<int32_t>(2U * maxClassSize);
+  }
+  // compile, top level statements of all files are executed in file order by one start function
+  startFunction_ = std::make_shared<ir::Function>(
+      "_start", std::vector<std::string>{}, std::vector<std::shared_ptr<ir::VariantType>>{},
+      variantTypeMap_->findVariantType("void"), std::set<ir::Function::Flag>{}, module_);
+  currentFunction_.push(startFunction_);
+  resolver_.setCurrentFunction(currentFunction());
+  std::vector<BinaryenExpressionRef> expressions{};
+  {
+    TraceScope scope{tracer_.get(), "lower statements"};
+    for (auto const &file : files_) {
+      for (auto &statement : file->statement()) {
+        concat(expressions, compileStatement(statement));
       }
     }
-    fmt::print("pendingClasses3 {}\n", pendingClasses.size());
-    for (auto pendingClass : pendingClasses) {
-      prepareClassStatementLevel1(*pendingClass);
+  }
+  compilePendingFunctions();
+  BinaryenExpressionRef body = BinaryenBlock(module_, nullptr, expressions.data(), expressions.size(),
+                                             startFunction_->signature()->returnType()->underlyingType());
+  BinaryenFunctionRef startFunctionRef = finalizeFunction(startFunction_, body);
+  BinaryenSetStart(module_, startFunctionRef);
+  if (profileCounters_ != nullptr) {
+    profileCounters_->finalize(module_);
+  }
+}
+void Compiler::compilePendingFunctions() {
+  if (pendingFunctions_.empty()) {
+    return;
+  }
+  TraceScope scope{tracer_.get(), "lower functions in parallel"};
+  std::vector<BinaryenExpressionRef> bodies(pendingFunctions_.size(), nullptr);
+  {
+    ThreadPool pool{std::min(threads_, static_cast<uint32_t>(pendingFunctions_.size()))};
+    std::vector<std::future<BinaryenExpressionRef>> pendingBodies{};
+    pendingBodies.reserve(pendingFunctions_.size());
+    for (auto const &pendingFunction : pendingFunctions_) {
+      if (pendingFunction.cacheKey_.has_value() && functionCache_->contains(pendingFunction.cacheKey_.value())) {
+        pendingBodies.emplace_back();
+        continue;
+      }
+      pendingBodies.push_back(pool.submit([this, &pendingFunction] {
+        Compiler worker{*this, pendingFunction.visibleGlobalCount_};
+        return worker.lowerFunctionBody(pendingFunction.function_, pendingFunction.body_);
+      }));
     }
-
-    for (auto &statement : file->statement()) {
-      if (statement->type() == ast::TypeFunctionStatement) {
-        prepareFunctionStatement(*std::dynamic_pointer_cast<ast::FunctionStatement>(statement));
+    // report the error of the first function in declaration order, independent of scheduling
+    for (std::size_t index = 0; index < pendingBodies.size(); index++) {
+      if (pendingBodies[index].valid()) {
+        bodies[index] = pendingBodies[index].get();
       }
     }
-    for (auto &statement : file->statement()) {
-      if (statement->type() == ast::TypeClassStatement) {
-        prepareClassStatementLevel2(*std::dynamic_pointer_cast<ast::ClassStatement>(statement));
+  }
+  // BinaryenAddFunction is not thread safe, commit in declaration order to keep the output stable
+  for (std::size_t index = 0; index < pendingFunctions_.size(); index++) {
+    auto const &pendingFunction = pendingFunctions_[index];
+    auto const &name = pendingFunction.function_->name();
+    if (bodies[index] == nullptr) {
+      if (functionCache_->load(module_, name, pendingFunction.cacheKey_.value())) {
+        continue;
       }
+      // entry disappeared or is broken, lower it again
+      Compiler worker{*this, pendingFunction.visibleGlobalCount_};
+      bodies[index] = worker.lowerFunctionBody(pendingFunction.function_, pendingFunction.body_);
     }
-    // compile
-    startFunction_ = std::make_shared<ir::Function>(
-        "_start", std::vector<std::string>{}, std::vector<std::shared_ptr<ir::VariantType>>{},
-        variantTypeMap_->findVariantType("void"), std::set<ir::Function::Flag>{}, module_);
-    currentFunction_.push(startFunction_);
-    resolver_.setCurrentFunction(currentFunction());
-    std::vector<BinaryenExpressionRef> expressions{};
-    for (auto &statement : file->statement()) {
-      concat(expressions, compileStatement(statement));
+    finalizeFunction(pendingFunction.function_, bodies[index]);
+    if (pendingFunction.cacheKey_.has_value()) {
+      functionCache_->store(module_, name, pendingFunction.cacheKey_.value());
     }
-    BinaryenExpressionRef body = BinaryenBlock(module_, nullptr, expressions.data(), expressions.size(),
-                                               startFunction_->signature()->returnType()->underlyingType());
-    BinaryenFunctionRef startFunctionRef = startFunction_->finalize(module_, body);
-    BinaryenSetStart(module_, startFunctionRef);
   }
+  pendingFunctions_.clear();
 }
+BinaryenExpressionRef Compiler::lowerFunctionBody(std::shared_ptr<ir::Function> const &function,
+                                                  ast::BlockStatement const *body) {
+  TraceScope scope{tracer_.get(), "lower function", function->name()};
+  currentFunction_.push(function);
+  resolver_.setCurrentFunction(currentFunction());
+  std::vector<BinaryenExpressionRef> bodyRefs{};
+  if (instrumentOptions_.calls_) {
+    bodyRefs.push_back(profileCounters_->increment(module_, Profile::Kind::Call, function->name()));
+  }
+  concat(bodyRefs, compileBlockStatement(body));
+  BinaryenExpressionRef bodyRef = binaryen::Utils::combineExprRef(module_, bodyRefs);
+  currentFunction_.pop();
+  resolver_.setCurrentFunction(currentFunction_.empty() ? nullptr : currentFunction());
+  return bodyRef;
+}
+void Compiler::addDebugLocation(std::vector<BinaryenExpressionRef> const &exprRefs, ast::Range const &range) {
+  if (!debugInfo_ || currentFunction_.empty()) {
+    return;
+  }
+  auto it = debugFiles_.find(range.file());
+  if (it == debugFiles_.end()) {
+    return;
+  }
+  for (BinaryenExpressionRef exprRef : exprRefs) {
+    currentFunction()->addDebugLocation(exprRef, it->second, range.start());
+  }
+}
+BinaryenFunctionRef Compiler::finalizeFunction(std::shared_ptr<ir::Function> const &function,
+                                              BinaryenExpressionRef body) {
+  TraceScope scope{tracer_.get(), "finalize function", function->name()};
+  return function->finalize(module_, body);
+}
+
 std::string Compiler::wat() const {
+  std::ostringstream watStream{};
+  writeWat(watStream);
+  return watStream.str();
+}
+void Compiler::writeWat(std::ostream &os) const {
   BinaryenSetColorsEnabled(false);
-  std::string watBuf{};
-  watBuf.resize(1024 * 1024);
-  while (true) {
-    uint32_t size = BinaryenModuleWriteText(module_, watBuf.data(), watBuf.size());
-    if (size == watBuf.size()) {
-      watBuf.resize(watBuf.size() * 2);
-    } else {
-      watBuf.resize(size);
-      break;
+  os << *reinterpret_cast<wasm::Module *>(module_);
+}
+void Compiler::writeWasm(std::ostream &os) const {
+  BinaryenModuleAllocateAndWriteResult result = BinaryenModuleAllocateAndWrite(module_, nullptr);
+  os.write(static_cast<char const *>(result.binary), static_cast<std::streamsize>(result.binaryBytes));
+  std::free(result.binary);
+}
+void Compiler::writeWasm(std::ostream &os, std::string const &sourceMapUrl, std::ostream &sourceMap) const {
+  BinaryenModuleAllocateAndWriteResult result = BinaryenModuleAllocateAndWrite(module_, sourceMapUrl.c_str());
+  os.write(static_cast<char const *>(result.binary), static_cast<std::streamsize>(result.binaryBytes));
+  std::free(result.binary);
+  if (result.sourceMap != nullptr) {
+    sourceMap << result.sourceMap;
+    std::free(result.sourceMap);
+  }
+}
+void Compiler::collectStatistics(Statistics &statistics) const {
+  statistics.collectAst(files_);
+  statistics.collectModule(module_);
+  std::map<std::string, uint32_t> tempLocals{{startFunction_->name(), startFunction_->tempLocalCount()}};
+  for (auto const &[name, function] : resolver_.functions()) {
+    tempLocals.emplace(function->name(), function->tempLocalCount());
+  }
+  for (auto &function : statistics.functions_) {
+    auto it = tempLocals.find(function.name_);
+    if (it != tempLocals.end()) {
+      function.tempLocals_ = it->second;
     }
   }
-  return watBuf;
+  for (auto const &file : files_) {
+    for (auto &statement : file->statement()) {
+      if (statement->type() == ast::TypeClassStatement) {
+        auto const &name = static_cast<ast::ClassStatement const *>(statement)->name();
+        auto classType = std::dynamic_pointer_cast<ir::Class>(variantTypeMap_->findVariantType(name));
+        statistics.classes_.push_back(Statistics::ClassStatistics{
+            name, classType->layout().size_, static_cast<uint32_t>(classType->layout().types_.size())});
+      }
+    }
+  }
+  for (auto const &method : readonlyInference_.methods()) {
+    statistics.methods_.push_back(
+        Statistics::MethodStatistics{method.name_, ReadonlyInference::resultName(method.result_)});
+  }
 }
 
 // ██████  ██████  ███████ ██████   █████  ██████  ███████
@@ -121,97 +361,69 @@ std::string Compiler::wat() const {
 // ██      ██   ██ ██      ██      ██   ██ ██   ██ ██
 // ██      ██   ██ ███████ ██      ██   ██ ██   ██ ███████
 
-void Compiler::prepareFunctionStatement(ast::FunctionStatement const &statement) {
-  std::vector<std::string> argumentNames{};
-  std::vector<std::shared_ptr<ir::VariantType>> argumentTypes{};
-  for (auto const &argument : statement.arguments()) {
-    argumentNames.push_back(argument.name_);
-    argumentTypes.push_back(variantTypeMap_->findVariantType(argument.type_));
-  }
-  std::shared_ptr<ir::VariantType> returnType;
-  if (statement.returnType().has_value()) {
-    returnType = variantTypeMap_->findVariantType(statement.returnType().value());
-  } else {
-    throw std::runtime_error("not support " __FILE__ "#" + std::to_string(__LINE__));
-  }
-  doPrepareFunction(statement.name(), argumentNames, argumentTypes, returnType, nullptr, statement.decorators());
-}
-std::shared_ptr<ir::Function> Compiler::prepareMethod(ast::FunctionStatement const &statement,
-                                                      std::shared_ptr<ir::Class> const &classType) {
-  std::vector<std::string> argumentNames{};
-  std::vector<std::shared_ptr<ir::VariantType>> argumentTypes{};
-  for (auto const &argument : statement.arguments()) {
-    argumentNames.emplace_back(argument.name_);
-    argumentTypes.emplace_back(variantTypeMap_->findVariantType(argument.type_));
+std::shared_ptr<ir::Function> Compiler::doPrepareFunction(DeclarationPreparer::FunctionDeclaration const &declaration) {
+  std::set<ir::Function::Flag> flags = functionFlags();
+  flags.insert(declaration.flags_.begin(), declaration.flags_.end());
+  if (readonlyInference_.isInferred(declaration.name_)) {
+    flags.insert(ir::Function::Flag::Readonly);
   }
-  std::shared_ptr<ir::VariantType> returnType;
-  if (statement.returnType().has_value()) {
-    returnType = variantTypeMap_->findVariantType(statement.returnType().value());
-  } else {
-    throw std::runtime_error("not support " __FILE__ "#" + std::to_string(__LINE__));
+  if (declaration.classType_ != nullptr && flags.count(ir::Function::Flag::Readonly) == 0 &&
+      declaration.classType_->passReceiverByReference()) {
+    flags.insert(ir::Function::Flag::ReferenceReceiver);
+    shadowStack_ = true;
   }
-  return doPrepareFunction(classType->className() + "#" + statement.name(), argumentNames, argumentTypes, returnType,
-                           classType, statement.decorators());
+  auto functionIr = std::make_shared<ir::Function>(declaration.name_, declaration.argumentNames_,
+                                                   declaration.argumentTypes_, declaration.returnType_, flags, module_);
+  resolver_.addFunction(declaration.name_, functionIr);
+  return functionIr;
 }
 
-std::shared_ptr<ir::Function> Compiler::doPrepareFunction(std::string const &name,
-                                                          std::vector<std::string> argumentNames,
-                                                          std::vector<std::shared_ptr<ir::VariantType>> argumentTypes,
-                                                          std::shared_ptr<ir::VariantType> const &returnType,
-                                                          std::shared_ptr<ir::Class> const &classType,
-                                                          std::vector<std::string> const &decorators) {
+std::set<ir::Function::Flag> Compiler::functionFlags() const {
   std::set<ir::Function::Flag> flags{};
-  if (std::count(decorators.begin(), decorators.end(), "readonly") > 0) {
-    if (classType == nullptr) {
-      throw ErrorDecorator{"readonly"};
-    }
-    flags.insert(ir::Function::Flag::Readonly);
-  }
-  if (classType != nullptr) {
-    argumentNames.emplace_back("this");
-    argumentTypes.emplace_back(classType);
-    flags.insert(ir::Function::Flag::Method);
+  if (multivalue_) {
+    flags.insert(ir::Function::Flag::Multivalue);
   }
-  auto functionIr = std::make_shared<ir::Function>(name, argumentNames, argumentTypes, returnType, flags, module_);
-  resolver_.addFunction(name, functionIr);
-  return functionIr;
+  return flags;
 }
 
-void Compiler::prepareClassStatementLevel1(ast::ClassStatement const &statement) {
-  // re-define check
-  RedefinedChecker redefinedChecker{};
-  for (auto const &member : statement.members()) {
-    redefinedChecker.check(member.name_);
-  }
-  for (auto const &method : statement.methods()) {
-    redefinedChecker.check(method->name());
-  }
-  std::vector<ir::Class::ClassMember> members{};
-  members.reserve(statement.members().size());
-  for (auto const &member : statement.members()) {
-    if (member.type_ == statement.name()) {
-      auto e = RecursiveDefinedSymbol(member.type_);
-      e.setRange(statement.range());
-      throw e;
-    }
-    members.push_back(ir::Class::ClassMember{.memberName_ = member.name_,
-                                             .memberType_ = variantTypeMap_->findVariantType(member.type_)});
+void Compiler::inferReadonlyMethods() {
+  for (auto const &file : files_) {
+    for (auto &statement : file->statement()) {
+      if (statement->type() == ast::TypeClassStatement) {
+        auto const &classStatement = *static_cast<ast::ClassStatement const *>(statement);
+        auto classType = std::dynamic_pointer_cast<ir::Class>(variantTypeMap_->findVariantType(classStatement.name()));
+        readonlyInference_.addClass(classStatement, classType);
+      }
+    }
+  }
+  readonlyInference_.run();
+  for (auto const &method : readonlyInference_.methods()) {
+    if (method.result_ == ReadonlyInference::Result::Violated) {
+      warnings_.push_back(
+          fmt::format("readonly method {0} modifies this\n\t{1}", method.name_, method.modification_.value()));
+    }
   }
-
-  auto classType = std::make_shared<ir::Class>(statement.name());
-  variantTypeMap_->registerType(statement.name(), classType);
-
-  classType->setMembers(members);
-  compileClassConstructor(classType);
 }
-void Compiler::prepareClassStatementLevel2(ast::ClassStatement const &statement) {
-  auto classType = std::dynamic_pointer_cast<ir::Class>(variantTypeMap_->findVariantType(statement.name()));
-  assert(classType != nullptr);
-  std::map<std::string, std::shared_ptr<ir::Function>> methodMap{};
-  for (auto const &method : statement.methods()) {
-    methodMap.insert(std::make_pair(method->name(), prepareMethod(*method, classType)));
+void Compiler::selectInlineFunctions() {
+  auto selectInlineFunction = [this](std::string const &name, ast::FunctionStatement const &statement) {
+    if (!inliner_.addFunction(statement, resolver_.functions().at(name))) {
+      warnings_.push_back(fmt::format("inline function {0} does not only return an expression of its arguments\n\t{1}",
+                                      name, statement.range()));
+    }
+  };
+  for (auto const &file : files_) {
+    for (auto &statement : file->statement()) {
+      if (statement->type() == ast::TypeFunctionStatement) {
+        auto const &functionStatement = *static_cast<ast::FunctionStatement const *>(statement);
+        selectInlineFunction(functionStatement.name(), functionStatement);
+      } else if (statement->type() == ast::TypeClassStatement) {
+        auto const &classStatement = *static_cast<ast::ClassStatement const *>(statement);
+        for (ast::FunctionStatement const *method : classStatement.methods()) {
+          selectInlineFunction(classStatement.name() + "#" + method->name(), *method);
+        }
+      }
+    }
   }
-  classType->setMethodMap(methodMap);
 }
 
 // ███████ ████████  █████  ████████ ███████ ███    ███ ███████ ███    ██ ████████
@@ -220,43 +432,47 @@ void Compiler::prepareClassStatementLevel2(ast::ClassStatement const &statement)
 //      ██    ██    ██   ██    ██    ██      ██  ██  ██ ██      ██  ██ ██    ██
 // ███████    ██    ██   ██    ██    ███████ ██      ██ ███████ ██   ████    ██
 
-std::vector<BinaryenExpressionRef> Compiler::compileStatement(std::shared_ptr<ast::Statement> const &statement) {
+std::vector<BinaryenExpressionRef> Compiler::compileStatement(ast::Statement const *statement) {
+  std::vector<BinaryenExpressionRef> exprRefs = doCompileStatement(statement);
+  addDebugLocation(exprRefs, statement->range());
+  return exprRefs;
+}
+std::vector<BinaryenExpressionRef> Compiler::doCompileStatement(ast::Statement const *statement) {
   try {
     switch (statement->type()) {
     case ast::StatementType::TypeDeclareStatement:
-      return compileDeclareStatement(std::dynamic_pointer_cast<ast::DeclareStatement>(statement));
+      return compileDeclareStatement(static_cast<ast::DeclareStatement const *>(statement));
     case ast::StatementType::TypeAssignStatement:
-      return compileAssignStatement(std::dynamic_pointer_cast<ast::AssignStatement>(statement));
+      return compileAssignStatement(static_cast<ast::AssignStatement const *>(statement));
     case ast::StatementType::TypeExpressionStatement:
-      return compileExpressionStatement(std::dynamic_pointer_cast<ast::ExpressionStatement>(statement));
+      return compileExpressionStatement(static_cast<ast::ExpressionStatement const *>(statement));
     case ast::StatementType::TypeBlockStatement:
-      return compileBlockStatement(std::dynamic_pointer_cast<ast::BlockStatement>(statement));
+      return compileBlockStatement(static_cast<ast::BlockStatement const *>(statement));
     case ast::StatementType::TypeIfStatement:
-      return compileIfStatement(std::dynamic_pointer_cast<ast::IfStatement>(statement));
+      return compileIfStatement(static_cast<ast::IfStatement const *>(statement));
     case ast::StatementType::TypeWhileStatement:
-      return compileWhileStatement(std::dynamic_pointer_cast<ast::WhileStatement>(statement));
+      return compileWhileStatement(static_cast<ast::WhileStatement const *>(statement));
     case ast::StatementType::TypeBreakStatement:
-      return compileBreakStatement(std::dynamic_pointer_cast<ast::BreakStatement>(statement));
+      return compileBreakStatement(static_cast<ast::BreakStatement const *>(statement));
     case ast::StatementType::TypeContinueStatement:
-      return compileContinueStatement(std::dynamic_pointer_cast<ast::ContinueStatement>(statement));
+      return compileContinueStatement(static_cast<ast::ContinueStatement const *>(statement));
     case ast::StatementType::TypeFunctionStatement:
-      return compileFunctionStatement(std::dynamic_pointer_cast<ast::FunctionStatement>(statement));
+      return compileFunctionStatement(static_cast<ast::FunctionStatement const *>(statement));
     case ast::StatementType::TypeClassStatement:
-      return compileClassStatement(std::dynamic_pointer_cast<ast::ClassStatement>(statement));
+      return compileClassStatement(static_cast<ast::ClassStatement const *>(statement));
     case ast::TypeReturnStatement:
-      return compileReturnStatement(std::dynamic_pointer_cast<ast::ReturnStatement>(statement));
+      return compileReturnStatement(static_cast<ast::ReturnStatement const *>(statement));
     }
   } catch (CompilerErrorBase &e) {
     e.setRangeAndThrow(statement->range());
   }
   throw std::runtime_error("not support " __FILE__ "#" + std::to_string(__LINE__));
 }
-std::vector<BinaryenExpressionRef>
-Compiler::compileDeclareStatement(std::shared_ptr<ast::DeclareStatement> const &statement) {
+std::vector<BinaryenExpressionRef> Compiler::compileDeclareStatement(ast::DeclareStatement const *statement) {
   std::shared_ptr<ir::VariantType> const &variantType =
       statement->variantType().empty() ? resolver_.resolveTypeExpression(statement->init())
                                        : variantTypeMap_->findVariantType(statement->variantType());
-  auto initVariant = compileExpression(statement->init(), variantType);
+  auto initVariant = compileInitializer(statement->init(), variantType);
   walang::ir::Variant const *assignedVariant;
   if (currentFunction() == startFunction_) {
     // in global
@@ -271,10 +487,9 @@ Compiler::compileDeclareStatement(std::shared_ptr<ast::DeclareStatement> const &
   }
   return initVariant->assignTo(module_, assignedVariant);
 }
-std::vector<BinaryenExpressionRef>
-Compiler::compileAssignStatement(std::shared_ptr<ast::AssignStatement> const &statement) {
+std::vector<BinaryenExpressionRef> Compiler::compileAssignStatement(ast::AssignStatement const *statement) {
   auto assignedVariant = resolver_.resolveExpression(statement->variant());
-  auto valueVariant = compileExpression(statement->value(), assignedVariant->variantType());
+  auto valueVariant = compileInitializer(statement->value(), assignedVariant->variantType());
   switch (assignedVariant->type()) {
   case ir::Symbol::Type::TypeGlobal:
   case ir::Symbol::Type::TypeLocal:
@@ -287,8 +502,7 @@ Compiler::compileAssignStatement(std::shared_ptr<ast::AssignStatement> const &st
   }
   throw std::runtime_error("not support " __FILE__ "#" + std::to_string(__LINE__));
 }
-std::vector<BinaryenExpressionRef>
-Compiler::compileExpressionStatement(std::shared_ptr<ast::ExpressionStatement> const &statement) {
+std::vector<BinaryenExpressionRef> Compiler::compileExpressionStatement(ast::ExpressionStatement const *statement) {
   auto expectedType = std::make_shared<ir::TypeAuto>();
   auto valueVariant = compileExpressionToExpressionRef(statement->expr(), expectedType);
   if (expectedType->underlyingType() != BinaryenTypeNone()) {
@@ -297,16 +511,16 @@ Compiler::compileExpressionStatement(std::shared_ptr<ast::ExpressionStatement> c
     return {valueVariant};
   }
 }
-std::vector<BinaryenExpressionRef>
-Compiler::compileBlockStatement(std::shared_ptr<ast::BlockStatement> const &statement) {
+std::vector<BinaryenExpressionRef> Compiler::compileBlockStatement(ast::BlockStatement const *statement) {
   std::vector<BinaryenExpressionRef> statementRefs{};
-  auto statements = statement->statements();
-  for (auto &statement : statements) {
-    concat(statementRefs, compileStatement(statement));
+  currentFunction()->enterScope();
+  for (ast::Statement const *child : statement->statements()) {
+    concat(statementRefs, compileStatement(child));
   }
+  currentFunction()->exitScope();
   return {BinaryenBlock(module_, nullptr, statementRefs.data(), statementRefs.size(), BinaryenTypeNone())};
 }
-std::vector<BinaryenExpressionRef> Compiler::compileIfStatement(std::shared_ptr<ast::IfStatement> const &statement) {
+std::vector<BinaryenExpressionRef> Compiler::compileIfStatement(ast::IfStatement const *statement) {
   BinaryenExpressionRef condition =
       compileExpressionToExpressionRef(statement->condition(), std::make_shared<ir::TypeCondition>());
   BinaryenExpressionRef ifTrue =
@@ -317,8 +531,7 @@ std::vector<BinaryenExpressionRef> Compiler::compileIfStatement(std::shared_ptr<
           : binaryen::Utils::combineExprRef(module_, compileStatement(statement->elseBlock()));
   return {BinaryenIf(module_, condition, ifTrue, ifElse)};
 }
-std::vector<BinaryenExpressionRef>
-Compiler::compileWhileStatement(std::shared_ptr<ast::WhileStatement> const &statement) {
+std::vector<BinaryenExpressionRef> Compiler::compileWhileStatement(ast::WhileStatement const *statement) {
   /**
     loop A (
       if (
@@ -334,7 +547,16 @@ Compiler::compileWhileStatement(std::shared_ptr<ast::WhileStatement> const &stat
   auto continueLabel = currentFunction()->createContinueLabel("while");
   BinaryenExpressionRef condition =
       compileExpressionToExpressionRef(statement->condition(), std::make_shared<ir::TypeCondition>());
+  if (instrumentOptions_.loops_) {
+    // 1 based column as in diagnostics
+    loopCounters_.push_back(fmt::format("{}@{}:{}", currentFunction()->name(), statement->range().start().line,
+                                        statement->range().start().column + 1U));
+  }
   std::vector<BinaryenExpressionRef> block = compileBlockStatement(statement->block());
+  if (instrumentOptions_.loops_) {
+    block.push_back(profileCounters_->increment(module_, Profile::Kind::Loop, loopCounters_.back()));
+    loopCounters_.pop_back();
+  }
   block.push_back(BinaryenBreak(module_, continueLabel.c_str(), nullptr, nullptr));
   BinaryenExpressionRef body = BinaryenIf(
       module_, condition, BinaryenBlock(module_, nullptr, block.data(), block.size(), BinaryenTypeNone()), nullptr);
@@ -343,22 +565,33 @@ Compiler::compileWhileStatement(std::shared_ptr<ast::WhileStatement> const &stat
   BinaryenExpressionRef loop = BinaryenLoop(module_, continueLabel.c_str(), body);
   return {BinaryenBlock(module_, breakLabel.c_str(), &loop, 1U, BinaryenTypeNone())};
 }
-std::vector<BinaryenExpressionRef>
-Compiler::compileBreakStatement(std::shared_ptr<ast::BreakStatement> const &statement) {
+std::vector<BinaryenExpressionRef> Compiler::compileBreakStatement(ast::BreakStatement const *statement) {
   return {BinaryenBreak(module_, currentFunction()->topBreakLabel().c_str(), nullptr, nullptr)};
 }
-std::vector<BinaryenExpressionRef>
-Compiler::compileContinueStatement(std::shared_ptr<ast::ContinueStatement> const &statement) {
+std::vector<BinaryenExpressionRef> Compiler::compileContinueStatement(ast::ContinueStatement const *statement) {
+  if (instrumentOptions_.loops_) {
+    return {profileCounters_->increment(module_, Profile::Kind::Loop, loopCounters_.back()),
+            BinaryenBreak(module_, currentFunction()->topContinueLabel().c_str(), nullptr, nullptr)};
+  }
   return {BinaryenBreak(module_, currentFunction()->topContinueLabel().c_str(), nullptr, nullptr)};
 }
-std::vector<BinaryenExpressionRef>
-Compiler::compileReturnStatement(std::shared_ptr<ast::ReturnStatement> const &statement) {
+std::vector<BinaryenExpressionRef> Compiler::compileReturnStatement(ast::ReturnStatement const *statement) {
   auto signature = currentFunction()->signature();
   auto returnValue = compileExpression(statement->expr(), signature->returnType());
-  switch (signature->returnType()->underlyingReturnTypeStatus()) {
+  switch (currentFunction()->underlyingReturnTypeStatus()) {
   case ir::VariantType::UnderlyingReturnTypeStatus::None:
   case ir::VariantType::UnderlyingReturnTypeStatus::LoadFromMemory: {
-    auto exprRefs = returnValue->assignToMemory(module_, ir::MemoryData{0, signature->returnType()});
+    std::vector<BinaryenExpressionRef> exprRefs{};
+    auto callee = calledFunction(statement->expr());
+    if (callee != nullptr && callee->inlineExpression() == nullptr &&
+        callee->underlyingReturnTypeStatus() == ir::VariantType::UnderlyingReturnTypeStatus::LoadFromMemory) {
+      // callee has already stored the returned class at 0, drop the loads instead of storing them back
+      auto valueRefs = returnValue->assignToStack(module_);
+      auto const valueCount = static_cast<std::ptrdiff_t>(signature->returnType()->underlyingTypes().size());
+      exprRefs.assign(valueRefs.begin(), valueRefs.end() - valueCount);
+    } else {
+      exprRefs = returnValue->assignToMemory(module_, ir::MemoryData{0, signature->returnType()});
+    }
     auto returnExprRefs = currentFunction()->finalizeReturn(module_, BinaryenReturn(module_, nullptr));
     concat(exprRefs, returnExprRefs);
     return exprRefs;
@@ -369,35 +602,135 @@ Compiler::compileReturnStatement(std::shared_ptr<ast::ReturnStatement> const &st
         BinaryenReturn(module_, binaryen::Utils::combineExprRef(module_, returnValue->assignToStack(module_))));
     return exprRefs;
   }
+  case ir::VariantType::UnderlyingReturnTypeStatus::ByTuple: {
+    // values are the last expressions, expressions before them only have side effects
+    auto valueRefs = returnValue->assignToStack(module_);
+    auto const valueCount = static_cast<std::ptrdiff_t>(signature->returnType()->underlyingTypes().size());
+    std::vector<BinaryenExpressionRef> exprRefs{valueRefs.begin(), valueRefs.end() - valueCount};
+    std::vector<BinaryenExpressionRef> values{valueRefs.end() - valueCount, valueRefs.end()};
+    concat(exprRefs, currentFunction()->finalizeReturn(
+                         module_, BinaryenReturn(module_, BinaryenTupleMake(module_, values.data(), values.size()))));
+    return exprRefs;
+  }
   }
   throw std::runtime_error("not support " __FILE__ "#" + std::to_string(__LINE__));
 }
 
-std::vector<BinaryenExpressionRef>
-Compiler::compileFunctionStatement(std::shared_ptr<ast::FunctionStatement> const &statement) {
-  doCompileFunction(statement->name(), statement->body());
+std::vector<BinaryenExpressionRef> Compiler::compileFunctionStatement(ast::FunctionStatement const *statement) {
+  doCompileFunction(statement->name(), statement);
   return {};
 }
 std::shared_ptr<ir::Function> Compiler::compileClassMethod(std::shared_ptr<ir::Class> const &classType,
-                                                           std::shared_ptr<ast::FunctionStatement> const &statement) {
-  return doCompileFunction(classType->className() + "#" + statement->name(), statement->body());
+                                                           ast::FunctionStatement const *statement) {
+  return doCompileFunction(classType->className() + "#" + statement->name(), statement);
+}
+uint64_t Compiler::functionCacheKey(std::string const &name, ast::FunctionStatement const *statement) const {
+  Fnv1a hash{};
+  // bump the version when the lowering changes
+  hash.update("walang-function-cache-v5");
+  functionCache_->optimizeOptions().hash(hash);
+  hash.update(static_cast<uint64_t>(multivalue_));
+  hash.update(static_cast<uint64_t>(bulkMemory_));
+  hash.update(static_cast<uint64_t>(stackLimit_));
+  hash.update(name);
+  hashFunctionDeclaration(hash, *statement);
+  hash.update(statement->body()->to_string());
+  hashReferencedSymbols(hash, resolver_.functions().at(name), statement);
+  return hash.digest();
+}
+void Compiler::hashReferencedSymbols(Fnv1a &hash, std::shared_ptr<ir::Function> const &function,
+                                     ast::FunctionStatement const *statement) const {
+  std::set<std::string> names{};
+  collectNames(names, statement->body());
+  std::map<std::string, std::shared_ptr<ir::Function>> functions{};
+  std::map<std::string, std::shared_ptr<ir::Class>> classes{};
+  std::map<std::string, std::shared_ptr<ir::Global>> globals{};
+  bool changed = true;
+  auto addType = [&classes, &changed](std::shared_ptr<ir::VariantType> const &type) {
+    auto classType = std::dynamic_pointer_cast<ir::Class>(type);
+    if (classType != nullptr && classes.emplace(classType->className(), classType).second) {
+      changed = true;
+    }
+  };
+  // signatures, flags decided by the readonly inference and inlined bodies of callees shape the caller
+  auto addFunction = [&names, &functions, &changed, &addType](std::shared_ptr<ir::Function> const &callee) {
+    if (!functions.emplace(callee->name(), callee).second) {
+      return;
+    }
+    changed = true;
+    for (auto const &argumentType : callee->signature()->argumentTypes()) {
+      addType(argumentType);
+    }
+    addType(callee->signature()->returnType());
+    collectNames(names, callee->inlineExpression());
+  };
+  addFunction(function);
+  // names are resolved again when a callee brings the names of its inlined body or a class brings its methods
+  while (changed) {
+    changed = false;
+    for (std::string const &symbolName : std::set<std::string>{names}) {
+      if (auto it = resolver_.functions().find(symbolName); it != resolver_.functions().end()) {
+        addFunction(it->second);
+      }
+      if (auto it = resolver_.globals().find(symbolName); it != resolver_.globals().end()) {
+        globals.emplace(symbolName, it->second);
+        addType(it->second->variantType());
+      }
+      addType(variantTypeMap_->tryFindVariantType(symbolName));
+    }
+    for (auto const &[className, classType] : std::map<std::string, std::shared_ptr<ir::Class>>{classes}) {
+      for (auto const &member : classType->member()) {
+        addType(member.memberType_);
+      }
+      for (std::string const &symbolName : std::set<std::string>{names}) {
+        if (auto it = classType->methodMap().find(symbolName); it != classType->methodMap().end()) {
+          addFunction(it->second);
+        }
+      }
+    }
+  }
+  for (auto const &[functionName, callee] : functions) {
+    hash.update(functionName).update(callee->signature()->to_string());
+    hash.update(static_cast<uint64_t>(callee->flags().size()));
+    for (ir::Function::Flag flag : callee->flags()) {
+      hash.update(static_cast<uint64_t>(flag));
+    }
+    hash.update(callee->inlineExpression() == nullptr ? "" : callee->inlineExpression()->to_string());
+  }
+  for (auto const &[className, classType] : classes) {
+    hash.update(className).update(static_cast<uint64_t>(classType->member().size()));
+    for (auto const &member : classType->member()) {
+      hash.update(member.memberName_).update(member.memberType_->to_string());
+    }
+  }
+  for (auto const &[globalName, global] : globals) {
+    hash.update(globalName).update(global->variantType()->to_string());
+  }
 }
 std::shared_ptr<ir::Function> Compiler::doCompileFunction(std::string const &name,
-                                                          std::shared_ptr<ast::BlockStatement> const &body) {
+                                                          ast::FunctionStatement const *statement) {
   auto it = resolver_.functions().find(name);
   assert(it != resolver_.functions().end());
   auto functionIr = it->second;
-  currentFunction_.push(functionIr);
-  resolver_.setCurrentFunction(currentFunction());
-  BinaryenExpressionRef bodyRef = binaryen::Utils::combineExprRef(module_, compileBlockStatement(body));
-  currentFunction()->finalize(module_, bodyRef);
-  currentFunction_.pop();
-  resolver_.setCurrentFunction(currentFunction());
+  std::optional<uint64_t> cacheKey{};
+  if (functionCache_ != nullptr) {
+    cacheKey = functionCacheKey(name, statement);
+  }
+  if (threads_ > 1U) {
+    pendingFunctions_.push_back(PendingFunction{functionIr, statement->body(), resolver_.globalCount(), cacheKey});
+    return functionIr;
+  }
+  if (cacheKey.has_value() && functionCache_->load(module_, name, cacheKey.value())) {
+    return functionIr;
+  }
+  finalizeFunction(functionIr, lowerFunctionBody(functionIr, statement->body()));
+  if (cacheKey.has_value()) {
+    functionCache_->store(module_, name, cacheKey.value());
+  }
   return functionIr;
 }
 
-std::vector<BinaryenExpressionRef>
-Compiler::compileClassStatement(std::shared_ptr<ast::ClassStatement> const &statement) {
+std::vector<BinaryenExpressionRef> Compiler::compileClassStatement(ast::ClassStatement const *statement) {
   if (currentFunction() != startFunction_) {
     throw std::runtime_error("class should only be defined in top scope");
   }
@@ -410,30 +743,47 @@ Compiler::compileClassStatement(std::shared_ptr<ast::ClassStatement> const &stat
 }
 
 void Compiler::compileClassConstructor(std::shared_ptr<ir::Class> const &classType) {
+  auto flags = functionFlags();
+  flags.insert(ir::Function::Flag::Constructor);
   auto constructor = std::make_shared<ir::Function>(classType->className() + "#constructor", std::vector<std::string>{},
-                                                    std::vector<std::shared_ptr<ir::VariantType>>{}, classType,
-                                                    std::set<ir::Function::Flag>{}, module_);
+                                                    std::vector<std::shared_ptr<ir::VariantType>>{}, classType, flags,
+                                                    module_);
   BinaryenExpressionRef body;
-  switch (classType->underlyingReturnTypeStatus()) {
+  switch (constructor->underlyingReturnTypeStatus()) {
   case ir::VariantType::UnderlyingReturnTypeStatus::None:
     body = BinaryenBlock(module_, nullptr, nullptr, 0, BinaryenTypeNone());
     break;
-  case ir::VariantType::UnderlyingReturnTypeStatus::LoadFromMemory: {
-    std::vector<BinaryenExpressionRef> exprRef{};
-    for (auto underlyingType : classType->underlyingTypes()) {
-      exprRef.push_back(ir::VariantType::from(underlyingType)->underlyingDefaultValue(module_));
-    };
+  case ir::VariantType::UnderlyingReturnTypeStatus::LoadFromMemory:
+    if (classType->copyInBulk(module_)) {
+      auto size = static_cast<int32_t>(classType->layout().size_);
+      body = BinaryenMemoryFill(module_, BinaryenConst(module_, BinaryenLiteralInt32(0)),
+                                BinaryenConst(module_, BinaryenLiteralInt32(0)),
+                                BinaryenConst(module_, BinaryenLiteralInt32(size)), "0");
+      break;
+    }
     body = binaryen::Utils::combineExprRef(
-        module_, ir::StackData{exprRef, classType}.assignToMemory(module_, ir::MemoryData{0, classType}));
+        module_,
+        ir::StackData{defaultValues(classType), classType}.assignToMemory(module_, ir::MemoryData{0, classType}));
     break;
-  }
   case ir::VariantType::UnderlyingReturnTypeStatus::ByReturnValue:
     body = classType->underlyingDefaultValue(module_);
     break;
+  case ir::VariantType::UnderlyingReturnTypeStatus::ByTuple: {
+    std::vector<BinaryenExpressionRef> exprRef = defaultValues(classType);
+    body = BinaryenTupleMake(module_, exprRef.data(), exprRef.size());
+    break;
+  }
   }
-  constructor->finalize(module_, body);
+  finalizeFunction(constructor, body);
   resolver_.addFunction(classType->className(), constructor);
 }
+std::vector<BinaryenExpressionRef> Compiler::defaultValues(std::shared_ptr<ir::Class> const &classType) {
+  std::vector<BinaryenExpressionRef> exprRef{};
+  for (auto underlyingType : classType->underlyingTypes()) {
+    exprRef.push_back(ir::VariantType::from(underlyingType)->underlyingDefaultValue(module_));
+  }
+  return exprRef;
+}
 
 // ███████ ██   ██ ██████  ██████  ███████ ███████ ███████ ██  ██████  ███    ██
 // ██       ██ ██  ██   ██ ██   ██ ██      ██      ██      ██ ██    ██ ████   ██
@@ -441,34 +791,36 @@ void Compiler::compileClassConstructor(std::shared_ptr<ir::Class> const &classTy
 // ██       ██ ██  ██      ██   ██ ██           ██      ██ ██ ██    ██ ██  ██ ██
 // ███████ ██   ██ ██      ██   ██ ███████ ███████ ███████ ██  ██████  ██   ████
 
-BinaryenExpressionRef Compiler::compileExpressionToExpressionRef(std::shared_ptr<ast::Expression> const &expression,
+BinaryenExpressionRef Compiler::compileExpressionToExpressionRef(ast::Expression const *expression,
                                                                  std::shared_ptr<ir::VariantType> const &expectedType) {
 
   return binaryen::Utils::combineExprRef(module_, compileExpressionToExpressionRefs(expression, expectedType));
 }
 std::vector<BinaryenExpressionRef>
-Compiler::compileExpressionToExpressionRefs(std::shared_ptr<ast::Expression> const &expression,
+Compiler::compileExpressionToExpressionRefs(ast::Expression const *expression,
                                             std::shared_ptr<ir::VariantType> const &expectedType) {
   auto valueVariant = compileExpression(expression, expectedType);
-  return valueVariant->assignToStack(module_);
+  std::vector<BinaryenExpressionRef> exprRefs = valueVariant->assignToStack(module_);
+  addDebugLocation(exprRefs, expression->range());
+  return exprRefs;
 }
 
-std::shared_ptr<ir::Variant> Compiler::compileExpression(std::shared_ptr<ast::Expression> const &expression,
+std::shared_ptr<ir::Variant> Compiler::compileExpression(ast::Expression const *expression,
                                                          std::shared_ptr<ir::VariantType> const &expectedType) {
   try {
     switch (expression->type()) {
     case ast::ExpressionType::TypeIdentifier:
-      return compileIdentifier(std::dynamic_pointer_cast<ast::Identifier>(expression), expectedType);
+      return compileIdentifier(static_cast<ast::Identifier const *>(expression), expectedType);
     case ast::ExpressionType::TypePrefixExpression:
-      return compilePrefixExpression(std::dynamic_pointer_cast<ast::PrefixExpression>(expression), expectedType);
+      return compilePrefixExpression(static_cast<ast::PrefixExpression const *>(expression), expectedType);
     case ast::ExpressionType::TypeBinaryExpression:
-      return compileBinaryExpression(std::dynamic_pointer_cast<ast::BinaryExpression>(expression), expectedType);
+      return compileBinaryExpression(static_cast<ast::BinaryExpression const *>(expression), expectedType);
     case ast::ExpressionType::TypeTernaryExpression:
-      return compileTernaryExpression(std::dynamic_pointer_cast<ast::TernaryExpression>(expression), expectedType);
+      return compileTernaryExpression(static_cast<ast::TernaryExpression const *>(expression), expectedType);
     case ast::ExpressionType::TypeCallExpression:
-      return compileCallExpression(std::dynamic_pointer_cast<ast::CallExpression>(expression), expectedType);
+      return compileCallExpression(static_cast<ast::CallExpression const *>(expression), expectedType);
     case ast::ExpressionType::TypeMemberExpression:
-      return compileMemberExpression(std::dynamic_pointer_cast<ast::MemberExpression>(expression), expectedType);
+      return compileMemberExpression(static_cast<ast::MemberExpression const *>(expression), expectedType);
     }
   } catch (CompilerErrorBase &e) {
     e.setRangeAndThrow(expression->range());
@@ -476,27 +828,27 @@ std::shared_ptr<ir::Variant> Compiler::compileExpression(std::shared_ptr<ast::Ex
   throw std::runtime_error("not support " __FILE__ "#" + std::to_string(__LINE__));
 }
 
-std::shared_ptr<ir::Variant> Compiler::compileIdentifier(std::shared_ptr<ast::Identifier> const &expression,
+std::shared_ptr<ir::Variant> Compiler::compileIdentifier(ast::Identifier const *expression,
                                                          std::shared_ptr<ir::VariantType> const &expectedType) {
   return std::visit(
       overloaded{[this, &expectedType](uint64_t i) -> std::shared_ptr<ir::Variant> {
                    auto pendingType = std::dynamic_pointer_cast<ir::PendingResolveType>(expectedType);
                    if (pendingType != nullptr && !pendingType->isResolved()) {
                      // not resolve, default i32
-                     pendingType->tryResolveTo(variantTypeMap_->findVariantType("i32"));
+                     pendingType->tryResolveTo(ir::VariantType::primitive(ir::VariantType::Type::I32));
                    }
                    return std::make_shared<ir::StackData>(
                        expectedType->underlyingConst(module_, static_cast<int64_t>(i)),
-                       variantTypeMap_->findVariantType("i32"));
+                       ir::VariantType::primitive(ir::VariantType::Type::I32));
                  },
                  [this, &expression, &expectedType](double d) -> std::shared_ptr<ir::Variant> {
                    auto pendingType = std::dynamic_pointer_cast<ir::PendingResolveType>(expectedType);
                    if (pendingType != nullptr && !pendingType->isResolved()) {
                      // not resolve, default f32
-                     pendingType->tryResolveTo(variantTypeMap_->findVariantType("f32"));
+                     pendingType->tryResolveTo(ir::VariantType::primitive(ir::VariantType::Type::F32));
                    }
                    return std::make_shared<ir::StackData>(expectedType->underlyingConst(module_, d),
-                                                          variantTypeMap_->findVariantType("f32"));
+                                                          ir::VariantType::primitive(ir::VariantType::Type::F32));
                  },
                  [this, &expression, &expectedType](const std::string &s) -> std::shared_ptr<ir::Variant> {
                    auto symbol = resolver_.resolveIdentifier(expression); // TODO(FIXME)
@@ -513,12 +865,12 @@ std::shared_ptr<ir::Variant> Compiler::compileIdentifier(std::shared_ptr<ast::Id
                  }},
       expression->identifier());
 }
-std::shared_ptr<ir::Variant> Compiler::compilePrefixExpression(std::shared_ptr<ast::PrefixExpression> const &expression,
+std::shared_ptr<ir::Variant> Compiler::compilePrefixExpression(ast::PrefixExpression const *expression,
                                                                std::shared_ptr<ir::VariantType> const &expectedType) {
   auto expr = compileExpressionToExpressionRef(expression->expr(), expectedType);
   return std::make_shared<ir::StackData>(expectedType->handlePrefixOp(module_, expression->op(), expr), expectedType);
 }
-std::shared_ptr<ir::Variant> Compiler::compileBinaryExpression(std::shared_ptr<ast::BinaryExpression> const &expression,
+std::shared_ptr<ir::Variant> Compiler::compileBinaryExpression(ast::BinaryExpression const *expression,
                                                                std::shared_ptr<ir::VariantType> const &expectedType) {
   BinaryenExpressionRef leftExprRef = compileExpressionToExpressionRef(expression->leftExpr(), expectedType);
   BinaryenExpressionRef rightExprRef = compileExpressionToExpressionRef(expression->rightExpr(), expectedType);
@@ -527,7 +879,7 @@ std::shared_ptr<ir::Variant> Compiler::compileBinaryExpression(std::shared_ptr<a
       expectedType);
 }
 std::shared_ptr<ir::Variant>
-Compiler::compileTernaryExpression(std::shared_ptr<ast::TernaryExpression> const &expression,
+Compiler::compileTernaryExpression(ast::TernaryExpression const *expression,
                                    std::shared_ptr<ir::VariantType> const &expectedType) {
   return std::make_shared<ir::StackData>(
       BinaryenIf(module_,
@@ -536,7 +888,7 @@ Compiler::compileTernaryExpression(std::shared_ptr<ast::TernaryExpression> const
                  compileExpressionToExpressionRef(expression->rightExpr(), expectedType)),
       expectedType);
 }
-std::shared_ptr<ir::Variant> Compiler::compileCallExpression(std::shared_ptr<ast::CallExpression> const &expression,
+std::shared_ptr<ir::Variant> Compiler::compileCallExpression(ast::CallExpression const *expression,
                                                              std::shared_ptr<ir::VariantType> const &expectedType) {
   auto callerSymbol = resolver_.resolveExpression(expression->caller());
   if (callerSymbol->type() != ir::Symbol::Type::TypeFunction) {
@@ -545,10 +897,10 @@ std::shared_ptr<ir::Variant> Compiler::compileCallExpression(std::shared_ptr<ast
   auto functionCaller = std::dynamic_pointer_cast<ir::Function>(callerSymbol);
   std::vector<std::shared_ptr<ir::VariantType>> const &signatureArgumentTypes =
       functionCaller->signature()->argumentTypes();
-  std::vector<std::shared_ptr<ast::Expression>> argumentExpressions = expression->arguments();
+  std::vector<ast::Expression *> argumentExpressions = expression->arguments();
   if (expression->caller()->type() == ast::ExpressionType::TypeMemberExpression) {
     argumentExpressions.insert(argumentExpressions.end(),
-                               std::dynamic_pointer_cast<ast::MemberExpression>(expression->caller())->expr());
+                               static_cast<ast::MemberExpression const *>(expression->caller())->expr());
   }
   // check
   try {
@@ -556,6 +908,9 @@ std::shared_ptr<ir::Variant> Compiler::compileCallExpression(std::shared_ptr<ast
   } catch (CompilerErrorBase &e) {
     e.setRangeAndThrow(expression->range());
   }
+  if (functionCaller->inlineExpression() != nullptr) {
+    return compileInlineCall(functionCaller, argumentExpressions, expectedType);
+  }
 
   // compile
   std::vector<BinaryenExpressionRef> exprRefs{};
@@ -566,22 +921,86 @@ std::shared_ptr<ir::Variant> Compiler::compileCallExpression(std::shared_ptr<ast
   uint32_t memoryPosition = 0;
   uint32_t const returnValuePosition =
       ir::VariantType::getSize(functionCaller->signature()->returnType()->underlyingType());
-  for (uint32_t index = 0; index < signatureArgumentTypes.size(); index++) {
+  bool const isMethod = functionCaller->hasFlag(ir::Function::Flag::Method);
+  std::shared_ptr<ir::Variant> receiver{};
+  bool spillReceiver = false;
+  if (isMethod) {
+    receiver = compileExpression(argumentExpressions.back(), signatureArgumentTypes.back());
+    spillReceiver = functionCaller->hasFlag(ir::Function::Flag::ReferenceReceiver) &&
+                    std::dynamic_pointer_cast<ir::MemoryData>(receiver) == nullptr;
+  }
+  for (uint32_t index = 0; index < signatureArgumentTypes.size() - (isMethod ? 1U : 0U); index++) {
+    if (spillReceiver) {
+      // arguments are evaluated before the receiver is spilled, the same order as passing the receiver by value
+      auto argument = currentFunction()->addTempLocal(signatureArgumentTypes[index]);
+      concat(exprRefs, compileExpression(argumentExpressions[index], signatureArgumentTypes[index])
+                           ->assignTo(module_, argument.get()));
+      concat(operands, argument->assignToStack(module_));
+      continue;
+    }
     auto argumentExprRefs =
         compileExpressionToExpressionRefs(argumentExpressions[index], signatureArgumentTypes[index]);
     operands.insert(operands.cend(), argumentExprRefs.begin(), argumentExprRefs.end());
   }
+  if (isMethod) {
+    // handle this, modification of an assignable receiver is visible to the caller
+    auto const &thisType = signatureArgumentTypes.back();
+    bool const isAssignable = receiver->type() != ir::Symbol::Type::TypeStackData;
+    if (!functionCaller->hasFlag(ir::Function::Flag::ReferenceReceiver)) {
+      auto receiverExprRefs = receiver->assignToStack(module_);
+      addDebugLocation(receiverExprRefs, argumentExpressions.back()->range());
+      operands.insert(operands.cend(), receiverExprRefs.begin(), receiverExprRefs.end());
+      if (functionCaller->writesBackReceiver() && isAssignable) {
+        concat(postPrecessExprRefs, ir::MemoryData{returnValuePosition, thisType}.assignTo(module_, receiver.get()));
+      }
+    } else if (auto memoryData = std::dynamic_pointer_cast<ir::MemoryData>(receiver)) {
+      operands.push_back(memoryData->pointer(module_));
+    } else {
+      // spill the receiver to the shadow stack
+      auto const size = static_cast<int32_t>(std::dynamic_pointer_cast<ir::Class>(thisType)->layout().size_);
+      auto pointer = currentFunction()->addTempLocal(ir::VariantType::primitive(ir::VariantType::Type::I32));
+      ir::MemoryData spilled{pointer->index(), 0U, thisType};
+      BinaryenExpressionRef stackPointer = BinaryenGlobalGet(module_, stackPointerGlobal, BinaryenTypeInt32());
+      BinaryenExpressionRef allocated =
+          BinaryenBinary(module_, BinaryenSubInt32(), stackPointer, BinaryenConst(module_, BinaryenLiteralInt32(size)));
+      allocated = BinaryenLocalTee(module_, pointer->index(), allocated, BinaryenTypeInt32());
+      // trap instead of overwriting the static area when the receivers of nested calls overflow the stack
+      BinaryenExpressionRef overflow = BinaryenBinary(module_, BinaryenLtSInt32(), allocated,
+                                                      BinaryenConst(module_, BinaryenLiteralInt32(stackLimit_)));
+      exprRefs.push_back(BinaryenIf(module_, overflow, BinaryenUnreachable(module_), nullptr));
+      exprRefs.push_back(BinaryenGlobalSet(module_, stackPointerGlobal,
+                                           BinaryenLocalGet(module_, pointer->index(), BinaryenTypeInt32())));
+      auto spillExprRefs = receiver->assignTo(module_, &spilled);
+      addDebugLocation(spillExprRefs, argumentExpressions.back()->range());
+      concat(exprRefs, spillExprRefs);
+      operands.push_back(BinaryenLocalGet(module_, pointer->index(), BinaryenTypeInt32()));
+      if (isAssignable && !functionCaller->hasFlag(ir::Function::Flag::Readonly)) {
+        concat(postPrecessExprRefs, spilled.assignTo(module_, receiver.get()));
+      }
+      BinaryenExpressionRef released =
+          BinaryenBinary(module_, BinaryenAddInt32(), BinaryenLocalGet(module_, pointer->index(), BinaryenTypeInt32()),
+                         BinaryenConst(module_, BinaryenLiteralInt32(size)));
+      postPrecessExprRefs.push_back(BinaryenGlobalSet(module_, stackPointerGlobal, released));
+    }
+  }
 
   // handle return value
-  switch (functionCaller->signature()->returnType()->underlyingReturnTypeStatus()) {
+  switch (functionCaller->underlyingReturnTypeStatus()) {
   case ir::VariantType::UnderlyingReturnTypeStatus::None:
   case ir::VariantType::UnderlyingReturnTypeStatus::ByReturnValue: {
+    BinaryenType returnType = functionCaller->signature()->returnType()->underlyingType();
     BinaryenExpressionRef callExprRef =
-        BinaryenCall(module_, functionCaller->name().c_str(), operands.data(), operands.size(),
-                     functionCaller->signature()->returnType()->underlyingType());
-    exprRefs.push_back(callExprRef);
+        BinaryenCall(module_, functionCaller->name().c_str(), operands.data(), operands.size(), returnType);
+    if (returnType == BinaryenTypeNone() || postPrecessExprRefs.empty()) {
+      exprRefs.push_back(callExprRef);
+      exprRefs.insert(exprRefs.end(), postPrecessExprRefs.begin(), postPrecessExprRefs.end());
+      return std::make_shared<ir::StackData>(binaryen::Utils::combineExprRef(module_, exprRefs), expectedType);
+    }
+    // keep the return value while the receiver is reloaded
+    auto result = currentFunction()->addTempLocal(functionCaller->signature()->returnType());
+    exprRefs.push_back(BinaryenLocalSet(module_, result->index(), callExprRef));
     exprRefs.insert(exprRefs.end(), postPrecessExprRefs.begin(), postPrecessExprRefs.end());
-
+    exprRefs.push_back(BinaryenLocalGet(module_, result->index(), returnType));
     return std::make_shared<ir::StackData>(binaryen::Utils::combineExprRef(module_, exprRefs), expectedType);
   }
   case ir::VariantType::UnderlyingReturnTypeStatus::LoadFromMemory: {
@@ -592,10 +1011,79 @@ std::shared_ptr<ir::Variant> Compiler::compileCallExpression(std::shared_ptr<ast
     concat(exprRefs, ir::MemoryData{0, expectedType}.assignToStack(module_));
     return std::make_shared<ir::StackData>(exprRefs, expectedType);
   }
+  case ir::VariantType::UnderlyingReturnTypeStatus::ByTuple: {
+    // values can only be extracted from a tuple in a local
+    BinaryenType tupleType = functionCaller->underlyingReturnType();
+    auto tuple = currentFunction()->addTupleTempLocal(functionCaller->signature()->returnType());
+    BinaryenExpressionRef callExprRef =
+        BinaryenCall(module_, functionCaller->name().c_str(), operands.data(), operands.size(), tupleType);
+    exprRefs.push_back(BinaryenLocalSet(module_, tuple->index(), callExprRef));
+    exprRefs.insert(exprRefs.end(), postPrecessExprRefs.begin(), postPrecessExprRefs.end());
+    for (BinaryenIndex index = 0; index < BinaryenTypeArity(tupleType); index++) {
+      exprRefs.push_back(BinaryenTupleExtract(module_, BinaryenLocalGet(module_, tuple->index(), tupleType), index));
+    }
+    return std::make_shared<ir::StackData>(exprRefs, expectedType);
+  }
   }
   throw std::runtime_error("not support " __FILE__ "#" + std::to_string(__LINE__));
 }
-std::shared_ptr<ir::Variant> Compiler::compileMemberExpression(std::shared_ptr<ast::MemberExpression> const &expression,
+std::shared_ptr<ir::Variant> Compiler::compileInlineCall(std::shared_ptr<ir::Function> const &function,
+                                                         std::vector<ast::Expression *> const &argumentExpressions,
+                                                         std::shared_ptr<ir::VariantType> const &expectedType) {
+  std::vector<std::shared_ptr<ir::VariantType>> const &argumentTypes = function->signature()->argumentTypes();
+  bool const isMethod = function->hasFlag(ir::Function::Flag::Method);
+  std::vector<BinaryenExpressionRef> exprRefs{};
+  std::unordered_map<std::string, std::shared_ptr<ir::Symbol>> arguments{};
+  for (uint32_t index = 0; index < argumentTypes.size() - (isMethod ? 1U : 0U); index++) {
+    // evaluate each argument once and in order like the operands of a call
+    auto argument = currentFunction()->addTempLocal(argumentTypes[index]);
+    auto argumentExprRefs =
+        compileExpression(argumentExpressions[index], argumentTypes[index])->assignTo(module_, argument.get());
+    addDebugLocation(argumentExprRefs, argumentExpressions[index]->range());
+    concat(exprRefs, argumentExprRefs);
+    arguments.emplace(function->argumentNames()[index], argument);
+  }
+  if (isMethod) {
+    // the inlined expression only reads `this`, an assignable receiver is read in place
+    auto receiver = compileExpression(argumentExpressions.back(), argumentTypes.back());
+    if (receiver->type() == ir::Symbol::Type::TypeStackData) {
+      auto copy = currentFunction()->addTempLocal(argumentTypes.back());
+      concat(exprRefs, receiver->assignTo(module_, copy.get()));
+      receiver = copy;
+    }
+    arguments.emplace("this", receiver);
+  }
+  resolver_.enterInlineScope(std::move(arguments));
+  auto result = compileExpression(function->inlineExpression(), function->signature()->returnType());
+  resolver_.exitInlineScope();
+  // the result is a value, it must not alias the receiver
+  concat(exprRefs, result->assignToStack(module_));
+  return std::make_shared<ir::StackData>(exprRefs, expectedType);
+}
+std::shared_ptr<ir::Variant> Compiler::compileInitializer(ast::Expression const *expression,
+                                                          std::shared_ptr<ir::VariantType> const &expectedType) {
+  auto callee = calledFunction(expression);
+  if (callee == nullptr || !callee->hasFlag(ir::Function::Flag::Constructor)) {
+    return compileExpression(expression, expectedType);
+  }
+  try {
+    callee->checkArgumentAndReturnType(static_cast<ast::CallExpression const *>(expression)->arguments(),
+                                       expectedType);
+  } catch (CompilerErrorBase &e) {
+    e.setRangeAndThrow(expression->range());
+  }
+  // constructor only produces default values, they go to the destination without the call and the memory round trip
+  auto classType = std::dynamic_pointer_cast<ir::Class>(callee->signature()->returnType());
+  return std::make_shared<ir::StackData>(defaultValues(classType), classType);
+}
+std::shared_ptr<ir::Function> Compiler::calledFunction(ast::Expression const *expression) {
+  if (expression->type() != ast::ExpressionType::TypeCallExpression) {
+    return nullptr;
+  }
+  auto callerSymbol = resolver_.resolveExpression(static_cast<ast::CallExpression const *>(expression)->caller());
+  return std::dynamic_pointer_cast<ir::Function>(callerSymbol);
+}
+std::shared_ptr<ir::Variant> Compiler::compileMemberExpression(ast::MemberExpression const *expression,
                                                                std::shared_ptr<ir::VariantType> const &expectedType) {
   auto symbol = resolver_.resolveMemberExpression(expression);
   switch (symbol->type()) {
@@ -3,13 +3,28 @@
 #include "ast/expression.hpp"
 #include "ast/file.hpp"
 #include "ast/statement.hpp"
+#include "binaryen/function_cache.hpp"
+#include "declaration_preparer.hpp"
+#include "helper/hash.hpp"
+#include "helper/trace.hpp"
+#include "inliner.hpp"
 #include "ir/variant.hpp"
 #include "ir/variant_type.hpp"
+#include "profile.hpp"
+#include "readonly_inference.hpp"
 #include "resolver.hpp"
+#include "statistics.hpp"
 #include "variant_type_table.hpp"
 #include <binaryen-c.h>
+#include <cstddef>
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <optional>
+#include <ostream>
+#include <set>
 #include <stack>
+#include <string>
 #include <vector>
 
 namespace walang {
@@ -22,79 +37,168 @@ public:
   Compiler &operator=(Compiler const &) = delete;
   Compiler &operator=(Compiler &&) = delete;
 
-  ~Compiler() { BinaryenModuleDispose(module_); }
+  /// @brief mutable i32 global pointing to the top of the shadow stack, receivers of methods which take `this` by
+  /// reference are spilled there when they are not in memory already
+  static constexpr char const *stackPointerGlobal = "walang$stackPointer";
+  /// @brief the shadow stack grows down from the end of the only memory page
+  static constexpr int32_t stackBase = 65536;
+
+  ~Compiler() {
+    if (ownsModule_) {
+      BinaryenModuleDispose(module_);
+    }
+  }
+
+  /// @brief number of threads used to lower function bodies, 1 means lowering in place
+  void setThreads(uint32_t threads) noexcept { threads_ = threads; }
+  /// @brief reuse lowered functions across compilations, functions are keyed by their AST and the declarations of
+  /// the whole program they may depend on
+  void setFunctionCache(std::shared_ptr<binaryen::FunctionCache> cache) noexcept { functionCache_ = std::move(cache); }
+  /// @brief record the time of each compile phase and of each function
+  void setTracer(std::shared_ptr<Tracer> tracer) noexcept { tracer_ = std::move(tracer); }
+  /// @brief emit profiling counters, instrumented compilations do not use the function cache
+  void setInstrumentOptions(InstrumentOptions options) noexcept { instrumentOptions_ = options; }
+  /// @brief attach the source position of statements and expressions to the lowered code for source maps
+  void setDebugInfo(bool debugInfo) noexcept { debugInfo_ = debugInfo; }
+  /// @brief return classes with more than one underlying value as a tuple instead of through memory, the module
+  /// requires the multi-value feature
+  void setMultivalue(bool multivalue) noexcept { multivalue_ = multivalue; }
+  /// @brief copy and zero large classes in memory with single bulk memory instructions, the module requires the
+  /// bulk-memory feature
+  void setBulkMemory(bool bulkMemory) noexcept { bulkMemory_ = bulkMemory; }
+  /// @brief inline functions without `@inline` whose returned expression has at most `maxSize` nodes, instrumented
+  /// compilations never inline
+  void setInlineMaxSize(uint32_t maxSize) noexcept { inliner_.setMaxSize(maxSize); }
 
   void compile();
   [[nodiscard]] BinaryenModuleRef module() const noexcept { return module_; }
   [[nodiscard]] std::string wat() const;
+  /// @brief print the text format directly into `os`
+  void writeWat(std::ostream &os) const;
+  /// @brief write the binary format into `os`, the module is serialized once
+  void writeWasm(std::ostream &os) const;
+  /// @brief write the binary format into `os` which refers to `sourceMapUrl`, and the source map into `sourceMap`
+  void writeWasm(std::ostream &os, std::string const &sourceMapUrl, std::ostream &sourceMap) const;
+  /// @brief fill AST, function, class and global statistics of the compiled module before optimization
+  void collectStatistics(Statistics &statistics) const;
+  /// @brief diagnostics which do not stop the compilation
+  [[nodiscard]] std::vector<std::string> const &warnings() const noexcept { return warnings_; }
 
 private:
-  void prepareFunctionStatement(ast::FunctionStatement const &statement);
-  std::shared_ptr<ir::Function> prepareMethod(ast::FunctionStatement const &statement,
-                                              std::shared_ptr<ir::Class> const &classType);
-  std::shared_ptr<ir::Function> doPrepareFunction(std::string const &name, std::vector<std::string> argumentNames,
-                                                  std::vector<std::shared_ptr<ir::VariantType>> argumentTypes,
-                                                  std::shared_ptr<ir::VariantType> const &returnType,
-                                                  std::shared_ptr<ir::Class> const &classType,
-                                                  std::vector<std::string> const &decorators);
-  /// @brief prepare memory layout
-  void prepareClassStatementLevel1(ast::ClassStatement const &statement);
-  /// @brief prepare method map
-  void prepareClassStatementLevel2(ast::ClassStatement const &statement);
+  /// @brief a function body whose lowering is deferred to the parallel code generation
+  struct PendingFunction {
+    std::shared_ptr<ir::Function> function_;
+    ast::BlockStatement const *body_;
+    std::size_t visibleGlobalCount_;
+    std::optional<uint64_t> cacheKey_;
+  };
+
+  /// @brief worker view which shares module, types and symbols with `parent` to lower one function body
+  Compiler(Compiler const &parent, std::size_t visibleGlobalCount);
+
+  void compilePendingFunctions();
+  BinaryenExpressionRef lowerFunctionBody(std::shared_ptr<ir::Function> const &function,
+                                          ast::BlockStatement const *body);
+  BinaryenFunctionRef finalizeFunction(std::shared_ptr<ir::Function> const &function, BinaryenExpressionRef body);
+  void addDebugLocation(std::vector<BinaryenExpressionRef> const &exprRefs, ast::Range const &range);
 
 private:
-  std::vector<BinaryenExpressionRef> compileStatement(std::shared_ptr<ast::Statement> const &statement);
-  std::vector<BinaryenExpressionRef> compileDeclareStatement(std::shared_ptr<ast::DeclareStatement> const &statement);
-  std::vector<BinaryenExpressionRef> compileAssignStatement(std::shared_ptr<ast::AssignStatement> const &statement);
-  std::vector<BinaryenExpressionRef>
-  compileExpressionStatement(std::shared_ptr<ast::ExpressionStatement> const &statement);
-  std::vector<BinaryenExpressionRef> compileBlockStatement(std::shared_ptr<ast::BlockStatement> const &statement);
-  std::vector<BinaryenExpressionRef> compileIfStatement(std::shared_ptr<ast::IfStatement> const &statement);
-  std::vector<BinaryenExpressionRef> compileWhileStatement(std::shared_ptr<ast::WhileStatement> const &statement);
-  std::vector<BinaryenExpressionRef> compileBreakStatement(std::shared_ptr<ast::BreakStatement> const &statement);
-  std::vector<BinaryenExpressionRef> compileContinueStatement(std::shared_ptr<ast::ContinueStatement> const &statement);
-  std::vector<BinaryenExpressionRef> compileReturnStatement(std::shared_ptr<ast::ReturnStatement> const &statement);
-  std::vector<BinaryenExpressionRef> compileClassStatement(std::shared_ptr<ast::ClassStatement> const &statement);
-  std::vector<BinaryenExpressionRef> compileFunctionStatement(std::shared_ptr<ast::FunctionStatement> const &statement);
+  /// @brief flags shared by every function of the module, e.g. `Flag::Multivalue`
+  [[nodiscard]] std::set<ir::Function::Flag> functionFlags() const;
+  std::shared_ptr<ir::Function> doPrepareFunction(DeclarationPreparer::FunctionDeclaration const &declaration);
+  /// @brief find methods which never modify `this` before they are declared and warn about violated `@readonly`
+  void inferReadonlyMethods();
+  /// @brief mark functions whose calls are lowered in place and warn about `@inline` functions which cannot be
+  void selectInlineFunctions();
+
+private:
+  std::vector<BinaryenExpressionRef> compileStatement(ast::Statement const *statement);
+  std::vector<BinaryenExpressionRef> doCompileStatement(ast::Statement const *statement);
+  std::vector<BinaryenExpressionRef> compileDeclareStatement(ast::DeclareStatement const *statement);
+  std::vector<BinaryenExpressionRef> compileAssignStatement(ast::AssignStatement const *statement);
+  std::vector<BinaryenExpressionRef> compileExpressionStatement(ast::ExpressionStatement const *statement);
+  std::vector<BinaryenExpressionRef> compileBlockStatement(ast::BlockStatement const *statement);
+  std::vector<BinaryenExpressionRef> compileIfStatement(ast::IfStatement const *statement);
+  std::vector<BinaryenExpressionRef> compileWhileStatement(ast::WhileStatement const *statement);
+  std::vector<BinaryenExpressionRef> compileBreakStatement(ast::BreakStatement const *statement);
+  std::vector<BinaryenExpressionRef> compileContinueStatement(ast::ContinueStatement const *statement);
+  std::vector<BinaryenExpressionRef> compileReturnStatement(ast::ReturnStatement const *statement);
+  std::vector<BinaryenExpressionRef> compileClassStatement(ast::ClassStatement const *statement);
+  std::vector<BinaryenExpressionRef> compileFunctionStatement(ast::FunctionStatement const *statement);
 
   std::shared_ptr<ir::Function> compileClassMethod(std::shared_ptr<ir::Class> const &classType,
-                                                   std::shared_ptr<ast::FunctionStatement> const &statement);
+                                                   ast::FunctionStatement const *statement);
   void compileClassConstructor(std::shared_ptr<ir::Class> const &classType);
 
-  std::shared_ptr<ir::Function> doCompileFunction(std::string const &name,
-                                                  std::shared_ptr<ast::BlockStatement> const &body);
+  [[nodiscard]] uint64_t functionCacheKey(std::string const &name, ast::FunctionStatement const *statement) const;
+  /// @brief hash the callees, classes and globals reachable from the names used in the body, other declarations can
+  /// change without invalidating the cached function
+  void hashReferencedSymbols(Fnv1a &hash, std::shared_ptr<ir::Function> const &function,
+                             ast::FunctionStatement const *statement) const;
+  std::shared_ptr<ir::Function> doCompileFunction(std::string const &name, ast::FunctionStatement const *statement);
 
-  BinaryenExpressionRef compileExpressionToExpressionRef(std::shared_ptr<ast::Expression> const &expression,
+  BinaryenExpressionRef compileExpressionToExpressionRef(ast::Expression const *expression,
                                                          std::shared_ptr<ir::VariantType> const &expectedType);
   std::vector<BinaryenExpressionRef>
-  compileExpressionToExpressionRefs(std::shared_ptr<ast::Expression> const &expression,
+  compileExpressionToExpressionRefs(ast::Expression const *expression,
                                     std::shared_ptr<ir::VariantType> const &expectedType);
 
-  std::shared_ptr<ir::Variant> compileExpression(std::shared_ptr<ast::Expression> const &expression,
+  std::shared_ptr<ir::Variant> compileExpression(ast::Expression const *expression,
                                                  std::shared_ptr<ir::VariantType> const &expectedType);
-  std::shared_ptr<ir::Variant> compileIdentifier(std::shared_ptr<ast::Identifier> const &expression,
+  std::shared_ptr<ir::Variant> compileIdentifier(ast::Identifier const *expression,
                                                  std::shared_ptr<ir::VariantType> const &expectedType);
-  std::shared_ptr<ir::Variant> compilePrefixExpression(std::shared_ptr<ast::PrefixExpression> const &expression,
+  std::shared_ptr<ir::Variant> compilePrefixExpression(ast::PrefixExpression const *expression,
                                                        std::shared_ptr<ir::VariantType> const &expectedType);
-  std::shared_ptr<ir::Variant> compileBinaryExpression(std::shared_ptr<ast::BinaryExpression> const &expression,
+  std::shared_ptr<ir::Variant> compileBinaryExpression(ast::BinaryExpression const *expression,
                                                        std::shared_ptr<ir::VariantType> const &expectedType);
-  std::shared_ptr<ir::Variant> compileTernaryExpression(std::shared_ptr<ast::TernaryExpression> const &expression,
+  std::shared_ptr<ir::Variant> compileTernaryExpression(ast::TernaryExpression const *expression,
                                                         std::shared_ptr<ir::VariantType> const &expectedType);
-  std::shared_ptr<ir::Variant> compileCallExpression(std::shared_ptr<ast::CallExpression> const &expression,
+  std::shared_ptr<ir::Variant> compileCallExpression(ast::CallExpression const *expression,
                                                      std::shared_ptr<ir::VariantType> const &expectedType);
-  std::shared_ptr<ir::Variant> compileMemberExpression(std::shared_ptr<ast::MemberExpression> const &expression,
+  std::shared_ptr<ir::Variant> compileInlineCall(std::shared_ptr<ir::Function> const &function,
+                                                 std::vector<ast::Expression *> const &argumentExpressions,
+                                                 std::shared_ptr<ir::VariantType> const &expectedType);
+  /// @brief value of a declaration or an assignment, class constructors are built in place instead of called
+  std::shared_ptr<ir::Variant> compileInitializer(ast::Expression const *expression,
+                                                  std::shared_ptr<ir::VariantType> const &expectedType);
+  /// @brief function called by the expression, nullptr when the expression is not a call
+  std::shared_ptr<ir::Function> calledFunction(ast::Expression const *expression);
+  std::vector<BinaryenExpressionRef> defaultValues(std::shared_ptr<ir::Class> const &classType);
+  std::shared_ptr<ir::Variant> compileMemberExpression(ast::MemberExpression const *expression,
                                                        std::shared_ptr<ir::VariantType> const &expectedType);
 
   [[nodiscard]] std::shared_ptr<ir::Function> const &currentFunction() const { return currentFunction_.top(); }
 
 private:
   BinaryenModuleRef module_;
+  bool ownsModule_{true};
+  uint32_t threads_{1U};
   std::vector<std::shared_ptr<ast::File>> files_;
   std::shared_ptr<VariantTypeMap> variantTypeMap_;
   Resolver resolver_;
 
   std::stack<std::shared_ptr<ir::Function>> currentFunction_{};
   std::shared_ptr<ir::Function> startFunction_{};
+  std::vector<PendingFunction> pendingFunctions_{};
+
+  std::shared_ptr<binaryen::FunctionCache> functionCache_{};
+  std::shared_ptr<Tracer> tracer_{};
+
+  InstrumentOptions instrumentOptions_{};
+  std::shared_ptr<ProfileCounters> profileCounters_{};
+  /// @brief counter names of the enclosing loops, innermost last
+  std::vector<std::string> loopCounters_{};
+
+  bool debugInfo_{false};
+  std::map<ast::File const *, BinaryenIndex> debugFiles_{};
+  bool multivalue_{false};
+  bool bulkMemory_{false};
+  bool shadowStack_{false};
+  /// @brief the shadow stack must not grow into the return values and receivers written back at the start of memory
+  int32_t stackLimit_{0};
+  ReadonlyInference readonlyInference_{};
+  Inliner inliner_{};
+  std::vector<std::string> warnings_{};
 };
 
 } // namespace walang
\ No newline at end of file
@@ -0,0 +1,151 @@
+#include "declaration_preparer.hpp"
+#include "ast/statement.hpp"
+#include "helper/diagnose.hpp"
+#include "helper/redefined_checker.hpp"
+#include "helper/trace.hpp"
+#include "ir/variant.hpp"
+#include "ir/variant_type.hpp"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace walang {
+
+void DeclarationPreparer::prepareClasses(std::vector<std::shared_ptr<ast::File>> const &files,
+                                         ClassHandler const &onClass) {
+  TraceScope scope{tracer_, "prepare classes level 1"};
+  std::vector<ast::ClassStatement const *> pendingClasses{};
+  auto prepareClass = [this, &onClass](ast::ClassStatement const &statement) {
+    onClass(prepareClassLayout(statement));
+  };
+  for (auto const &file : files) {
+    for (auto &statement : file->statement()) {
+      if (statement->type() == ast::TypeClassStatement) {
+        try {
+          prepareClass(*static_cast<ast::ClassStatement const *>(statement));
+        } catch (UnknownSymbol const &) {
+          pendingClasses.push_back(static_cast<ast::ClassStatement const *>(statement));
+        }
+      }
+    }
+  }
+  // retry until no more class can be resolved
+  bool isResolved = true;
+  while (!pendingClasses.empty() && isResolved) {
+    isResolved = false;
+    std::vector<ast::ClassStatement const *> currentPendingClasses{};
+    std::swap(currentPendingClasses, pendingClasses);
+    for (auto &pendingClass : currentPendingClasses) {
+      try {
+        prepareClass(*pendingClass);
+      } catch (UnknownSymbol const &) {
+        pendingClasses.push_back(pendingClass);
+        continue;
+      }
+      isResolved = true;
+    }
+  }
+  // report the unknown member type
+  for (auto pendingClass : pendingClasses) {
+    prepareClass(*pendingClass);
+  }
+}
+void DeclarationPreparer::prepareFunctions(std::vector<std::shared_ptr<ast::File>> const &files,
+                                           FunctionHandler const &onFunction) {
+  {
+    TraceScope scope{tracer_, "prepare functions"};
+    for (auto const &file : files) {
+      for (auto &statement : file->statement()) {
+        if (statement->type() == ast::TypeFunctionStatement) {
+          auto const &functionStatement = *static_cast<ast::FunctionStatement const *>(statement);
+          onFunction(declareFunction(functionStatement.name(), functionStatement, nullptr));
+        }
+      }
+    }
+  }
+  {
+    TraceScope scope{tracer_, "prepare classes level 2"};
+    for (auto const &file : files) {
+      for (auto &statement : file->statement()) {
+        if (statement->type() != ast::TypeClassStatement) {
+          continue;
+        }
+        auto const &classStatement = *static_cast<ast::ClassStatement const *>(statement);
+        auto classType = std::dynamic_pointer_cast<ir::Class>(variantTypeMap_->findVariantType(classStatement.name()));
+        std::map<std::string, std::shared_ptr<ir::Function>> methodMap{};
+        for (ast::FunctionStatement const *method : classStatement.methods()) {
+          auto declaration = declareFunction(classType->className() + "#" + method->name(), *method, classType);
+          methodMap.emplace(method->name(), onFunction(declaration));
+        }
+        classType->setMethodMap(methodMap);
+      }
+    }
+  }
+}
+
+std::shared_ptr<ir::Class> DeclarationPreparer::prepareClassLayout(ast::ClassStatement const &statement) {
+  // re-define check
+  RedefinedChecker redefinedChecker{};
+  for (auto const &member : statement.members()) {
+    redefinedChecker.check(member.name_);
+  }
+  for (auto const &method : statement.methods()) {
+    redefinedChecker.check(method->name());
+  }
+  std::vector<ir::Class::ClassMember> members{};
+  members.reserve(statement.members().size());
+  for (auto const &member : statement.members()) {
+    if (member.type_ == statement.name()) {
+      auto e = RecursiveDefinedSymbol(member.type_);
+      e.setRange(statement.range());
+      throw e;
+    }
+    members.push_back(ir::Class::ClassMember{.memberName_ = member.name_,
+                                             .memberType_ = variantTypeMap_->findVariantType(member.type_)});
+  }
+  auto classType = std::make_shared<ir::Class>(statement.name());
+  variantTypeMap_->registerType(statement.name(), classType);
+  classType->setMembers(std::move(members));
+  return classType;
+}
+
+DeclarationPreparer::FunctionDeclaration
+DeclarationPreparer::declareFunction(std::string name, ast::FunctionStatement const &statement,
+                                     std::shared_ptr<ir::Class> const &classType) const {
+  FunctionDeclaration declaration{std::move(name), {}, {}, nullptr, {}, classType, &statement};
+  for (auto const &argument : statement.arguments()) {
+    declaration.argumentNames_.push_back(argument.name_);
+    declaration.argumentTypes_.push_back(variantTypeMap_->findVariantType(argument.type_));
+  }
+  if (!statement.returnType().has_value()) {
+    throw std::runtime_error("not support " __FILE__ "#" + std::to_string(__LINE__));
+  }
+  declaration.returnType_ = variantTypeMap_->findVariantType(statement.returnType().value());
+  auto const &decorators = statement.decorators();
+  if (std::count(decorators.begin(), decorators.end(), "readonly") > 0) {
+    if (classType == nullptr) {
+      throw ErrorDecorator{"readonly"};
+    }
+    declaration.flags_.insert(ir::Function::Flag::Readonly);
+  }
+  if (std::count(decorators.begin(), decorators.end(), "inline") > 0) {
+    if (std::count(decorators.begin(), decorators.end(), "noinline") > 0) {
+      throw ErrorDecorator{"noinline"};
+    }
+    declaration.flags_.insert(ir::Function::Flag::Inline);
+  } else if (std::count(decorators.begin(), decorators.end(), "noinline") > 0) {
+    declaration.flags_.insert(ir::Function::Flag::NoInline);
+  }
+  if (classType != nullptr) {
+    declaration.argumentNames_.emplace_back("this");
+    declaration.argumentTypes_.emplace_back(classType);
+    declaration.flags_.insert(ir::Function::Flag::Method);
+  }
+  return declaration;
+}
+
+} // namespace walang
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "ast/file.hpp"
+#include "ast/statement.hpp"
+#include "helper/trace.hpp"
+#include "ir/variant.hpp"
+#include "ir/variant_type.hpp"
+#include "variant_type_table.hpp"
+#include <functional>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace walang {
+
+/// @brief resolve the classes, functions and methods of all files before any body is lowered
+/// the compiler and the interpreter share it so that they agree on layouts, signatures and decorator errors
+class DeclarationPreparer {
+public:
+  /// @brief resolved function or method, `this` is the last argument of methods
+  struct FunctionDeclaration {
+    std::string name_;
+    std::vector<std::string> argumentNames_;
+    std::vector<std::shared_ptr<ir::VariantType>> argumentTypes_;
+    std::shared_ptr<ir::VariantType> returnType_;
+    /// @brief flags from decorators and `Flag::Method`
+    std::set<ir::Function::Flag> flags_;
+    std::shared_ptr<ir::Class> classType_;
+    ast::FunctionStatement const *statement_;
+  };
+  /// @brief called when the layout of a class is known, before any function is declared
+  using ClassHandler = std::function<void(std::shared_ptr<ir::Class> const &)>;
+  /// @brief create and register the function of a declaration
+  using FunctionHandler = std::function<std::shared_ptr<ir::Function>(FunctionDeclaration const &)>;
+
+  DeclarationPreparer(std::shared_ptr<VariantTypeMap> variantTypeMap, Tracer *tracer)
+      : variantTypeMap_(std::move(variantTypeMap)), tracer_(tracer) {}
+
+  /// @brief register class layouts, then functions, then methods and the method map of each class
+  /// @throw CompilerError for redefined members, recursive classes, unknown types and invalid decorators
+  void prepare(std::vector<std::shared_ptr<ast::File>> const &files, ClassHandler const &onClass,
+               FunctionHandler const &onFunction) {
+    prepareClasses(files, onClass);
+    prepareFunctions(files, onFunction);
+  }
+  /// @brief register class layouts, member types can be declared after the class
+  void prepareClasses(std::vector<std::shared_ptr<ast::File>> const &files, ClassHandler const &onClass);
+  /// @brief declare functions, then methods and the method map of each class
+  void prepareFunctions(std::vector<std::shared_ptr<ast::File>> const &files, FunctionHandler const &onFunction);
+
+private:
+  /// @brief prepare memory layout
+  std::shared_ptr<ir::Class> prepareClassLayout(ast::ClassStatement const &statement);
+  [[nodiscard]] FunctionDeclaration declareFunction(std::string name, ast::FunctionStatement const &statement,
+                                                    std::shared_ptr<ir::Class> const &classType) const;
+
+  std::shared_ptr<VariantTypeMap> variantTypeMap_;
+  Tracer *tracer_;
+};
+
+} // namespace walang
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace walang {
+
+/// @brief bump allocator, objects live until the arena is destroyed and are destroyed in reverse order
+class Arena {
+public:
+  Arena() = default;
+  Arena(Arena const &) = delete;
+  Arena(Arena &&) = delete;
+  Arena &operator=(Arena const &) = delete;
+  Arena &operator=(Arena &&) = delete;
+
+  ~Arena() {
+    for (auto it = destructors_.rbegin(); it != destructors_.rend(); ++it) {
+      it->destroy_(it->object_);
+    }
+  }
+
+  template <class T, class... Args> T *make(Args &&...args) {
+    T *object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      destructors_.push_back(Destructor{object, [](void *p) { static_cast<T *>(p)->~T(); }});
+    }
+    return object;
+  }
+
+  /// @brief bytes of all blocks, the arena never releases memory so this is also its peak
+  [[nodiscard]] std::size_t allocatedBytes() const noexcept { return allocatedBytes_; }
+  /// @brief bytes handed out to objects, excluding alignment padding and the unused tail of blocks
+  [[nodiscard]] std::size_t usedBytes() const noexcept { return usedBytes_; }
+
+private:
+  struct Destructor {
+    void *object_;
+    void (*destroy_)(void *);
+  };
+  static constexpr std::size_t blockSize = 64U * 1024U;
+
+  std::vector<std::unique_ptr<std::byte[]>> blocks_{};
+  std::byte *cursor_{nullptr};
+  std::byte *end_{nullptr};
+  std::vector<Destructor> destructors_{};
+  std::size_t allocatedBytes_{0U};
+  std::size_t usedBytes_{0U};
+
+  void *allocate(std::size_t size, std::size_t alignment) {
+    void *cursor = cursor_;
+    std::size_t space = static_cast<std::size_t>(end_ - cursor_);
+    if (cursor_ == nullptr || std::align(alignment, size, cursor, space) == nullptr) {
+      std::size_t const newBlockSize = std::max(blockSize, size + alignment);
+      // no value initialization, every object is constructed in place
+      blocks_.emplace_back(new std::byte[newBlockSize]);
+      cursor = blocks_.back().get();
+      space = newBlockSize;
+      end_ = blocks_.back().get() + newBlockSize;
+      allocatedBytes_ += newBlockSize;
+      std::align(alignment, size, cursor, space);
+    }
+    cursor_ = static_cast<std::byte *>(cursor) + size;
+    usedBytes_ += size;
+    return cursor;
+  }
+};
+
+} // namespace walang
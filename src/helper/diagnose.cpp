@@ -47,6 +47,8 @@ ErrorDecorator::ErrorDecorator(std::string decorator) : CompilerError(), decorat
 void ErrorDecorator::generateErrorMessage() {
   if (decorator_ == "readonly") {
     errorMessage_ = fmt::format("'readonly' decorator can only be used in class method \n\t{}", range_);
+  } else if (decorator_ == "noinline") {
+    errorMessage_ = fmt::format("'noinline' decorator conflicts with 'inline' decorator \n\t{}", range_);
   } else {
     errorMessage_ = fmt::format("error decorator '{}' \n\t{}", decorator_, range_);
   }
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace walang {
+
+/// @brief 64 bit FNV-1a, stable across platforms and runs so it can be used as persistent key
+class Fnv1a {
+public:
+  Fnv1a &update(std::string_view data) noexcept {
+    for (char c : data) {
+      state_ ^= static_cast<uint8_t>(c);
+      state_ *= prime;
+    }
+    // separate consecutive fields, "ab" + "c" should not collide with "a" + "bc"
+    state_ ^= 0xffU;
+    state_ *= prime;
+    return *this;
+  }
+  Fnv1a &update(uint64_t value) noexcept {
+    char bytes[sizeof(value)];
+    for (char &byte : bytes) {
+      byte = static_cast<char>(value & 0xffU);
+      value >>= 8U;
+    }
+    return update(std::string_view{bytes, sizeof(bytes)});
+  }
+  [[nodiscard]] uint64_t digest() const noexcept { return state_; }
+
+private:
+  static constexpr uint64_t offsetBasis = 0xcbf29ce484222325ULL;
+  static constexpr uint64_t prime = 0x100000001b3ULL;
+  uint64_t state_{offsetBasis};
+};
+
+} // namespace walang
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <fmt/core.h>
+#include <string>
+#include <string_view>
+
+namespace walang {
+
+/// @brief escape `text` to be embedded in a JSON string literal
+inline std::string escapeJson(std::string_view text) {
+  std::string escaped{};
+  escaped.reserve(text.size());
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      escaped.push_back('\\');
+      escaped.push_back(c);
+    } else if (static_cast<unsigned char>(c) < 0x20U) {
+      escaped += fmt::format("\\u{:04x}", static_cast<unsigned>(c));
+    } else {
+      escaped.push_back(c);
+    }
+  }
+  return escaped;
+}
+
+} // namespace walang
@@ -4,7 +4,7 @@
 
 namespace walang::ast {
 
-Range::Range(std::shared_ptr<File> const &file, antlr4::ParserRuleContext *ctx)
+Range::Range(File const *file, antlr4::ParserRuleContext *ctx)
     : file_(file),
       start_(Position{.line = ctx->getStart()->getLine(), .column = ctx->getStart()->getCharPositionInLine()}),
       end_(Position{.line = ctx->getStop()->getLine(),
@@ -13,8 +13,7 @@ Range::Range(std::shared_ptr<File> const &file, antlr4::ParserRuleContext *ctx)
 
 std::string Range::to_string() const {
   // vscode use 1 base column
-  auto file = file_.lock();
-  return fmt::format("{0}:{1}:{2} - {0}:{3}:{4}", file ? file->filename() : "unknown file", start_.line,
+  return fmt::format("{0}:{1}:{2} - {0}:{3}:{4}", file_ != nullptr ? file_->filename() : "unknown file", start_.line,
                      start_.column + 1, end_.line, end_.column + 1);
 }
 
@@ -4,7 +4,6 @@
 #include <cstdint>
 #include <fmt/core.h>
 #include <fmt/format.h>
-#include <memory>
 #include <string_view>
 
 namespace walang::ast {
@@ -19,14 +18,15 @@ struct Position {
 class Range {
 public:
   Range() = default;
-  Range(std::shared_ptr<File> const &file, antlr4::ParserRuleContext *ctx);
+  Range(File const *file, antlr4::ParserRuleContext *ctx);
 
   [[nodiscard]] std::string to_string() const;
+  [[nodiscard]] File const *file() const noexcept { return file_; }
   [[nodiscard]] Position const &start() const noexcept { return start_; }
   [[nodiscard]] Position const &end() const noexcept { return end_; }
 
 private:
-  std::weak_ptr<File> file_;
+  File const *file_{nullptr};
   Position start_{};
   Position end_{};
 };
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace walang {
+
+/// @brief hashed symbol table with nested scopes, lookup finds the innermost visible symbol in O(1)
+template <class T> class ScopedSymbolTable {
+public:
+  void enterScope() { scopes_.emplace_back(); }
+  void exitScope() {
+    assert(scopes_.size() > 1U && "root scope cannot be exited");
+    for (std::string const &name : scopes_.back()) {
+      auto it = symbols_.find(name);
+      it->second.pop_back();
+      if (it->second.empty()) {
+        symbols_.erase(it);
+      }
+    }
+    scopes_.pop_back();
+  }
+
+  /// @return false if the name is already declared in the current scope
+  bool insert(std::string const &name, std::shared_ptr<T> symbol) {
+    std::vector<Binding> &bindings = symbols_[name];
+    if (!bindings.empty() && bindings.back().depth_ == scopes_.size()) {
+      return false;
+    }
+    bindings.push_back(Binding{scopes_.size(), std::move(symbol)});
+    scopes_.back().push_back(name);
+    return true;
+  }
+  [[nodiscard]] bool containsInCurrentScope(std::string const &name) const {
+    auto it = symbols_.find(name);
+    return it != symbols_.end() && it->second.back().depth_ == scopes_.size();
+  }
+  [[nodiscard]] std::shared_ptr<T> find(std::string const &name) const {
+    auto it = symbols_.find(name);
+    return it == symbols_.end() ? nullptr : it->second.back().symbol_;
+  }
+
+private:
+  struct Binding {
+    std::size_t depth_;
+    std::shared_ptr<T> symbol_;
+  };
+  /// @brief visible bindings of each name, the innermost is the last one
+  std::unordered_map<std::string, std::vector<Binding>> symbols_{};
+  /// @brief names declared in each scope, the first one is the root scope
+  std::vector<std::vector<std::string>> scopes_ = std::vector<std::vector<std::string>>(1U);
+};
+
+} // namespace walang
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace walang {
+
+class ThreadPool {
+public:
+  explicit ThreadPool(uint32_t threadCount) {
+    if (threadCount == 0U) {
+      threadCount = 1U;
+    }
+    workers_.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; i++) {
+      workers_.emplace_back([this] { run(); });
+    }
+  }
+  ThreadPool(ThreadPool const &) = delete;
+  ThreadPool(ThreadPool &&) = delete;
+  ThreadPool &operator=(ThreadPool const &) = delete;
+  ThreadPool &operator=(ThreadPool &&) = delete;
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      stopped_ = true;
+    }
+    condition_.notify_all();
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+  }
+
+  /// @brief enqueue a task, exceptions are forwarded to the returned future
+  template <class Fn> std::future<std::invoke_result_t<Fn>> submit(Fn &&fn) {
+    using Result = std::invoke_result_t<Fn>;
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Fn>(fn));
+    std::future<Result> future = task->get_future();
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      tasks_.emplace([task] { (*task)(); });
+    }
+    condition_.notify_one();
+    return future;
+  }
+
+  [[nodiscard]] static uint32_t hardwareConcurrency() noexcept {
+    auto count = std::thread::hardware_concurrency();
+    return count == 0U ? 1U : count;
+  }
+
+private:
+  std::vector<std::thread> workers_{};
+  std::queue<std::function<void()>> tasks_{};
+  std::mutex mutex_{};
+  std::condition_variable condition_{};
+  bool stopped_{false};
+
+  void run() {
+    while (true) {
+      std::function<void()> task{};
+      {
+        std::unique_lock<std::mutex> lock{mutex_};
+        condition_.wait(lock, [this] { return stopped_ || !tasks_.empty(); });
+        if (tasks_.empty()) {
+          return;
+        }
+        task = std::move(tasks_.front());
+        tasks_.pop();
+      }
+      task();
+    }
+  }
+};
+
+} // namespace walang
@@ -0,0 +1,72 @@
+#include "trace.hpp"
+#include "json.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fmt/core.h>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace walang {
+
+void Tracer::record(std::string name, std::string detail, Clock::time_point start, Clock::time_point end) {
+  auto toUs = [](Clock::duration duration) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+  };
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto thread = threads_.try_emplace(std::this_thread::get_id(), static_cast<uint32_t>(threads_.size())).first->second;
+  events_.push_back(Event{std::move(name), std::move(detail), thread, toUs(start - origin_), toUs(end - start)});
+}
+
+std::vector<Tracer::Event> Tracer::events() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return events_;
+}
+
+void Tracer::writeSummary(std::ostream &os) const {
+  struct Total {
+    uint64_t us_{0U};
+    uint64_t count_{0U};
+  };
+  std::map<std::string, Total> totals{};
+  uint64_t wallUs = 0U;
+  for (Event const &event : events()) {
+    Total &total = totals[event.name_];
+    total.us_ += event.durationUs_;
+    total.count_++;
+    wallUs = std::max(wallUs, event.startUs_ + event.durationUs_);
+  }
+  std::vector<std::pair<std::string, Total>> sorted{totals.begin(), totals.end()};
+  std::stable_sort(sorted.begin(), sorted.end(),
+                   [](auto const &a, auto const &b) { return a.second.us_ > b.second.us_; });
+  os << fmt::format("{:>12} {:>8} {:>8}  {}\n", "time (s)", "%wall", "count", "phase");
+  for (auto const &[name, total] : sorted) {
+    double percent = wallUs == 0U ? 0.0 : 100.0 * static_cast<double>(total.us_) / static_cast<double>(wallUs);
+    os << fmt::format("{:>12.6f} {:>7.1f}% {:>8}  {}\n", static_cast<double>(total.us_) / 1e6, percent, total.count_,
+                      name);
+  }
+  os << fmt::format("{:>12.6f} {:>7.1f}% {:>8}  {}\n", static_cast<double>(wallUs) / 1e6, 100.0, "", "wall");
+}
+
+void Tracer::writeChromeTrace(std::ostream &os) const {
+  os << "{\"traceEvents\":[";
+  bool first = true;
+  for (Event const &event : events()) {
+    os << (first ? "\n" : ",\n");
+    first = false;
+    os << fmt::format(R"({{"name":"{}","cat":"walang","ph":"X","ts":{},"dur":{},"pid":1,"tid":{})",
+                      escapeJson(event.name_), event.startUs_, event.durationUs_, event.thread_);
+    if (!event.detail_.empty()) {
+      os << fmt::format(R"(,"args":{{"detail":"{}"}})", escapeJson(event.detail_));
+    }
+    os << "}";
+  }
+  os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+} // namespace walang
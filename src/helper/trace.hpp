@@ -0,0 +1,68 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace walang {
+
+/// @brief collects timed spans of the compiler phases from any thread
+class Tracer {
+public:
+  using Clock = std::chrono::steady_clock;
+  struct Event {
+    std::string name_;
+    std::string detail_;
+    uint32_t thread_;
+    uint64_t startUs_;
+    uint64_t durationUs_;
+  };
+
+  void record(std::string name, std::string detail, Clock::time_point start, Clock::time_point end);
+  [[nodiscard]] std::vector<Event> events() const;
+
+  /// @brief total time and count of each span name, spans may overlap when they are nested or run in parallel
+  void writeSummary(std::ostream &os) const;
+  /// @brief chrome trace event format, can be loaded by chrome://tracing or perfetto
+  void writeChromeTrace(std::ostream &os) const;
+
+private:
+  mutable std::mutex mutex_{};
+  Clock::time_point origin_{Clock::now()};
+  std::vector<Event> events_{};
+  std::map<std::thread::id, uint32_t> threads_{};
+};
+
+/// @brief records one span from construction to destruction, no-op without tracer
+class TraceScope {
+public:
+  TraceScope(Tracer *tracer, std::string name, std::string detail = {})
+      : tracer_(tracer), name_(std::move(name)), detail_(std::move(detail)) {
+    if (tracer_ != nullptr) {
+      start_ = Tracer::Clock::now();
+    }
+  }
+  TraceScope(TraceScope const &) = delete;
+  TraceScope(TraceScope &&) = delete;
+  TraceScope &operator=(TraceScope const &) = delete;
+  TraceScope &operator=(TraceScope &&) = delete;
+  ~TraceScope() {
+    if (tracer_ != nullptr) {
+      tracer_->record(std::move(name_), std::move(detail_), start_, Tracer::Clock::now());
+    }
+  }
+
+private:
+  Tracer *tracer_;
+  std::string name_;
+  std::string detail_;
+  Tracer::Clock::time_point start_{};
+};
+
+} // namespace walang
@@ -0,0 +1,88 @@
+#include "inliner.hpp"
+#include "ast/expression.hpp"
+#include "ast/statement.hpp"
+#include "ir/variant.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace walang {
+
+bool Inliner::addFunction(ast::FunctionStatement const &statement, std::shared_ptr<ir::Function> const &function) {
+  bool const isInline = function->hasFlag(ir::Function::Flag::Inline);
+  if (function->hasFlag(ir::Function::Flag::NoInline)) {
+    return true;
+  }
+  auto const &statements = statement.body()->statements();
+  if (statements.size() != 1U || statements.front()->type() != ast::TypeReturnStatement) {
+    return !isInline;
+  }
+  ast::Expression const *expression = static_cast<ast::ReturnStatement const *>(statements.front())->expr();
+  if (expression == nullptr || !readsArgumentsOnly(expression, function->argumentNames())) {
+    return !isInline;
+  }
+  if (!isInline && size(expression) > maxSize_) {
+    return true;
+  }
+  function->setInlineExpression(expression);
+  functions_.push_back(function);
+  return true;
+}
+
+uint32_t Inliner::size(ast::Expression const *expression) {
+  switch (expression->type()) {
+  case ast::TypeIdentifier:
+    return 1U;
+  case ast::TypePrefixExpression:
+    return 1U + size(static_cast<ast::PrefixExpression const *>(expression)->expr());
+  case ast::TypeBinaryExpression:
+    return 1U + size(static_cast<ast::BinaryExpression const *>(expression)->leftExpr()) +
+           size(static_cast<ast::BinaryExpression const *>(expression)->rightExpr());
+  case ast::TypeTernaryExpression:
+    return 1U + size(static_cast<ast::TernaryExpression const *>(expression)->conditionExpr()) +
+           size(static_cast<ast::TernaryExpression const *>(expression)->leftExpr()) +
+           size(static_cast<ast::TernaryExpression const *>(expression)->rightExpr());
+  case ast::TypeCallExpression: {
+    auto const *callExpression = static_cast<ast::CallExpression const *>(expression);
+    uint32_t result = 1U + size(callExpression->caller());
+    for (ast::Expression const *argument : callExpression->arguments()) {
+      result += size(argument);
+    }
+    return result;
+  }
+  case ast::TypeMemberExpression:
+    return 1U + size(static_cast<ast::MemberExpression const *>(expression)->expr());
+  }
+  return 1U;
+}
+
+bool Inliner::readsArgumentsOnly(ast::Expression const *expression, std::vector<std::string> const &argumentNames) {
+  switch (expression->type()) {
+  case ast::TypeIdentifier: {
+    // globals are not visible everywhere and functions are not values
+    auto const *name = std::get_if<std::string>(&static_cast<ast::Identifier const *>(expression)->identifier());
+    return name == nullptr || std::find(argumentNames.begin(), argumentNames.end(), *name) != argumentNames.end();
+  }
+  case ast::TypePrefixExpression:
+    return readsArgumentsOnly(static_cast<ast::PrefixExpression const *>(expression)->expr(), argumentNames);
+  case ast::TypeBinaryExpression:
+    return readsArgumentsOnly(static_cast<ast::BinaryExpression const *>(expression)->leftExpr(), argumentNames) &&
+           readsArgumentsOnly(static_cast<ast::BinaryExpression const *>(expression)->rightExpr(), argumentNames);
+  case ast::TypeTernaryExpression:
+    return readsArgumentsOnly(static_cast<ast::TernaryExpression const *>(expression)->conditionExpr(),
+                              argumentNames) &&
+           readsArgumentsOnly(static_cast<ast::TernaryExpression const *>(expression)->leftExpr(), argumentNames) &&
+           readsArgumentsOnly(static_cast<ast::TernaryExpression const *>(expression)->rightExpr(), argumentNames);
+  case ast::TypeCallExpression:
+    // calls may modify the receiver or recurse
+    return false;
+  case ast::TypeMemberExpression:
+    return readsArgumentsOnly(static_cast<ast::MemberExpression const *>(expression)->expr(), argumentNames);
+  }
+  return false;
+}
+
+} // namespace walang
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "ast/expression.hpp"
+#include "ast/statement.hpp"
+#include "ir/variant.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace walang {
+
+/// @brief find functions whose body only returns a small expression of their arguments, call sites lower the expression
+/// with the arguments in place instead of calling the function
+/// `@inline` functions are inlined whatever their size, `@noinline` functions are never inlined
+class Inliner {
+public:
+  /// @brief returned expression of functions without `@inline` has at most this many nodes, a member read like
+  /// `this.v` has two
+  static constexpr uint32_t defaultMaxSize = 2U;
+
+  void setMaxSize(uint32_t maxSize) noexcept { maxSize_ = maxSize; }
+  /// @brief decide whether calls of a prepared function are inlined
+  /// @return false when an `@inline` function cannot be inlined
+  bool addFunction(ast::FunctionStatement const &statement, std::shared_ptr<ir::Function> const &function);
+
+  /// @brief inlined functions in the order they are added
+  [[nodiscard]] std::vector<std::shared_ptr<ir::Function>> const &functions() const noexcept { return functions_; }
+
+  /// @brief number of expression nodes
+  static uint32_t size(ast::Expression const *expression);
+
+private:
+  /// @brief whether lowering `expression` at a call site only reads the arguments
+  static bool readsArgumentsOnly(ast::Expression const *expression, std::vector<std::string> const &argumentNames);
+
+  uint32_t maxSize_{defaultMaxSize};
+  std::vector<std::shared_ptr<ir::Function>> functions_{};
+};
+
+} // namespace walang
@@ -0,0 +1,1001 @@
+#include "interpreter.hpp"
+#include "ast/expression.hpp"
+#include "ast/statement.hpp"
+#include "binaryen/runner.hpp"
+#include "declaration_preparer.hpp"
+#include "helper/diagnose.hpp"
+#include "helper/overload.hpp"
+#include "ir/variant.hpp"
+#include "ir/variant_type.hpp"
+#include "resolver.hpp"
+#include "variant_type_table.hpp"
+#include "wasm.h"
+#include <algorithm>
+#include <binaryen-c.h>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <fmt/core.h>
+#include <limits>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace walang {
+
+namespace interpreter {
+
+enum class Completion { Normal, Break, Continue, Return };
+
+struct Frame {
+  std::vector<Slot> &globals_;
+  std::vector<Slot> locals_;
+  /// @brief the return value is written here and copied to the caller when the function exits
+  Slot *returnValue_;
+  uint32_t depth_;
+};
+
+class Expression {
+public:
+  virtual ~Expression() = default;
+  /// @brief write the value into `result`, `result` is only written after all operands are evaluated
+  virtual void evaluate(Frame &frame, Slot *result) const = 0;
+};
+
+class Statement {
+public:
+  virtual ~Statement() = default;
+  virtual Completion execute(Frame &frame) const = 0;
+};
+
+struct Function {
+  std::shared_ptr<ir::Function> ir_;
+  /// @brief constructors have no body, they return the zero value
+  std::unique_ptr<Statement> body_{};
+  uint32_t frameSize_{0U};
+  uint32_t returnSize_{0U};
+
+  /// @brief execute with the arguments stored in the first locals of `frame`
+  void execute(Frame &frame) const {
+    if (body_ != nullptr) {
+      body_->execute(frame);
+    }
+  }
+  void call(Frame &frame, Slot *result) const {
+    execute(frame);
+    std::copy_n(frame.returnValue_, returnSize_, result);
+  }
+};
+
+namespace {
+
+template <class T> T load(Slot const *slot) {
+  T value;
+  std::memcpy(&value, slot, sizeof(T));
+  return value;
+}
+template <class T> void store(Slot *slot, T value) { std::memcpy(slot, &value, sizeof(T)); }
+
+[[noreturn]] void trap(std::string const &why) { throw binaryen::RuntimeTrap(fmt::format("trap: {}", why)); }
+
+/// @brief arithmetic with the semantics of the wasm instruction `handleBinaryOp` selects for `op`
+template <class T> T applyBinaryOp(ast::BinaryOp op, T left, T right) {
+  if constexpr (std::is_integral_v<T>) {
+    using Unsigned = std::make_unsigned_t<T>;
+    constexpr Unsigned shiftMask = sizeof(T) * 8U - 1U;
+    constexpr char const *typeName = sizeof(T) == 4U ? "i32" : "i64";
+    switch (op) {
+    case ast::BinaryOp::ADD:
+      return static_cast<T>(static_cast<Unsigned>(left) + static_cast<Unsigned>(right));
+    case ast::BinaryOp::SUB:
+      return static_cast<T>(static_cast<Unsigned>(left) - static_cast<Unsigned>(right));
+    case ast::BinaryOp::MUL:
+      return static_cast<T>(static_cast<Unsigned>(left) * static_cast<Unsigned>(right));
+    case ast::BinaryOp::DIV:
+      if (right == 0) {
+        trap(fmt::format("{}.div/rem by 0", typeName));
+      }
+      if constexpr (std::is_signed_v<T>) {
+        if (left == std::numeric_limits<T>::min() && right == -1) {
+          trap(fmt::format("{}.div_s overflow", typeName));
+        }
+      }
+      return left / right;
+    case ast::BinaryOp::MOD:
+      if (right == 0) {
+        trap(fmt::format("{}.div/rem by 0", typeName));
+      }
+      if constexpr (std::is_signed_v<T>) {
+        if (right == -1) {
+          return 0;
+        }
+      }
+      return left % right;
+    case ast::BinaryOp::LEFT_SHIFT:
+      return static_cast<T>(static_cast<Unsigned>(left) << (static_cast<Unsigned>(right) & shiftMask));
+    case ast::BinaryOp::RIGHT_SHIFT:
+      return static_cast<T>(left >> (static_cast<Unsigned>(right) & shiftMask));
+    case ast::BinaryOp::AND:
+      return left & right;
+    case ast::BinaryOp::OR:
+      return left | right;
+    case ast::BinaryOp::XOR:
+      return left ^ right;
+    default:
+      break;
+    }
+  } else {
+    switch (op) {
+    case ast::BinaryOp::ADD:
+      return left + right;
+    case ast::BinaryOp::SUB:
+      return left - right;
+    case ast::BinaryOp::MUL:
+      return left * right;
+    case ast::BinaryOp::DIV:
+      return left / right;
+    default:
+      break;
+    }
+  }
+  // comparisons produce 0 or 1 of the operand type
+  switch (op) {
+  case ast::BinaryOp::LESS_THAN:
+    return left < right ? T{1} : T{0};
+  case ast::BinaryOp::GREATER_THAN:
+    return left > right ? T{1} : T{0};
+  case ast::BinaryOp::NO_LESS_THAN:
+    return left >= right ? T{1} : T{0};
+  case ast::BinaryOp::NO_GREATER_THAN:
+    return left <= right ? T{1} : T{0};
+  case ast::BinaryOp::EQUAL:
+    return left == right ? T{1} : T{0};
+  case ast::BinaryOp::NOT_EQUAL:
+    return left != right ? T{1} : T{0};
+  default:
+    break;
+  }
+  throw std::runtime_error("not support " __FILE__ "#" + std::to_string(__LINE__));
+}
+
+class Constant final : public Expression {
+public:
+  template <class T> static std::unique_ptr<Expression> of(T value) {
+    Slot slot = 0U;
+    store(&slot, value);
+    return std::make_unique<Constant>(slot);
+  }
+  explicit Constant(Slot value) : value_(value) {}
+  void evaluate(Frame &frame, Slot *result) const override { *result = value_; }
+
+private:
+  Slot value_;
+};
+
+class Load final : public Expression {
+public:
+  Load(bool global, uint32_t index, uint32_t size) : global_(global), index_(index), size_(size) {}
+  void evaluate(Frame &frame, Slot *result) const override {
+    Slot const *source = (global_ ? frame.globals_.data() : frame.locals_.data()) + index_;
+    std::memmove(result, source, size_ * sizeof(Slot));
+  }
+
+private:
+  bool global_;
+  uint32_t index_;
+  uint32_t size_;
+};
+
+template <class T> class Prefix final : public Expression {
+public:
+  Prefix(ast::PrefixOp op, std::unique_ptr<Expression> operand) : op_(op), operand_(std::move(operand)) {}
+  void evaluate(Frame &frame, Slot *result) const override {
+    Slot operand = 0U;
+    operand_->evaluate(frame, &operand);
+    T value = load<T>(&operand);
+    switch (op_) {
+    case ast::PrefixOp::ADD:
+      break;
+    case ast::PrefixOp::SUB:
+      value = applyBinaryOp<T>(ast::BinaryOp::SUB, T{0}, value);
+      break;
+    case ast::PrefixOp::NOT:
+      value = value == T{0} ? T{1} : T{0};
+      break;
+    }
+    store(result, value);
+  }
+
+private:
+  ast::PrefixOp op_;
+  std::unique_ptr<Expression> operand_;
+};
+
+template <class T> class Binary final : public Expression {
+public:
+  Binary(ast::BinaryOp op, std::unique_ptr<Expression> left, std::unique_ptr<Expression> right)
+      : op_(op), left_(std::move(left)), right_(std::move(right)) {}
+  void evaluate(Frame &frame, Slot *result) const override {
+    Slot left = 0U;
+    Slot right = 0U;
+    left_->evaluate(frame, &left);
+    right_->evaluate(frame, &right);
+    store(result, applyBinaryOp<T>(op_, load<T>(&left), load<T>(&right)));
+  }
+
+private:
+  ast::BinaryOp op_;
+  std::unique_ptr<Expression> left_;
+  std::unique_ptr<Expression> right_;
+};
+
+/// @brief `&&` and `||` evaluate the right operand only when the left one does not decide, the result is the last
+/// evaluated operand
+template <class T> class Logic final : public Expression {
+public:
+  Logic(bool isAnd, std::unique_ptr<Expression> left, std::unique_ptr<Expression> right)
+      : isAnd_(isAnd), left_(std::move(left)), right_(std::move(right)) {}
+  void evaluate(Frame &frame, Slot *result) const override {
+    Slot left = 0U;
+    left_->evaluate(frame, &left);
+    if ((load<T>(&left) != T{0}) == isAnd_) {
+      right_->evaluate(frame, result);
+    } else {
+      store(result, load<T>(&left));
+    }
+  }
+
+private:
+  bool isAnd_;
+  std::unique_ptr<Expression> left_;
+  std::unique_ptr<Expression> right_;
+};
+
+/// @brief condition of `if`, `while` and ternary expressions, which is an integer of either width
+class Condition {
+public:
+  Condition(std::unique_ptr<Expression> expression, std::shared_ptr<ir::VariantType> const &type)
+      : expression_(std::move(expression)), wide_(type->underlyingType() == BinaryenTypeInt64()) {}
+  bool test(Frame &frame) const {
+    Slot value = 0U;
+    expression_->evaluate(frame, &value);
+    return wide_ ? load<uint64_t>(&value) != 0U : load<uint32_t>(&value) != 0U;
+  }
+
+private:
+  std::unique_ptr<Expression> expression_;
+  bool wide_;
+};
+
+class Ternary final : public Expression {
+public:
+  Ternary(Condition condition, std::unique_ptr<Expression> left, std::unique_ptr<Expression> right)
+      : condition_(std::move(condition)), left_(std::move(left)), right_(std::move(right)) {}
+  void evaluate(Frame &frame, Slot *result) const override {
+    (condition_.test(frame) ? left_ : right_)->evaluate(frame, result);
+  }
+
+private:
+  Condition condition_;
+  std::unique_ptr<Expression> left_;
+  std::unique_ptr<Expression> right_;
+};
+
+class Call final : public Expression {
+public:
+  /// @brief variable which `this` of a mutating method is copied back to
+  struct Receiver {
+    bool global_;
+    uint32_t index_;
+    uint32_t thisIndex_;
+    uint32_t size_;
+  };
+
+  /// @param arguments local index of each argument in the frame of `function`
+  Call(Function const &function, std::vector<std::pair<uint32_t, std::unique_ptr<Expression>>> arguments,
+       std::optional<Receiver> receiver)
+      : function_(function), arguments_(std::move(arguments)), receiver_(receiver) {}
+  void evaluate(Frame &frame, Slot *result) const override {
+    if (frame.depth_ >= Interpreter::maxCallDepth) {
+      throw binaryen::RuntimeTrap("host limit: stack limit");
+    }
+    Frame callee{frame.globals_, std::vector<Slot>(function_.frameSize_ + function_.returnSize_, 0U), nullptr,
+                 frame.depth_ + 1U};
+    callee.returnValue_ = callee.locals_.data() + function_.frameSize_;
+    for (auto const &[index, argument] : arguments_) {
+      argument->evaluate(frame, callee.locals_.data() + index);
+    }
+    function_.execute(callee);
+    if (receiver_.has_value()) {
+      std::copy_n(callee.locals_.data() + receiver_->thisIndex_, receiver_->size_,
+                  (receiver_->global_ ? frame.globals_.data() : frame.locals_.data()) + receiver_->index_);
+    }
+    std::copy_n(callee.returnValue_, function_.returnSize_, result);
+  }
+
+private:
+  Function const &function_;
+  std::vector<std::pair<uint32_t, std::unique_ptr<Expression>>> arguments_;
+  std::optional<Receiver> receiver_;
+};
+
+class Store final : public Statement {
+public:
+  Store(bool global, uint32_t index, std::unique_ptr<Expression> value)
+      : global_(global), index_(index), value_(std::move(value)) {}
+  Completion execute(Frame &frame) const override {
+    value_->evaluate(frame, (global_ ? frame.globals_.data() : frame.locals_.data()) + index_);
+    return Completion::Normal;
+  }
+
+private:
+  bool global_;
+  uint32_t index_;
+  std::unique_ptr<Expression> value_;
+};
+
+class Evaluate final : public Statement {
+public:
+  Evaluate(std::unique_ptr<Expression> expression, uint32_t size)
+      : expression_(std::move(expression)), discarded_(size) {}
+  Completion execute(Frame &frame) const override {
+    // the value is dropped, so recursive calls may share the buffer
+    expression_->evaluate(frame, discarded_.data());
+    return Completion::Normal;
+  }
+
+private:
+  std::unique_ptr<Expression> expression_;
+  mutable std::vector<Slot> discarded_;
+};
+
+class Block final : public Statement {
+public:
+  explicit Block(std::vector<std::unique_ptr<Statement>> statements) : statements_(std::move(statements)) {}
+  Completion execute(Frame &frame) const override {
+    for (auto const &statement : statements_) {
+      Completion completion = statement->execute(frame);
+      if (completion != Completion::Normal) {
+        return completion;
+      }
+    }
+    return Completion::Normal;
+  }
+
+private:
+  std::vector<std::unique_ptr<Statement>> statements_;
+};
+
+class If final : public Statement {
+public:
+  If(Condition condition, std::unique_ptr<Statement> thenBlock, std::unique_ptr<Statement> elseBlock)
+      : condition_(std::move(condition)), thenBlock_(std::move(thenBlock)), elseBlock_(std::move(elseBlock)) {}
+  Completion execute(Frame &frame) const override {
+    if (condition_.test(frame)) {
+      return thenBlock_->execute(frame);
+    }
+    return elseBlock_ == nullptr ? Completion::Normal : elseBlock_->execute(frame);
+  }
+
+private:
+  Condition condition_;
+  std::unique_ptr<Statement> thenBlock_;
+  std::unique_ptr<Statement> elseBlock_;
+};
+
+class While final : public Statement {
+public:
+  While(Condition condition, std::unique_ptr<Statement> block)
+      : condition_(std::move(condition)), block_(std::move(block)) {}
+  Completion execute(Frame &frame) const override {
+    while (condition_.test(frame)) {
+      Completion completion = block_->execute(frame);
+      if (completion == Completion::Break) {
+        break;
+      }
+      if (completion == Completion::Return) {
+        return completion;
+      }
+    }
+    return Completion::Normal;
+  }
+
+private:
+  Condition condition_;
+  std::unique_ptr<Statement> block_;
+};
+
+/// @brief `break` and `continue`
+class Jump final : public Statement {
+public:
+  explicit Jump(Completion completion) : completion_(completion) {}
+  Completion execute(Frame &frame) const override { return completion_; }
+
+private:
+  Completion completion_;
+};
+
+class Return final : public Statement {
+public:
+  explicit Return(std::unique_ptr<Expression> value) : value_(std::move(value)) {}
+  Completion execute(Frame &frame) const override {
+    value_->evaluate(frame, frame.returnValue_);
+    return Completion::Return;
+  }
+
+private:
+  std::unique_ptr<Expression> value_;
+};
+
+std::shared_ptr<ir::VariantType> resolvedType(std::shared_ptr<ir::VariantType> const &type) {
+  auto pendingType = std::dynamic_pointer_cast<ir::PendingResolveType>(type);
+  return pendingType == nullptr ? type : pendingType->resolvedType();
+}
+
+uint32_t slotCount(ir::VariantType const &type) {
+  if (type.underlyingType() == BinaryenTypeNone()) {
+    return 0U;
+  }
+  return static_cast<uint32_t>(type.underlyingTypes().size());
+}
+
+uint32_t frameSize(ir::Function const &function) {
+  uint32_t size = 0U;
+  for (auto const &local : function.locals()) {
+    size = std::max(size, local->index() + slotCount(*local->variantType()));
+  }
+  return size;
+}
+
+/// @brief check like the lowering of identifiers, classes are only convertible to themselves
+void checkConvertible(std::shared_ptr<ir::VariantType> const &expectedType,
+                      std::shared_ptr<ir::VariantType> const &type) {
+  if (!expectedType->tryResolveTo(type) ||
+      (type->type() == ir::VariantType::Type::Class && resolvedType(expectedType) != type)) {
+    throw TypeConvertError(type->to_string(), expectedType->to_string());
+  }
+}
+
+/// @brief same conversion as `VariantType::underlyingConst`
+std::unique_ptr<Expression> makeConstant(ir::VariantType const &type, int64_t value) {
+  BinaryenType underlyingType = type.underlyingType();
+  if (underlyingType == BinaryenTypeInt32()) {
+    return Constant::of(static_cast<int32_t>(value));
+  } else if (underlyingType == BinaryenTypeInt64()) {
+    return Constant::of(value);
+  } else if (underlyingType == BinaryenTypeFloat32()) {
+    return Constant::of(static_cast<float>(value));
+  } else if (underlyingType == BinaryenTypeFloat64()) {
+    return Constant::of(static_cast<double>(value));
+  }
+  throw std::runtime_error("not support " __FILE__ "#" + std::to_string(__LINE__));
+}
+std::unique_ptr<Expression> makeConstant(ir::VariantType const &type, double value) {
+  BinaryenType underlyingType = type.underlyingType();
+  if (underlyingType == BinaryenTypeInt32()) {
+    throw TypeConvertError(type.to_string(), "i32");
+  } else if (underlyingType == BinaryenTypeInt64()) {
+    throw TypeConvertError(type.to_string(), "i64");
+  } else if (underlyingType == BinaryenTypeFloat32()) {
+    return Constant::of(static_cast<float>(value));
+  } else if (underlyingType == BinaryenTypeFloat64()) {
+    return Constant::of(value);
+  }
+  throw std::runtime_error("not support " __FILE__ "#" + std::to_string(__LINE__));
+}
+
+template <class T>
+std::unique_ptr<Expression> makeBinary(ast::BinaryOp op, std::unique_ptr<Expression> left,
+                                       std::unique_ptr<Expression> right) {
+  if (op == ast::BinaryOp::LOGIC_AND || op == ast::BinaryOp::LOGIC_OR) {
+    return std::make_unique<Logic<T>>(op == ast::BinaryOp::LOGIC_AND, std::move(left), std::move(right));
+  }
+  return std::make_unique<Binary<T>>(op, std::move(left), std::move(right));
+}
+
+bool isIntegerOnly(ast::BinaryOp op) {
+  switch (op) {
+  case ast::BinaryOp::AND:
+  case ast::BinaryOp::OR:
+  case ast::BinaryOp::XOR:
+  case ast::BinaryOp::MOD:
+  case ast::BinaryOp::LEFT_SHIFT:
+  case ast::BinaryOp::RIGHT_SHIFT:
+  case ast::BinaryOp::LOGIC_AND:
+  case ast::BinaryOp::LOGIC_OR:
+    return true;
+  default:
+    return false;
+  }
+}
+
+void storeArgument(wasm::Literal const &literal, Slot *slot) {
+  if (literal.type == wasm::Type::i32) {
+    store(slot, literal.geti32());
+  } else if (literal.type == wasm::Type::i64) {
+    store(slot, literal.geti64());
+  } else if (literal.type == wasm::Type::f32) {
+    store(slot, literal.getf32());
+  } else if (literal.type == wasm::Type::f64) {
+    store(slot, literal.getf64());
+  }
+}
+
+std::string printResult(wasm::Type type, Slot const *slot) {
+  wasm::Literal literal{};
+  if (type == wasm::Type::i32) {
+    literal = wasm::Literal(load<int32_t>(slot));
+  } else if (type == wasm::Type::i64) {
+    literal = wasm::Literal(load<int64_t>(slot));
+  } else if (type == wasm::Type::f32) {
+    literal = wasm::Literal(load<float>(slot));
+  } else if (type == wasm::Type::f64) {
+    literal = wasm::Literal(load<double>(slot));
+  }
+  std::ostringstream value{};
+  value << literal;
+  return value.str();
+}
+
+} // namespace
+
+} // namespace interpreter
+
+using interpreter::Slot;
+
+Interpreter::Interpreter(std::vector<std::shared_ptr<ast::File>> files)
+    : files_{std::move(files)}, scratchModule_{BinaryenModuleCreate()},
+      variantTypeMap_{std::make_shared<VariantTypeMap>()}, resolver_{variantTypeMap_} {
+  try {
+    prepare();
+  } catch (...) {
+    BinaryenModuleDispose(scratchModule_);
+    throw;
+  }
+}
+Interpreter::~Interpreter() { BinaryenModuleDispose(scratchModule_); }
+
+void Interpreter::start() { invoke(startFunction_->name(), {}); }
+
+std::vector<std::string> Interpreter::invoke(std::string const &name, std::vector<std::string> const &arguments) {
+  auto it = functions_.find(name);
+  if (it == functions_.end()) {
+    throw std::invalid_argument(fmt::format("unknown function '{}'", name));
+  }
+  interpreter::Function const &function = *it->second;
+  std::vector<BinaryenType> params{};
+  for (auto const &argumentType : function.ir_->signature()->argumentTypes()) {
+    if (argumentType->underlyingType() != BinaryenTypeNone()) {
+      auto underlyingTypes = argumentType->underlyingTypes();
+      params.insert(params.end(), underlyingTypes.begin(), underlyingTypes.end());
+    }
+  }
+  if (params.size() != arguments.size()) {
+    throw std::invalid_argument(
+        fmt::format("function '{}' expects {} arguments but got {}", name, params.size(), arguments.size()));
+  }
+  interpreter::Frame frame{globals_, std::vector<Slot>(function.frameSize_ + function.returnSize_, 0U), nullptr, 0U};
+  frame.returnValue_ = frame.locals_.data() + function.frameSize_;
+  // arguments are the first locals, flattened in order
+  for (std::size_t i = 0; i < arguments.size(); i++) {
+    interpreter::storeArgument(binaryen::parseArgument(wasm::Type(params[i]), arguments[i]),
+                               frame.locals_.data() + i);
+  }
+  std::vector<Slot> result(function.returnSize_, 0U);
+  function.call(frame, result.data());
+  auto const &returnType = function.ir_->signature()->returnType();
+  if (returnType->underlyingReturnTypeStatus() != ir::VariantType::UnderlyingReturnTypeStatus::ByReturnValue) {
+    return {};
+  }
+  return {interpreter::printResult(wasm::Type(returnType->underlyingType()), result.data())};
+}
+
+// ██████  ██████  ███████ ██████   █████  ██████  ███████
+// ██   ██ ██   ██ ██      ██   ██ ██   ██ ██   ██ ██
+// ██████  ██████  █████   ██████  ███████ ██████  █████
+// ██      ██   ██ ██      ██      ██   ██ ██   ██ ██
+// ██      ██   ██ ███████ ██      ██   ██ ██   ██ ███████
+
+void Interpreter::prepare() {
+  DeclarationPreparer{variantTypeMap_, nullptr}.prepare(
+      files_, [this](std::shared_ptr<ir::Class> const &classType) { prepareConstructor(classType); },
+      [this](DeclarationPreparer::FunctionDeclaration const &declaration) { return doPrepareFunction(declaration); });
+
+  // top level statements of all files are executed in file order by one start function
+  startFunction_ = std::make_shared<ir::Function>(
+      "_start", std::vector<std::string>{}, std::vector<std::shared_ptr<ir::VariantType>>{},
+      variantTypeMap_->findVariantType("void"), std::set<ir::Function::Flag>{}, scratchModule_);
+  interpreter::Function &start = registerFunction(startFunction_);
+  currentFunction_.push(startFunction_);
+  resolver_.setCurrentFunction(currentFunction());
+  std::vector<std::unique_ptr<interpreter::Statement>> statements{};
+  for (auto const &file : files_) {
+    for (auto &statement : file->statement()) {
+      statements.push_back(lowerStatement(statement));
+    }
+  }
+  start.body_ = std::make_unique<interpreter::Block>(std::move(statements));
+  start.frameSize_ = interpreter::frameSize(*startFunction_);
+}
+
+std::shared_ptr<ir::Function>
+Interpreter::doPrepareFunction(DeclarationPreparer::FunctionDeclaration const &declaration) {
+  auto functionIr = std::make_shared<ir::Function>(declaration.name_, declaration.argumentNames_,
+                                                   declaration.argumentTypes_, declaration.returnType_,
+                                                   declaration.flags_, scratchModule_);
+  resolver_.addFunction(declaration.name_, functionIr);
+  registerFunction(functionIr);
+  return functionIr;
+}
+void Interpreter::prepareConstructor(std::shared_ptr<ir::Class> const &classType) {
+  auto constructor = std::make_shared<ir::Function>(classType->className() + "#constructor", std::vector<std::string>{},
+                                                    std::vector<std::shared_ptr<ir::VariantType>>{}, classType,
+                                                    std::set<ir::Function::Flag>{}, scratchModule_);
+  registerFunction(constructor);
+  resolver_.addFunction(classType->className(), constructor);
+}
+interpreter::Function &Interpreter::registerFunction(std::shared_ptr<ir::Function> const &function) {
+  auto lowered = std::make_unique<interpreter::Function>();
+  lowered->ir_ = function;
+  lowered->returnSize_ = interpreter::slotCount(*function->signature()->returnType());
+  interpreter::Function &ref = *lowered;
+  functions_[function->name()] = std::move(lowered);
+  return ref;
+}
+
+// ███████ ████████  █████  ████████ ███████ ███    ███ ███████ ███    ██ ████████
+// ██         ██    ██   ██    ██    ██      ████  ████ ██      ████   ██    ██
+// ███████    ██    ███████    ██    █████   ██ ████ ██ █████   ██ ██  ██    ██
+//      ██    ██    ██   ██    ██    ██      ██  ██  ██ ██      ██  ██ ██    ██
+// ███████    ██    ██   ██    ██    ███████ ██      ██ ███████ ██   ████    ██
+
+std::unique_ptr<interpreter::Statement> Interpreter::lowerStatement(ast::Statement const *statement) {
+  try {
+    switch (statement->type()) {
+    case ast::StatementType::TypeDeclareStatement:
+      return lowerDeclareStatement(static_cast<ast::DeclareStatement const *>(statement));
+    case ast::StatementType::TypeAssignStatement:
+      return lowerAssignStatement(static_cast<ast::AssignStatement const *>(statement));
+    case ast::StatementType::TypeExpressionStatement:
+      return lowerExpressionStatement(static_cast<ast::ExpressionStatement const *>(statement));
+    case ast::StatementType::TypeBlockStatement:
+      return lowerBlockStatement(static_cast<ast::BlockStatement const *>(statement));
+    case ast::StatementType::TypeIfStatement:
+      return lowerIfStatement(static_cast<ast::IfStatement const *>(statement));
+    case ast::StatementType::TypeWhileStatement:
+      return lowerWhileStatement(static_cast<ast::WhileStatement const *>(statement));
+    case ast::StatementType::TypeBreakStatement:
+      if (loopDepth_ == 0U) {
+        throw JumpStatementError("invalid break");
+      }
+      return std::make_unique<interpreter::Jump>(interpreter::Completion::Break);
+    case ast::StatementType::TypeContinueStatement:
+      if (loopDepth_ == 0U) {
+        throw JumpStatementError("invalid continue");
+      }
+      return std::make_unique<interpreter::Jump>(interpreter::Completion::Continue);
+    case ast::StatementType::TypeFunctionStatement: {
+      auto const *functionStatement = static_cast<ast::FunctionStatement const *>(statement);
+      lowerFunction(functionStatement->name(), functionStatement);
+      return std::make_unique<interpreter::Block>(std::vector<std::unique_ptr<interpreter::Statement>>{});
+    }
+    case ast::StatementType::TypeClassStatement:
+      return lowerClassStatement(static_cast<ast::ClassStatement const *>(statement));
+    case ast::TypeReturnStatement:
+      return lowerReturnStatement(static_cast<ast::ReturnStatement const *>(statement));
+    }
+  } catch (CompilerErrorBase &e) {
+    e.setRangeAndThrow(statement->range());
+  }
+  throw std::runtime_error("not support " __FILE__ "#" + std::to_string(__LINE__));
+}
+std::unique_ptr<interpreter::Statement> Interpreter::lowerDeclareStatement(ast::DeclareStatement const *statement) {
+  std::shared_ptr<ir::VariantType> variantType = statement->variantType().empty()
+                                                     ? resolver_.resolveTypeExpression(statement->init())
+                                                     : variantTypeMap_->findVariantType(statement->variantType());
+  auto init = lowerExpression(statement->init(), variantType);
+  if (currentFunction() == startFunction_) {
+    // in global
+    resolver_.addGlobal(statement->variantName(), std::make_shared<ir::Global>(statement->variantName(), variantType));
+    auto offset = static_cast<uint32_t>(globals_.size());
+    globalOffsets_.emplace(statement->variantName(), offset);
+    globals_.resize(offset + interpreter::slotCount(*variantType), 0U);
+    return std::make_unique<interpreter::Store>(true, offset, std::move(init));
+  }
+  // in function
+  auto local = currentFunction()->addLocal(statement->variantName(), variantType);
+  return std::make_unique<interpreter::Store>(false, local->index(), std::move(init));
+}
+std::unique_ptr<interpreter::Statement> Interpreter::lowerAssignStatement(ast::AssignStatement const *statement) {
+  Variable variable = resolveVariable(statement->variant());
+  auto value = lowerExpression(statement->value(), variable.type_);
+  return std::make_unique<interpreter::Store>(variable.global_, variable.index_, std::move(value));
+}
+std::unique_ptr<interpreter::Statement>
+Interpreter::lowerExpressionStatement(ast::ExpressionStatement const *statement) {
+  auto expectedType = std::make_shared<ir::TypeAuto>();
+  auto expression = lowerExpression(statement->expr(), expectedType);
+  return std::make_unique<interpreter::Evaluate>(std::move(expression),
+                                                 interpreter::slotCount(*interpreter::resolvedType(expectedType)));
+}
+std::unique_ptr<interpreter::Statement> Interpreter::lowerBlockStatement(ast::BlockStatement const *statement) {
+  std::vector<std::unique_ptr<interpreter::Statement>> statements{};
+  currentFunction()->enterScope();
+  for (ast::Statement const *child : statement->statements()) {
+    statements.push_back(lowerStatement(child));
+  }
+  currentFunction()->exitScope();
+  return std::make_unique<interpreter::Block>(std::move(statements));
+}
+std::unique_ptr<interpreter::Statement> Interpreter::lowerIfStatement(ast::IfStatement const *statement) {
+  auto conditionType = std::make_shared<ir::TypeCondition>();
+  auto condition = lowerExpression(statement->condition(), conditionType);
+  auto thenBlock = lowerBlockStatement(statement->thenBlock());
+  auto elseBlock = statement->elseBlock() == nullptr ? nullptr : lowerStatement(statement->elseBlock());
+  return std::make_unique<interpreter::If>(
+      interpreter::Condition{std::move(condition), interpreter::resolvedType(conditionType)}, std::move(thenBlock),
+      std::move(elseBlock));
+}
+std::unique_ptr<interpreter::Statement> Interpreter::lowerWhileStatement(ast::WhileStatement const *statement) {
+  auto conditionType = std::make_shared<ir::TypeCondition>();
+  auto condition = lowerExpression(statement->condition(), conditionType);
+  loopDepth_++;
+  auto block = lowerBlockStatement(statement->block());
+  loopDepth_--;
+  return std::make_unique<interpreter::While>(
+      interpreter::Condition{std::move(condition), interpreter::resolvedType(conditionType)}, std::move(block));
+}
+std::unique_ptr<interpreter::Statement> Interpreter::lowerReturnStatement(ast::ReturnStatement const *statement) {
+  auto value = lowerExpression(statement->expr(), currentFunction()->signature()->returnType());
+  return std::make_unique<interpreter::Return>(std::move(value));
+}
+std::unique_ptr<interpreter::Statement> Interpreter::lowerClassStatement(ast::ClassStatement const *statement) {
+  if (currentFunction() != startFunction_) {
+    throw std::runtime_error("class should only be defined in top scope");
+  }
+  for (auto const &method : statement->methods()) {
+    lowerFunction(statement->name() + "#" + method->name(), method);
+  }
+  return std::make_unique<interpreter::Block>(std::vector<std::unique_ptr<interpreter::Statement>>{});
+}
+void Interpreter::lowerFunction(std::string const &name, ast::FunctionStatement const *statement) {
+  auto it = resolver_.functions().find(name);
+  assert(it != resolver_.functions().end());
+  std::shared_ptr<ir::Function> functionIr = it->second;
+  interpreter::Function &function = *functions_.at(functionIr->name());
+  currentFunction_.push(functionIr);
+  resolver_.setCurrentFunction(currentFunction());
+  uint32_t const loopDepth = std::exchange(loopDepth_, 0U);
+  function.body_ = lowerBlockStatement(statement->body());
+  function.frameSize_ = interpreter::frameSize(*functionIr);
+  loopDepth_ = loopDepth;
+  currentFunction_.pop();
+  resolver_.setCurrentFunction(currentFunction_.empty() ? nullptr : currentFunction());
+}
+
+// ███████ ██   ██ ██████  ██████  ███████ ███████ ███████ ██  ██████  ███    ██
+// ██       ██ ██  ██   ██ ██   ██ ██      ██      ██      ██ ██    ██ ████   ██
+// █████     ███   ██████  ██████  █████   ███████ ███████ ██ ██    ██ ██ ██  ██
+// ██       ██ ██  ██      ██   ██ ██           ██      ██ ██ ██    ██ ██  ██ ██
+// ███████ ██   ██ ██      ██   ██ ███████ ███████ ███████ ██  ██████  ██   ████
+
+std::unique_ptr<interpreter::Expression>
+Interpreter::lowerExpression(ast::Expression const *expression, std::shared_ptr<ir::VariantType> const &expectedType) {
+  try {
+    switch (expression->type()) {
+    case ast::ExpressionType::TypeIdentifier:
+      return lowerIdentifier(static_cast<ast::Identifier const *>(expression), expectedType);
+    case ast::ExpressionType::TypePrefixExpression:
+      return lowerPrefixExpression(static_cast<ast::PrefixExpression const *>(expression), expectedType);
+    case ast::ExpressionType::TypeBinaryExpression:
+      return lowerBinaryExpression(static_cast<ast::BinaryExpression const *>(expression), expectedType);
+    case ast::ExpressionType::TypeTernaryExpression:
+      return lowerTernaryExpression(static_cast<ast::TernaryExpression const *>(expression), expectedType);
+    case ast::ExpressionType::TypeCallExpression:
+      return lowerCallExpression(static_cast<ast::CallExpression const *>(expression), expectedType);
+    case ast::ExpressionType::TypeMemberExpression:
+      return lowerMemberExpression(static_cast<ast::MemberExpression const *>(expression), expectedType);
+    }
+  } catch (CompilerErrorBase &e) {
+    e.setRangeAndThrow(expression->range());
+  }
+  throw std::runtime_error("not support " __FILE__ "#" + std::to_string(__LINE__));
+}
+std::unique_ptr<interpreter::Expression>
+Interpreter::lowerIdentifier(ast::Identifier const *expression, std::shared_ptr<ir::VariantType> const &expectedType) {
+  return std::visit(
+      overloaded{[&expectedType](uint64_t i) -> std::unique_ptr<interpreter::Expression> {
+                   auto pendingType = std::dynamic_pointer_cast<ir::PendingResolveType>(expectedType);
+                   if (pendingType != nullptr && !pendingType->isResolved()) {
+                     // not resolve, default i32
+                     pendingType->tryResolveTo(ir::VariantType::primitive(ir::VariantType::Type::I32));
+                   }
+                   return interpreter::makeConstant(*expectedType, static_cast<int64_t>(i));
+                 },
+                 [&expectedType](double d) -> std::unique_ptr<interpreter::Expression> {
+                   auto pendingType = std::dynamic_pointer_cast<ir::PendingResolveType>(expectedType);
+                   if (pendingType != nullptr && !pendingType->isResolved()) {
+                     // not resolve, default f32
+                     pendingType->tryResolveTo(ir::VariantType::primitive(ir::VariantType::Type::F32));
+                   }
+                   return interpreter::makeConstant(*expectedType, d);
+                 },
+                 [this, &expression, &expectedType](const std::string &s) -> std::unique_ptr<interpreter::Expression> {
+                   Variable variable = resolveVariable(expression);
+                   interpreter::checkConvertible(expectedType, variable.type_);
+                   return lowerVariable(variable);
+                 }},
+      expression->identifier());
+}
+std::unique_ptr<interpreter::Expression>
+Interpreter::lowerPrefixExpression(ast::PrefixExpression const *expression,
+                                   std::shared_ptr<ir::VariantType> const &expectedType) {
+  auto operand = lowerExpression(expression->expr(), expectedType);
+  auto type = interpreter::resolvedType(expectedType);
+  ast::PrefixOp op = expression->op();
+  switch (type->type()) {
+  case ir::VariantType::Type::I32:
+    return std::make_unique<interpreter::Prefix<int32_t>>(op, std::move(operand));
+  case ir::VariantType::Type::U32:
+    return std::make_unique<interpreter::Prefix<uint32_t>>(op, std::move(operand));
+  case ir::VariantType::Type::I64:
+    return std::make_unique<interpreter::Prefix<int64_t>>(op, std::move(operand));
+  case ir::VariantType::Type::U64:
+    return std::make_unique<interpreter::Prefix<uint64_t>>(op, std::move(operand));
+  case ir::VariantType::Type::F32:
+    if (op != ast::PrefixOp::NOT) {
+      return std::make_unique<interpreter::Prefix<float>>(op, std::move(operand));
+    }
+    break;
+  case ir::VariantType::Type::F64:
+    if (op != ast::PrefixOp::NOT) {
+      return std::make_unique<interpreter::Prefix<double>>(op, std::move(operand));
+    }
+    break;
+  default:
+    break;
+  }
+  throw InvalidOperator(type, op);
+}
+std::unique_ptr<interpreter::Expression>
+Interpreter::lowerBinaryExpression(ast::BinaryExpression const *expression,
+                                   std::shared_ptr<ir::VariantType> const &expectedType) {
+  auto left = lowerExpression(expression->leftExpr(), expectedType);
+  auto right = lowerExpression(expression->rightExpr(), expectedType);
+  auto type = interpreter::resolvedType(expectedType);
+  ast::BinaryOp op = expression->op();
+  switch (type->type()) {
+  case ir::VariantType::Type::I32:
+    return interpreter::makeBinary<int32_t>(op, std::move(left), std::move(right));
+  case ir::VariantType::Type::U32:
+    return interpreter::makeBinary<uint32_t>(op, std::move(left), std::move(right));
+  case ir::VariantType::Type::I64:
+    return interpreter::makeBinary<int64_t>(op, std::move(left), std::move(right));
+  case ir::VariantType::Type::U64:
+    return interpreter::makeBinary<uint64_t>(op, std::move(left), std::move(right));
+  case ir::VariantType::Type::F32:
+    if (!interpreter::isIntegerOnly(op)) {
+      return std::make_unique<interpreter::Binary<float>>(op, std::move(left), std::move(right));
+    }
+    break;
+  case ir::VariantType::Type::F64:
+    if (!interpreter::isIntegerOnly(op)) {
+      return std::make_unique<interpreter::Binary<double>>(op, std::move(left), std::move(right));
+    }
+    break;
+  default:
+    break;
+  }
+  throw InvalidOperator(type, op);
+}
+std::unique_ptr<interpreter::Expression>
+Interpreter::lowerTernaryExpression(ast::TernaryExpression const *expression,
+                                    std::shared_ptr<ir::VariantType> const &expectedType) {
+  auto conditionType = std::make_shared<ir::TypeCondition>();
+  auto condition = lowerExpression(expression->conditionExpr(), conditionType);
+  auto left = lowerExpression(expression->leftExpr(), expectedType);
+  auto right = lowerExpression(expression->rightExpr(), expectedType);
+  return std::make_unique<interpreter::Ternary>(
+      interpreter::Condition{std::move(condition), interpreter::resolvedType(conditionType)}, std::move(left),
+      std::move(right));
+}
+std::unique_ptr<interpreter::Expression>
+Interpreter::lowerCallExpression(ast::CallExpression const *expression,
+                                 std::shared_ptr<ir::VariantType> const &expectedType) {
+  auto callerSymbol = resolver_.resolveExpression(expression->caller());
+  if (callerSymbol->type() != ir::Symbol::Type::TypeFunction) {
+    throw std::runtime_error("not support " __FILE__ "#" + std::to_string(__LINE__));
+  }
+  auto functionCaller = std::dynamic_pointer_cast<ir::Function>(callerSymbol);
+  std::vector<std::shared_ptr<ir::VariantType>> const &signatureArgumentTypes =
+      functionCaller->signature()->argumentTypes();
+  std::vector<ast::Expression *> argumentExpressions = expression->arguments();
+  if (expression->caller()->type() == ast::ExpressionType::TypeMemberExpression) {
+    argumentExpressions.insert(argumentExpressions.end(),
+                               static_cast<ast::MemberExpression const *>(expression->caller())->expr());
+  }
+  try {
+    functionCaller->checkArgumentAndReturnType(argumentExpressions, expectedType);
+    interpreter::checkConvertible(expectedType, functionCaller->signature()->returnType());
+  } catch (CompilerErrorBase &e) {
+    e.setRangeAndThrow(expression->range());
+  }
+  std::vector<std::pair<uint32_t, std::unique_ptr<interpreter::Expression>>> arguments{};
+  arguments.reserve(signatureArgumentTypes.size());
+  for (uint32_t index = 0; index < signatureArgumentTypes.size(); index++) {
+    arguments.emplace_back(functionCaller->locals()[index]->index(),
+                           lowerExpression(argumentExpressions[index], signatureArgumentTypes[index]));
+  }
+  std::optional<interpreter::Call::Receiver> receiver{};
+  if (functionCaller->writesBackReceiver()) {
+    // like on the wasm path, only a receiver which can be assigned to observes the modification
+    try {
+      Variable variable = resolveVariable(argumentExpressions.back());
+      uint32_t thisIndex = functionCaller->locals()[signatureArgumentTypes.size() - 1U]->index();
+      receiver = interpreter::Call::Receiver{variable.global_, variable.index_, thisIndex,
+                                             interpreter::slotCount(*variable.type_)};
+    } catch (CannotResolveSymbol const &) {
+    }
+  }
+  return std::make_unique<interpreter::Call>(*functions_.at(functionCaller->name()), std::move(arguments), receiver);
+}
+std::unique_ptr<interpreter::Expression>
+Interpreter::lowerMemberExpression(ast::MemberExpression const *expression,
+                                   std::shared_ptr<ir::VariantType> const &expectedType) {
+  Variable variable = resolveVariable(expression);
+  interpreter::checkConvertible(expectedType, variable.type_);
+  return lowerVariable(variable);
+}
+std::unique_ptr<interpreter::Expression> Interpreter::lowerVariable(Variable const &variable) {
+  return std::make_unique<interpreter::Load>(variable.global_, variable.index_,
+                                             interpreter::slotCount(*variable.type_));
+}
+
+Interpreter::Variable Interpreter::resolveVariable(ast::Expression const *expression) {
+  if (expression->type() == ast::ExpressionType::TypeMemberExpression) {
+    // this.a
+    auto const *memberExpression = static_cast<ast::MemberExpression const *>(expression);
+    Variable object = resolveVariable(memberExpression->expr());
+    if (object.type_->type() == ir::VariantType::Type::Class) {
+      auto const &classType = static_cast<ir::Class const &>(*object.type_);
+      auto position = classType.memberIndex(memberExpression->member());
+      if (position.has_value()) {
+        // members are flattened in declaration order
+        uint32_t offset = object.index_;
+        for (std::size_t index = 0; index < position.value(); index++) {
+          offset += interpreter::slotCount(*classType.member()[index].memberType_);
+        }
+        return Variable{object.global_, offset, classType.member()[position.value()].memberType_};
+      }
+    }
+    throw CannotResolveSymbol{};
+  }
+  if (expression->type() != ast::ExpressionType::TypeIdentifier) {
+    throw CannotResolveSymbol{};
+  }
+  auto symbol = resolver_.resolveIdentifier(static_cast<ast::Identifier const *>(expression));
+  switch (symbol->type()) {
+  case ir::Symbol::Type::TypeLocal:
+    return Variable{false, std::dynamic_pointer_cast<ir::Local>(symbol)->index(), symbol->variantType()};
+  case ir::Symbol::Type::TypeGlobal:
+    return Variable{true, globalOffsets_.at(std::dynamic_pointer_cast<ir::Global>(symbol)->name()),
+                    symbol->variantType()};
+  case ir::Symbol::Type::TypeFunction:
+  case ir::Symbol::Type::TypeMemoryData:
+  case ir::Symbol::Type::TypeStackData:
+    break;
+  }
+  throw std::runtime_error("not support " __FILE__ "#" + std::to_string(__LINE__));
+}
+
+} // namespace walang
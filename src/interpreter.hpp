@@ -0,0 +1,113 @@
+#pragma once
+
+#include "ast/expression.hpp"
+#include "ast/file.hpp"
+#include "ast/statement.hpp"
+#include "declaration_preparer.hpp"
+#include "ir/variant.hpp"
+#include "ir/variant_type.hpp"
+#include "resolver.hpp"
+#include "variant_type_table.hpp"
+#include <binaryen-c.h>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <stack>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace walang {
+
+namespace interpreter {
+/// @brief one underlying value, class values occupy one slot per underlying type
+using Slot = uint64_t;
+class Expression;
+class Statement;
+struct Function;
+} // namespace interpreter
+
+/// @brief execute a program by walking a resolved tree instead of compiling it to wasm
+/// declarations and symbols go through the same `VariantTypeMap` and `Resolver` as `Compiler`, and expressions are
+/// typed by the expected type in the same way, so programs are accepted and evaluated like on the wasm path
+class Interpreter {
+public:
+  /// @brief call depth at which execution stops with a host limit
+  static constexpr uint32_t maxCallDepth = 2048U;
+
+  /// @brief resolve declarations and lower every statement of `files`
+  /// @throw CompilerError like `Compiler::compile`
+  explicit Interpreter(std::vector<std::shared_ptr<ast::File>> files);
+  Interpreter(Interpreter const &) = delete;
+  Interpreter &operator=(Interpreter const &) = delete;
+  ~Interpreter();
+
+  /// @brief execute the top level statements of all files in file order
+  /// @throw binaryen::RuntimeTrap when a trap or the call depth limit is hit
+  void start();
+  /// @brief call a function by its internal name, arguments are parsed by the underlying parameter types
+  /// @return printed result values in the same format as `binaryen::Runner::invoke`
+  std::vector<std::string> invoke(std::string const &name, std::vector<std::string> const &arguments);
+
+private:
+  /// @brief storage of an assignable expression
+  struct Variable {
+    bool global_;
+    uint32_t index_;
+    std::shared_ptr<ir::VariantType> type_;
+  };
+
+  void prepare();
+  std::shared_ptr<ir::Function> doPrepareFunction(DeclarationPreparer::FunctionDeclaration const &declaration);
+  void prepareConstructor(std::shared_ptr<ir::Class> const &classType);
+  interpreter::Function &registerFunction(std::shared_ptr<ir::Function> const &function);
+
+  std::unique_ptr<interpreter::Statement> lowerStatement(ast::Statement const *statement);
+  std::unique_ptr<interpreter::Statement> lowerDeclareStatement(ast::DeclareStatement const *statement);
+  std::unique_ptr<interpreter::Statement> lowerAssignStatement(ast::AssignStatement const *statement);
+  std::unique_ptr<interpreter::Statement> lowerExpressionStatement(ast::ExpressionStatement const *statement);
+  std::unique_ptr<interpreter::Statement> lowerBlockStatement(ast::BlockStatement const *statement);
+  std::unique_ptr<interpreter::Statement> lowerIfStatement(ast::IfStatement const *statement);
+  std::unique_ptr<interpreter::Statement> lowerWhileStatement(ast::WhileStatement const *statement);
+  std::unique_ptr<interpreter::Statement> lowerReturnStatement(ast::ReturnStatement const *statement);
+  std::unique_ptr<interpreter::Statement> lowerClassStatement(ast::ClassStatement const *statement);
+  void lowerFunction(std::string const &name, ast::FunctionStatement const *statement);
+
+  std::unique_ptr<interpreter::Expression> lowerExpression(ast::Expression const *expression,
+                                                           std::shared_ptr<ir::VariantType> const &expectedType);
+  std::unique_ptr<interpreter::Expression> lowerIdentifier(ast::Identifier const *expression,
+                                                           std::shared_ptr<ir::VariantType> const &expectedType);
+  std::unique_ptr<interpreter::Expression>
+  lowerPrefixExpression(ast::PrefixExpression const *expression, std::shared_ptr<ir::VariantType> const &expectedType);
+  std::unique_ptr<interpreter::Expression>
+  lowerBinaryExpression(ast::BinaryExpression const *expression, std::shared_ptr<ir::VariantType> const &expectedType);
+  std::unique_ptr<interpreter::Expression>
+  lowerTernaryExpression(ast::TernaryExpression const *expression,
+                         std::shared_ptr<ir::VariantType> const &expectedType);
+  std::unique_ptr<interpreter::Expression> lowerCallExpression(ast::CallExpression const *expression,
+                                                               std::shared_ptr<ir::VariantType> const &expectedType);
+  std::unique_ptr<interpreter::Expression>
+  lowerMemberExpression(ast::MemberExpression const *expression, std::shared_ptr<ir::VariantType> const &expectedType);
+  std::unique_ptr<interpreter::Expression> lowerVariable(Variable const &variable);
+
+  Variable resolveVariable(ast::Expression const *expression);
+  [[nodiscard]] std::shared_ptr<ir::Function> const &currentFunction() const { return currentFunction_.top(); }
+
+private:
+  std::vector<std::shared_ptr<ast::File>> files_;
+  /// @brief `ir::Function` builds the epilogue of methods eagerly, it is allocated in this module and never emitted
+  BinaryenModuleRef scratchModule_;
+  std::shared_ptr<VariantTypeMap> variantTypeMap_;
+  Resolver resolver_;
+
+  std::stack<std::shared_ptr<ir::Function>> currentFunction_{};
+  std::shared_ptr<ir::Function> startFunction_{};
+  /// @brief lowered functions by their internal name
+  std::map<std::string, std::unique_ptr<interpreter::Function>> functions_{};
+  uint32_t loopDepth_{0U};
+
+  std::unordered_map<std::string, uint32_t> globalOffsets_{};
+  std::vector<interpreter::Slot> globals_{};
+};
+
+} // namespace walang
@@ -2,6 +2,7 @@
 #include "variant_type.hpp"
 #include <algorithm>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -12,27 +13,46 @@ Class::Class(std::string className) : VariantType(Type::Class), className_(std::
 
 std::string Class::to_string() const { return className_; }
 
-BinaryenType Class::underlyingType() const {
+void Class::setMembers(std::vector<ClassMember> members) {
+  member_ = std::move(members);
+  memberIndex_.clear();
+  layout_ = Layout{};
   std::vector<BinaryenType> binaryenTypes{};
   binaryenTypes.reserve(member_.size());
-  for (auto const &member : member_) {
-    auto memberType = member.memberType_->underlyingType();
-    if (memberType != BinaryenTypeNone()) {
-      binaryenTypes.push_back(memberType);
+  for (std::size_t index = 0; index < member_.size(); index++) {
+    auto const &memberType = member_[index].memberType_;
+    memberIndex_.emplace(member_[index].memberName_, index);
+    auto underlyingType = memberType->underlyingType();
+    if (underlyingType != BinaryenTypeNone()) {
+      binaryenTypes.push_back(underlyingType);
     }
+    auto memberUnderlyingTypes = memberType->underlyingTypes();
+    // members are flattened in declaration order
+    layout_.memberIndices_.push_back(static_cast<uint32_t>(layout_.types_.size()));
+    layout_.types_.insert(layout_.types_.end(), memberUnderlyingTypes.begin(), memberUnderlyingTypes.end());
+  }
+  layout_.underlyingType_ = BinaryenTypeCreate(binaryenTypes.data(), binaryenTypes.size());
+  for (auto type : layout_.types_) {
+    auto size = VariantType::getSize(type);
+    layout_.offsets_.push_back(layout_.size_);
+    layout_.sizes_.push_back(size);
+    layout_.size_ += size;
   }
-  return BinaryenTypeCreate(binaryenTypes.data(), binaryenTypes.size());
 }
-std::vector<BinaryenType> Class::underlyingTypes() const {
-  std::vector<BinaryenType> binaryenTypes{};
-  binaryenTypes.reserve(member_.size());
-  for (auto const &member : member_) {
-    auto memberUnderlyingTypeNames = member.memberType_->underlyingTypes();
-    binaryenTypes.insert(binaryenTypes.end(), memberUnderlyingTypeNames.begin(), memberUnderlyingTypeNames.end());
+std::optional<std::size_t> Class::memberIndex(std::string const &memberName) const {
+  auto it = memberIndex_.find(memberName);
+  if (it == memberIndex_.end()) {
+    return std::nullopt;
   }
-  return binaryenTypes;
+  return it->second;
 }
 
+BinaryenType Class::underlyingType() const { return layout_.underlyingType_; }
+bool Class::copyInBulk(BinaryenModuleRef module) const noexcept {
+  return (BinaryenModuleGetFeatures(module) & BinaryenFeatureBulkMemory()) != 0U && layout_.size_ > bulkMemoryMinSize;
+}
+std::vector<BinaryenType> Class::underlyingTypes() const { return layout_.types_; }
+
 BinaryenExpressionRef Class::handlePrefixOp(BinaryenModuleRef module, ast::PrefixOp op,
                                             BinaryenExpressionRef exprRef) const {
   throw std::runtime_error("not support " __FILE__ "#" + std::to_string(__LINE__));
@@ -45,29 +65,27 @@ BinaryenExpressionRef Class::handleBinaryOp(BinaryenModuleRef module, ast::Binar
 std::vector<BinaryenExpressionRef> Class::fromMemoryToLocal(BinaryenModuleRef module, uint32_t localBasisIndex,
                                                             uint32_t memoryPosition) const {
   std::vector<BinaryenExpressionRef> exprRefs{};
-  auto underlyingTypes = this->underlyingTypes();
-  for (uint32_t index = 0; index < underlyingTypes.size(); index++) {
-    auto underlyingType = underlyingTypes[index];
-    auto dataSize = VariantType::getSize(underlyingType);
-    exprRefs.push_back(BinaryenLocalSet(
-        module, localBasisIndex + index,
-        BinaryenLoad(module, dataSize, false, 0, 0, underlyingType,
-                     BinaryenConst(module, BinaryenLiteralInt32(static_cast<int32_t>(memoryPosition))), "0")));
-    memoryPosition += dataSize;
+  exprRefs.reserve(layout_.types_.size());
+  for (uint32_t index = 0; index < layout_.types_.size(); index++) {
+    auto underlyingType = layout_.types_[index];
+    auto position = static_cast<int32_t>(memoryPosition + layout_.offsets_[index]);
+    exprRefs.push_back(BinaryenLocalSet(module, localBasisIndex + index,
+                                        BinaryenLoad(module, layout_.sizes_[index], false, 0, 0, underlyingType,
+                                                     BinaryenConst(module, BinaryenLiteralInt32(position)), "0")));
   }
   return exprRefs;
 }
 std::vector<BinaryenExpressionRef> Class::fromLocalToMemory(BinaryenModuleRef module, uint32_t localBasisIndex,
                                                             uint32_t memoryPosition) const {
   std::vector<BinaryenExpressionRef> exprRefs{};
-  auto underlyingTypes = this->underlyingTypes();
-  for (uint32_t index = 0; index < underlyingTypes.size(); index++) {
-    auto underlyingType = underlyingTypes[index];
-    auto dataSize = VariantType::getSize(underlyingType);
-    exprRefs.push_back(BinaryenStore(
-        module, dataSize, 0, 0, BinaryenConst(module, BinaryenLiteralInt32(static_cast<int32_t>(memoryPosition))),
-        BinaryenLocalGet(module, localBasisIndex + index, underlyingType), underlyingType, "0"));
-    memoryPosition += dataSize;
+  exprRefs.reserve(layout_.types_.size());
+  for (uint32_t index = 0; index < layout_.types_.size(); index++) {
+    auto underlyingType = layout_.types_[index];
+    auto position = static_cast<int32_t>(memoryPosition + layout_.offsets_[index]);
+    exprRefs.push_back(BinaryenStore(module, layout_.sizes_[index], 0, 0,
+                                     BinaryenConst(module, BinaryenLiteralInt32(position)),
+                                     BinaryenLocalGet(module, localBasisIndex + index, underlyingType), underlyingType,
+                                     "0"));
   }
   return exprRefs;
 }
@@ -82,30 +100,27 @@ static std::string getGlobalName(std::string const &globalName, uint32_t index,
 std::vector<BinaryenExpressionRef> Class::fromMemoryToGlobal(BinaryenModuleRef module, std::string const &globalName,
                                                              uint32_t memoryPosition) const {
   std::vector<BinaryenExpressionRef> exprRefs{};
-  auto underlyingTypes = this->underlyingTypes();
-  for (uint32_t index = 0; index < underlyingTypes.size(); index++) {
-    auto underlyingType = underlyingTypes[index];
-    auto dataSize = VariantType::getSize(underlyingType);
-    exprRefs.push_back(BinaryenGlobalSet(
-        module, getGlobalName(globalName, index, underlyingTypes.size()).c_str(),
-        BinaryenLoad(module, dataSize, false, 0, 0, underlyingType,
-                     BinaryenConst(module, BinaryenLiteralInt32(static_cast<int32_t>(memoryPosition))), "0")));
-    memoryPosition += dataSize;
+  exprRefs.reserve(layout_.types_.size());
+  for (uint32_t index = 0; index < layout_.types_.size(); index++) {
+    auto underlyingType = layout_.types_[index];
+    auto position = static_cast<int32_t>(memoryPosition + layout_.offsets_[index]);
+    exprRefs.push_back(BinaryenGlobalSet(module, getGlobalName(globalName, index, layout_.types_.size()).c_str(),
+                                         BinaryenLoad(module, layout_.sizes_[index], false, 0, 0, underlyingType,
+                                                      BinaryenConst(module, BinaryenLiteralInt32(position)), "0")));
   }
   return exprRefs;
 }
 std::vector<BinaryenExpressionRef> Class::fromGlobalToMemory(BinaryenModuleRef module, std::string const &globalName,
                                                              uint32_t memoryPosition) const {
   std::vector<BinaryenExpressionRef> exprRefs{};
-  auto underlyingTypes = this->underlyingTypes();
-  for (uint32_t index = 0; index < underlyingTypes.size(); index++) {
-    auto underlyingType = underlyingTypes[index];
-    auto dataSize = VariantType::getSize(underlyingType);
+  exprRefs.reserve(layout_.types_.size());
+  for (uint32_t index = 0; index < layout_.types_.size(); index++) {
+    auto underlyingType = layout_.types_[index];
+    auto position = static_cast<int32_t>(memoryPosition + layout_.offsets_[index]);
     exprRefs.push_back(BinaryenStore(
-        module, dataSize, 0, 0, BinaryenConst(module, BinaryenLiteralInt32(static_cast<int32_t>(memoryPosition))),
-        BinaryenGlobalGet(module, getGlobalName(globalName, index, underlyingTypes.size()).c_str(), underlyingType),
+        module, layout_.sizes_[index], 0, 0, BinaryenConst(module, BinaryenLiteralInt32(position)),
+        BinaryenGlobalGet(module, getGlobalName(globalName, index, layout_.types_.size()).c_str(), underlyingType),
         underlyingType, "0"));
-    memoryPosition += dataSize;
   }
   return exprRefs;
 }
@@ -8,6 +8,7 @@
 #include <deque>
 #include <memory>
 #include <set>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
@@ -19,13 +20,19 @@ Function::Function(std::string name, std::vector<std::string> const &argumentNam
                    std::shared_ptr<VariantType> const &returnType, std::set<Flag> const &flags,
                    BinaryenModuleRef module)
     : Symbol(Type::TypeFunction, std::make_shared<Signature>(argumentTypes, returnType)), name_(std::move(name)),
-      argumentSize_(argumentNames.size()) {
+      argumentSize_(argumentNames.size()), argumentNames_(argumentNames), flags_(flags),
+      multivalue_(flags.count(Flag::Multivalue) == 1) {
   assert(argumentNames.size() == argumentTypes.size());
   // re-order arguments
   for (std::size_t i = 0; i < argumentSize_; i++) {
-    addLocal(argumentNames[i], argumentTypes[i]);
+    if (hasFlag(Flag::ReferenceReceiver) && i + 1 == argumentSize_) {
+      // `this` is the last argument
+      addReferenceLocal(argumentNames[i], argumentTypes[i]);
+    } else {
+      addLocal(argumentNames[i], argumentTypes[i]);
+    }
   }
-  if (flags.count(Flag::Method) == 1 && flags.count(Flag::Readonly) == 0) {
+  if (writesBackReceiver()) {
     assert(!locals_.empty() && "local should not be empty");
     // any change for `this` should be assigned back
     postExprRefs_ = locals_[locals_.size() - 1]->assignToMemory(
@@ -34,22 +41,59 @@ Function::Function(std::string name, std::vector<std::string> const &argumentNam
 }
 
 std::shared_ptr<Local> Function::addLocal(std::string const &name, std::shared_ptr<VariantType> const &localType) {
+  if (localScopes_.containsInCurrentScope(name)) {
+    throw RedefinedSymbol{name};
+  }
   auto local = locals_.emplace_back(std::make_shared<Local>(localIndex_, name, localType));
+  localScopes_.insert(name, local);
   localIndex_ += localType->underlyingTypes().size();
   return local;
 }
+std::shared_ptr<Local> Function::addReferenceLocal(std::string const &name,
+                                                   std::shared_ptr<VariantType> const &localType) {
+  if (localScopes_.containsInCurrentScope(name)) {
+    throw RedefinedSymbol{name};
+  }
+  auto local = locals_.emplace_back(std::make_shared<Local>(localIndex_, name, localType, true));
+  localScopes_.insert(name, local);
+  localIndex_++;
+  return local;
+}
 std::shared_ptr<Local> Function::addTempLocal(std::shared_ptr<VariantType> const &localType) {
   auto local = locals_.emplace_back(std::make_shared<Local>(localIndex_, localType));
   localIndex_ += localType->underlyingTypes().size();
+  tempLocalCount_++;
   return local;
 }
-std::shared_ptr<Local> Function::findLocalByName(std::string const &name) const {
-  auto it = std::find_if(locals_.cbegin(), locals_.cend(),
-                         [&name](std::shared_ptr<Local> const &local) { return local->name() == name; });
-  if (it != locals_.cend()) {
-    return *it;
+std::shared_ptr<Local> Function::addTupleTempLocal(std::shared_ptr<VariantType> const &localType) {
+  auto local = locals_.emplace_back(std::make_shared<Local>(localIndex_, localType));
+  tupleLocalIndices_.insert(localIndex_);
+  localIndex_++;
+  tempLocalCount_++;
+  return local;
+}
+
+VariantType::UnderlyingReturnTypeStatus Function::underlyingReturnTypeStatus() const {
+  auto status = signature()->returnType()->underlyingReturnTypeStatus();
+  if (status == VariantType::UnderlyingReturnTypeStatus::LoadFromMemory && multivalue_) {
+    return VariantType::UnderlyingReturnTypeStatus::ByTuple;
   }
-  return nullptr;
+  return status;
+}
+BinaryenType Function::underlyingReturnType() const {
+  switch (underlyingReturnTypeStatus()) {
+  case VariantType::UnderlyingReturnTypeStatus::None:
+  case VariantType::UnderlyingReturnTypeStatus::LoadFromMemory:
+    return BinaryenTypeNone();
+  case VariantType::UnderlyingReturnTypeStatus::ByReturnValue:
+    return signature()->returnType()->underlyingType();
+  case VariantType::UnderlyingReturnTypeStatus::ByTuple: {
+    // members of nested classes are flattened into the tuple
+    auto underlyingTypes = signature()->returnType()->underlyingTypes();
+    return BinaryenTypeCreate(underlyingTypes.data(), underlyingTypes.size());
+  }
+  }
+  throw std::runtime_error("not support " __FILE__ "#" + std::to_string(__LINE__));
 }
 
 std::string const &Function::createBreakLabel(std::string const &prefix) {
@@ -83,10 +127,16 @@ BinaryenFunctionRef Function::finalize(BinaryenModuleRef module, BinaryenExpress
   std::vector<BinaryenType> localBinaryenTypes{};
   std::vector<std::string> localNames{};
 
-  auto handleLocal = [](std::shared_ptr<Local> const &local, std::vector<BinaryenType> &binaryenTypes,
-                        std::vector<std::string> &names) {
+  auto handleLocal = [this](std::shared_ptr<Local> const &local, std::vector<BinaryenType> &binaryenTypes,
+                            std::vector<std::string> &names) {
     auto underlyingTypes = local->variantType()->underlyingTypes();
-    if (underlyingTypes.size() == 1) {
+    if (local->isReference()) {
+      binaryenTypes.push_back(BinaryenTypeInt32());
+      names.emplace_back(local->name());
+    } else if (tupleLocalIndices_.count(local->index()) == 1) {
+      binaryenTypes.push_back(BinaryenTypeCreate(underlyingTypes.data(), underlyingTypes.size()));
+      names.emplace_back(local->name());
+    } else if (underlyingTypes.size() == 1) {
       binaryenTypes.push_back(local->variantType()->underlyingType());
       names.emplace_back(local->name());
     } else {
@@ -101,16 +151,7 @@ BinaryenFunctionRef Function::finalize(BinaryenModuleRef module, BinaryenExpress
   }
   BinaryenType argumentBinaryenType = BinaryenTypeCreate(argumentBinaryenTypes.data(), argumentBinaryenTypes.size());
 
-  BinaryenType returnType;
-  switch (signature()->returnType()->underlyingReturnTypeStatus()) {
-  case VariantType::UnderlyingReturnTypeStatus::None:
-  case VariantType::UnderlyingReturnTypeStatus::LoadFromMemory:
-    returnType = BinaryenTypeNone();
-    break;
-  case VariantType::UnderlyingReturnTypeStatus::ByReturnValue:
-    returnType = signature()->returnType()->underlyingType();
-    break;
-  }
+  BinaryenType returnType = underlyingReturnType();
   for (uint32_t i = argumentSize_; i < locals_.size(); i++) {
     handleLocal(locals_[i], localBinaryenTypes, localNames);
   }
@@ -135,6 +176,11 @@ BinaryenFunctionRef Function::finalize(BinaryenModuleRef module, BinaryenExpress
     }
     BinaryenFunctionSetLocalName(funcRef, i, localNames[i - argumentNames.size()].c_str());
   }
+  for (auto const &[expression, location] : debugLocations_) {
+    BinaryenFunctionSetDebugLocation(funcRef, expression, location.first,
+                                     static_cast<BinaryenIndex>(location.second.line),
+                                     static_cast<BinaryenIndex>(location.second.column));
+  }
 
   return funcRef;
 }
@@ -146,7 +192,7 @@ std::vector<BinaryenExpressionRef> Function::finalizeReturn(BinaryenModuleRef mo
   return ret;
 }
 
-void Function::checkArgumentAndReturnType(std::vector<std::shared_ptr<ast::Expression>> const &argumentExpressions,
+void Function::checkArgumentAndReturnType(std::vector<ast::Expression *> const &argumentExpressions,
                                           std::shared_ptr<ir::VariantType> const &expectedReturnType) const {
   if (argumentSize_ != argumentExpressions.size()) {
     auto e = ArgumentCountError(argumentSize_, argumentExpressions.size());
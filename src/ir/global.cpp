@@ -16,19 +16,31 @@ void Global::makeDefinition(BinaryenModuleRef module) {
   }
 }
 
-void Global::initMembers(std::shared_ptr<VariantType> const &type) {
-  if (type->type() == VariantType::Type::Class) {
-    for (auto const &member : std::dynamic_pointer_cast<Class>(type)->member()) {
-      members_.emplace(member.memberName_, std::make_shared<Global>(member.memberName_, member.memberType_));
-    }
-  }
-}
 std::shared_ptr<Global> Global::findMemberByName(std::string const &name) const {
-  auto it = members_.find(name);
-  if (it == members_.end()) {
+  if (variantType_->type() != VariantType::Type::Class) {
+    return nullptr;
+  }
+  auto const &classType = static_cast<Class const &>(*variantType_);
+  auto position = classType.memberIndex(name);
+  if (!position.has_value()) {
     return nullptr;
   }
-  return it->second;
+  auto const &memberType = classType.member()[position.value()].memberType_;
+  uint32_t flattenedIndex = classType.flattenedIndex(position.value());
+  if (firstIndex_.has_value()) {
+    return std::make_shared<Global>(name_, memberType, firstIndex_.value() + flattenedIndex);
+  }
+  if (classType.layout().types_.size() == 1U) {
+    // the only underlying value is not suffixed
+    return std::make_shared<Global>(name_, memberType);
+  }
+  return std::make_shared<Global>(name_, memberType, flattenedIndex);
+}
+std::string Global::underlyingName(uint32_t index) const {
+  if (firstIndex_.has_value()) {
+    return name_ + "#" + std::to_string(firstIndex_.value() + index);
+  }
+  return variantType_->underlyingTypes().size() == 1U ? name_ : name_ + "#" + std::to_string(index);
 }
 
 std::vector<BinaryenExpressionRef> Global::assignToMemory(BinaryenModuleRef module,
@@ -38,12 +50,8 @@ std::vector<BinaryenExpressionRef> Global::assignToMemory(BinaryenModuleRef modu
   uint32_t offset = 0;
   for (uint32_t index = 0; index < underlyingTypes.size(); index++) {
     auto dataSize = VariantType::getSize(underlyingTypes[index]);
-    auto globalName = underlyingTypes.size() == 1 ? name_ : name_ + "#" + std::to_string(index);
-    auto loadExpr = BinaryenGlobalGet(module, globalName.c_str(), underlyingTypes[index]);
-    auto storeExpr = BinaryenStore(
-        module, dataSize, 0, 0,
-        BinaryenConst(module, BinaryenLiteralInt32(static_cast<int32_t>(memoryData.memoryPosition() + offset))),
-        loadExpr, underlyingTypes[index], "0");
+    auto loadExpr = BinaryenGlobalGet(module, underlyingName(index).c_str(), underlyingTypes[index]);
+    auto storeExpr = memoryData.store(module, offset, loadExpr, underlyingTypes[index]);
     exprRefs.push_back(storeExpr);
     offset += dataSize;
   }
@@ -55,8 +63,7 @@ std::vector<BinaryenExpressionRef> Global::assignToLocal(BinaryenModuleRef modul
   uint32_t offset = 0;
   for (uint32_t index = 0; index < underlyingTypes.size(); index++) {
     auto dataSize = VariantType::getSize(underlyingTypes[index]);
-    auto globalName = underlyingTypes.size() == 1 ? name_ : name_ + "#" + std::to_string(index);
-    auto loadExpr = BinaryenGlobalGet(module, globalName.c_str(), underlyingTypes[index]);
+    auto loadExpr = BinaryenGlobalGet(module, underlyingName(index).c_str(), underlyingTypes[index]);
     auto storeExpr = BinaryenLocalSet(module, local.index() + index, loadExpr);
     exprRefs.push_back(storeExpr);
     offset += dataSize;
@@ -69,10 +76,8 @@ std::vector<BinaryenExpressionRef> Global::assignToGlobal(BinaryenModuleRef modu
   uint32_t offset = 0;
   for (uint32_t index = 0; index < underlyingTypes.size(); index++) {
     auto dataSize = VariantType::getSize(underlyingTypes[index]);
-    auto globalName = underlyingTypes.size() == 1 ? name_ : name_ + "#" + std::to_string(index);
-    auto loadExpr = BinaryenGlobalGet(module, globalName.c_str(), underlyingTypes[index]);
-    globalName = underlyingTypes.size() == 1 ? global.name() : global.name() + "#" + std::to_string(index);
-    auto storeExpr = BinaryenGlobalSet(module, globalName.c_str(), loadExpr);
+    auto loadExpr = BinaryenGlobalGet(module, underlyingName(index).c_str(), underlyingTypes[index]);
+    auto storeExpr = BinaryenGlobalSet(module, global.underlyingName(index).c_str(), loadExpr);
     exprRefs.push_back(storeExpr);
     offset += dataSize;
   }
@@ -82,8 +87,7 @@ std::vector<BinaryenExpressionRef> Global::assignToStack(BinaryenModuleRef modul
   std::vector<BinaryenExpressionRef> exprRefs{};
   auto underlyingTypes = variantType_->underlyingTypes();
   for (uint32_t index = 0; index < underlyingTypes.size(); index++) {
-    auto globalName = underlyingTypes.size() == 1 ? name_ : name_ + "#" + std::to_string(index);
-    auto loadExpr = BinaryenGlobalGet(module, globalName.c_str(), underlyingTypes[index]);
+    auto loadExpr = BinaryenGlobalGet(module, underlyingName(index).c_str(), underlyingTypes[index]);
     exprRefs.push_back(loadExpr);
   }
   return exprRefs;
@@ -1,23 +1,26 @@
 #include "binaryen/utils.hpp"
 #include "variant.hpp"
+#include <cassert>
+#include <memory>
 
 namespace walang::ir {
 
-void Local::initMembers(std::shared_ptr<VariantType> const &type) {
-  if (type->type() == VariantType::Type::Class) {
-    uint32_t index = index_;
-    for (auto const &member : std::dynamic_pointer_cast<Class>(type)->member()) {
-      members_.emplace(member.memberName_, std::make_shared<Local>(index, member.memberName_, member.memberType_));
-      index++;
-    }
-  }
-}
 std::shared_ptr<Local> Local::findMemberByName(std::string const &name) const {
-  auto it = members_.find(name);
-  if (it == members_.end()) {
+  if (variantType_->type() != VariantType::Type::Class) {
+    return nullptr;
+  }
+  auto const &classType = static_cast<Class const &>(*variantType_);
+  auto position = classType.memberIndex(name);
+  if (!position.has_value()) {
     return nullptr;
   }
-  return it->second;
+  return std::make_shared<Local>(index_ + classType.flattenedIndex(position.value()), name,
+                                 classType.member()[position.value()].memberType_);
+}
+
+std::shared_ptr<MemoryData> Local::dereference() const {
+  assert(reference_);
+  return std::make_shared<MemoryData>(index_, 0U, variantType_);
 }
 
 std::vector<BinaryenExpressionRef> Local::assignToMemory(BinaryenModuleRef module, MemoryData const &memoryData) const {
@@ -27,10 +30,7 @@ std::vector<BinaryenExpressionRef> Local::assignToMemory(BinaryenModuleRef modul
   for (uint32_t index = 0; index < underlyingTypes.size(); index++) {
     auto dataSize = VariantType::getSize(underlyingTypes[index]);
     auto loadExpr = BinaryenLocalGet(module, index_ + index, underlyingTypes[index]);
-    auto storeExpr = BinaryenStore(
-        module, dataSize, 0, 0,
-        BinaryenConst(module, BinaryenLiteralInt32(static_cast<int32_t>(memoryData.memoryPosition() + offset))),
-        loadExpr, underlyingTypes[index], "0");
+    auto storeExpr = memoryData.store(module, offset, loadExpr, underlyingTypes[index]);
     exprRefs.push_back(storeExpr);
     offset += dataSize;
   }
@@ -56,8 +56,7 @@ std::vector<BinaryenExpressionRef> Local::assignToGlobal(BinaryenModuleRef modul
   for (uint32_t index = 0; index < underlyingTypes.size(); index++) {
     auto dataSize = VariantType::getSize(underlyingTypes[index]);
     auto loadExpr = BinaryenLocalGet(module, index_ + index, underlyingTypes[index]);
-    auto globalName = underlyingTypes.size() == 1 ? global.name() : global.name() + "#" + std::to_string(index);
-    auto storeExpr = BinaryenGlobalSet(module, globalName.c_str(), loadExpr);
+    auto storeExpr = BinaryenGlobalSet(module, global.underlyingName(index).c_str(), loadExpr);
     exprRefs.push_back(storeExpr);
     offset += dataSize;
   }
@@ -1,23 +1,74 @@
 #include "binaryen/utils.hpp"
 #include "variant.hpp"
+#include <memory>
+#include <string>
 #include <vector>
 
 namespace walang::ir {
 
+std::shared_ptr<MemoryData> MemoryData::findMemberByName(std::string const &name) const {
+  if (variantType_->type() != VariantType::Type::Class) {
+    return nullptr;
+  }
+  auto const &classType = static_cast<Class const &>(*variantType_);
+  auto position = classType.memberIndex(name);
+  if (!position.has_value()) {
+    return nullptr;
+  }
+  uint32_t flattenedIndex = classType.flattenedIndex(position.value());
+  auto const &layout = classType.layout();
+  uint32_t offset = flattenedIndex < layout.offsets_.size() ? layout.offsets_[flattenedIndex] : layout.size_;
+  auto const &memberType = classType.member()[position.value()].memberType_;
+  if (baseLocal_.has_value()) {
+    return std::make_shared<MemoryData>(baseLocal_.value(), memoryPosition_ + offset, memberType);
+  }
+  return std::make_shared<MemoryData>(memoryPosition_ + offset, memberType);
+}
+
+BinaryenExpressionRef MemoryData::pointer(BinaryenModuleRef module) const {
+  auto position = BinaryenConst(module, BinaryenLiteralInt32(static_cast<int32_t>(memoryPosition_)));
+  if (!baseLocal_.has_value()) {
+    return position;
+  }
+  auto base = BinaryenLocalGet(module, baseLocal_.value(), BinaryenTypeInt32());
+  return memoryPosition_ == 0 ? base : BinaryenBinary(module, BinaryenAddInt32(), base, position);
+}
+BinaryenExpressionRef MemoryData::load(BinaryenModuleRef module, uint32_t offset, BinaryenType type) const {
+  auto bytes = VariantType::getSize(type);
+  if (baseLocal_.has_value()) {
+    return BinaryenLoad(module, bytes, false, memoryPosition_ + offset, 0, type,
+                        BinaryenLocalGet(module, baseLocal_.value(), BinaryenTypeInt32()), "0");
+  }
+  return BinaryenLoad(module, bytes, false, 0, 0, type,
+                      BinaryenConst(module, BinaryenLiteralInt32(static_cast<int32_t>(memoryPosition_ + offset))), "0");
+}
+BinaryenExpressionRef MemoryData::store(BinaryenModuleRef module, uint32_t offset, BinaryenExpressionRef value,
+                                        BinaryenType type) const {
+  auto bytes = VariantType::getSize(type);
+  if (baseLocal_.has_value()) {
+    return BinaryenStore(module, bytes, memoryPosition_ + offset, 0,
+                         BinaryenLocalGet(module, baseLocal_.value(), BinaryenTypeInt32()), value, type, "0");
+  }
+  return BinaryenStore(module, bytes, 0, 0,
+                       BinaryenConst(module, BinaryenLiteralInt32(static_cast<int32_t>(memoryPosition_ + offset))),
+                       value, type, "0");
+}
+
 std::vector<BinaryenExpressionRef> MemoryData::assignToMemory(BinaryenModuleRef module,
                                                               MemoryData const &memoryData) const {
+  if (variantType_->type() == VariantType::Type::Class) {
+    auto const &classType = static_cast<Class const &>(*variantType_);
+    if (classType.copyInBulk(module)) {
+      auto size = BinaryenConst(module, BinaryenLiteralInt32(static_cast<int32_t>(classType.layout().size_)));
+      return {BinaryenMemoryCopy(module, memoryData.pointer(module), pointer(module), size, "0", "0")};
+    }
+  }
   std::vector<BinaryenExpressionRef> exprRefs{};
   auto underlyingTypes = variantType_->underlyingTypes();
   uint32_t offset = 0;
   for (unsigned long underlyingType : underlyingTypes) {
     auto bytes = VariantType::getSize(underlyingType);
-    auto loadExpr =
-        BinaryenLoad(module, bytes, false, 0, 0, underlyingType,
-                     BinaryenConst(module, BinaryenLiteralInt32(static_cast<int32_t>(memoryPosition_ + offset))), "0");
-    auto storeExpr = BinaryenStore(
-        module, bytes, 0, 0,
-        BinaryenConst(module, BinaryenLiteralInt32(static_cast<int32_t>(memoryData.memoryPosition() + offset))),
-        loadExpr, underlyingType, "0");
+    auto storeExpr = memoryData.store(module, offset, load(module, offset, underlyingType), underlyingType);
     exprRefs.push_back(storeExpr);
     offset += bytes;
   }
@@ -29,9 +80,7 @@ std::vector<BinaryenExpressionRef> MemoryData::assignToLocal(BinaryenModuleRef m
   uint32_t offset = 0;
   for (uint32_t index = 0; index < underlyingTypes.size(); index++) {
     auto bytes = VariantType::getSize(underlyingTypes[index]);
-    auto loadExpr =
-        BinaryenLoad(module, bytes, false, 0, 0, underlyingTypes[index],
-                     BinaryenConst(module, BinaryenLiteralInt32(static_cast<int32_t>(memoryPosition_ + offset))), "0");
+    auto loadExpr = load(module, offset, underlyingTypes[index]);
     auto storeExpr = BinaryenLocalSet(module, local.index() + index, loadExpr);
     exprRefs.push_back(storeExpr);
     offset += bytes;
@@ -44,11 +93,8 @@ std::vector<BinaryenExpressionRef> MemoryData::assignToGlobal(BinaryenModuleRef
   uint32_t offset = 0;
   for (uint32_t index = 0; index < underlyingTypes.size(); index++) {
     auto bytes = VariantType::getSize(underlyingTypes[index]);
-    auto loadExpr =
-        BinaryenLoad(module, bytes, false, 0, 0, underlyingTypes[index],
-                     BinaryenConst(module, BinaryenLiteralInt32(static_cast<int32_t>(memoryPosition_ + offset))), "0");
-    auto globalName = underlyingTypes.size() == 1 ? global.name() : global.name() + "#" + std::to_string(index);
-    auto storeExpr = BinaryenGlobalSet(module, globalName.c_str(), loadExpr);
+    auto loadExpr = load(module, offset, underlyingTypes[index]);
+    auto storeExpr = BinaryenGlobalSet(module, global.underlyingName(index).c_str(), loadExpr);
     exprRefs.push_back(storeExpr);
     offset += bytes;
   }
@@ -60,10 +106,7 @@ std::vector<BinaryenExpressionRef> MemoryData::assignToStack(BinaryenModuleRef m
   uint32_t offset = 0;
   for (BinaryenType underlyingType : underlyingTypes) {
     auto bytes = VariantType::getSize(underlyingType);
-    auto loadExpr =
-        BinaryenLoad(module, bytes, false, 0, 0, underlyingType,
-                     BinaryenConst(module, BinaryenLiteralInt32(static_cast<int32_t>(memoryPosition_ + offset))), "0");
-    exprRefs.push_back(loadExpr);
+    exprRefs.push_back(load(module, offset, underlyingType));
     offset += bytes;
   }
   return exprRefs;
@@ -18,10 +18,7 @@ std::vector<BinaryenExpressionRef> StackData::assignToMemory(BinaryenModuleRef m
     BinaryenIndex blockIndex = exprRef_.size() - underlyingTypes.size() + index;
     auto underlyingType = underlyingTypes[index];
     auto bytes = VariantType::getSize(underlyingType);
-    result[blockIndex] = BinaryenStore(
-        module, bytes, 0, 0,
-        BinaryenConst(module, BinaryenLiteralInt32(static_cast<int32_t>(memoryData.memoryPosition() + offset))),
-        result[blockIndex], underlyingType, "0");
+    result[blockIndex] = memoryData.store(module, offset, result[blockIndex], underlyingType);
 
     offset += bytes;
   }
@@ -51,8 +48,7 @@ std::vector<BinaryenExpressionRef> StackData::assignToGlobal(BinaryenModuleRef m
   auto result = exprRef_;
   for (uint32_t index = 0; index < underlyingTypes.size(); index++) {
     BinaryenIndex blockIndex = exprRef_.size() - underlyingTypes.size() + index;
-    auto globalName = underlyingTypes.size() == 1U ? global.name() : global.name() + "#" + std::to_string(index);
-    result[blockIndex] = BinaryenGlobalSet(module, globalName.c_str(), result[blockIndex]);
+    result[blockIndex] = BinaryenGlobalSet(module, global.underlyingName(index).c_str(), result[blockIndex]);
   }
   return result;
 }
@@ -1,9 +1,12 @@
 #pragma once
 
 #include "ast/statement.hpp"
+#include "helper/scoped_symbol_table.hpp"
 #include "ir/variant_type.hpp"
 #include <binaryen-c.h>
 #include <cstdint>
+#include <map>
+#include <optional>
 #include <set>
 #include <string>
 #include <utility>
@@ -58,12 +61,16 @@ protected:
 class Global : public Variant {
 public:
   Global(std::string name, std::shared_ptr<VariantType> const &type)
-      : Variant(std::move(name), Type::TypeGlobal, type) {
-    initMembers(type);
-  }
+      : Variant(std::move(name), Type::TypeGlobal, type) {}
+  /// @brief member of a global whose underlying values are `name#firstIndex` and the following ones
+  Global(std::string name, std::shared_ptr<VariantType> const &type, uint32_t firstIndex)
+      : Variant(std::move(name), Type::TypeGlobal, type), firstIndex_{firstIndex} {}
   ~Global() override = default;
   void makeDefinition(BinaryenModuleRef module);
+  /// @brief members are created on demand from the class layout
   [[nodiscard]] std::shared_ptr<Global> findMemberByName(std::string const &name) const;
+  /// @brief name of the wasm global holding the underlying value `index`
+  [[nodiscard]] std::string underlyingName(uint32_t index) const;
 
   std::vector<BinaryenExpressionRef> assignToMemory(BinaryenModuleRef module,
                                                     MemoryData const &memoryData) const override;
@@ -72,22 +79,22 @@ public:
   std::vector<BinaryenExpressionRef> assignToStack(BinaryenModuleRef module) const override;
 
 private:
-  std::map<std::string, std::shared_ptr<Global>> members_{};
-  void initMembers(std::shared_ptr<VariantType> const &type);
+  std::optional<uint32_t> firstIndex_{};
 };
 
 class Local : public Variant {
 public:
-  Local(uint32_t index, std::shared_ptr<VariantType> const &type) : Variant("", Type::TypeLocal, type), index_{index} {
-    initMembers(type);
-  }
-  Local(uint32_t index, std::string name, std::shared_ptr<VariantType> const &type)
-      : Variant(std::move(name), Type::TypeLocal, type), index_{index} {
-    initMembers(type);
-  }
+  Local(uint32_t index, std::shared_ptr<VariantType> const &type) : Variant("", Type::TypeLocal, type), index_{index} {}
+  Local(uint32_t index, std::string name, std::shared_ptr<VariantType> const &type, bool reference = false)
+      : Variant(std::move(name), Type::TypeLocal, type), index_{index}, reference_{reference} {}
   ~Local() override = default;
 
   [[nodiscard]] uint32_t index() const noexcept { return index_; }
+  /// @brief the local holds an i32 pointer to the value in memory instead of the value
+  [[nodiscard]] bool isReference() const noexcept { return reference_; }
+  /// @brief value which a reference local points to
+  [[nodiscard]] std::shared_ptr<MemoryData> dereference() const;
+  /// @brief members are created on demand from the class layout
   [[nodiscard]] std::shared_ptr<Local> findMemberByName(std::string const &name) const;
 
   std::vector<BinaryenExpressionRef> assignToMemory(BinaryenModuleRef module,
@@ -98,16 +105,29 @@ public:
 
 private:
   uint32_t index_;
-  std::map<std::string, std::shared_ptr<Local>> members_{};
-  void initMembers(std::shared_ptr<VariantType> const &type);
+  bool reference_{false};
 };
 
 class MemoryData : public Variant {
 public:
   MemoryData(uint32_t memoryPosition, std::shared_ptr<VariantType> const &type)
       : Variant("MemoryData", Type::TypeMemoryData, type), memoryPosition_{memoryPosition} {}
+  /// @brief data at `memoryPosition` bytes after the pointer held by local `baseLocal`
+  MemoryData(uint32_t baseLocal, uint32_t memoryPosition, std::shared_ptr<VariantType> const &type)
+      : Variant("MemoryData", Type::TypeMemoryData, type), baseLocal_{baseLocal}, memoryPosition_{memoryPosition} {}
 
+  [[nodiscard]] std::optional<uint32_t> baseLocal() const noexcept { return baseLocal_; }
   [[nodiscard]] uint32_t memoryPosition() const noexcept { return memoryPosition_; }
+  /// @brief members are created on demand from the class layout
+  [[nodiscard]] std::shared_ptr<MemoryData> findMemberByName(std::string const &name) const;
+
+  /// @brief i32 address of the data
+  [[nodiscard]] BinaryenExpressionRef pointer(BinaryenModuleRef module) const;
+  /// @brief load `type` at `offset` bytes after the data
+  [[nodiscard]] BinaryenExpressionRef load(BinaryenModuleRef module, uint32_t offset, BinaryenType type) const;
+  /// @brief store `value` of `type` at `offset` bytes after the data
+  [[nodiscard]] BinaryenExpressionRef store(BinaryenModuleRef module, uint32_t offset, BinaryenExpressionRef value,
+                                            BinaryenType type) const;
 
   std::vector<BinaryenExpressionRef> assignToMemory(BinaryenModuleRef module,
                                                     MemoryData const &memoryData) const override;
@@ -116,6 +136,7 @@ public:
   std::vector<BinaryenExpressionRef> assignToStack(BinaryenModuleRef module) const override;
 
 private:
+  std::optional<uint32_t> baseLocal_{};
   uint32_t memoryPosition_;
 };
 
@@ -140,7 +161,7 @@ private:
 
 class Function : public Symbol {
 public:
-  enum class Flag { Method, Readonly };
+  enum class Flag { Method, Readonly, Multivalue, ReferenceReceiver, Constructor, Inline, NoInline };
 
 public:
   Function(std::string name, std::vector<std::string> const &argumentNames,
@@ -152,13 +173,39 @@ public:
     return std::dynamic_pointer_cast<Signature>(variantType_);
   }
   [[nodiscard]] std::vector<std::shared_ptr<Local>> const &locals() const noexcept { return locals_; }
+  [[nodiscard]] std::vector<std::string> const &argumentNames() const noexcept { return argumentNames_; }
+  [[nodiscard]] bool hasFlag(Flag flag) const { return flags_.count(flag) == 1; }
+  [[nodiscard]] std::set<Flag> const &flags() const noexcept { return flags_; }
+  /// @brief `this` is modified in memory through a pointer with `Flag::ReferenceReceiver`, otherwise it is passed by
+  /// value and written back to memory after the return value for the caller to reload
+  [[nodiscard]] bool writesBackReceiver() const {
+    return hasFlag(Flag::Method) && !hasFlag(Flag::Readonly) && !hasFlag(Flag::ReferenceReceiver);
+  }
+  /// @brief call sites lower `expression` with the arguments bound to their names instead of calling the function
+  void setInlineExpression(ast::Expression const *expression) noexcept { inlineExpression_ = expression; }
+  /// @brief expression returned by the whole body of an inlined function, nullptr when calls are not inlined
+  [[nodiscard]] ast::Expression const *inlineExpression() const noexcept { return inlineExpression_; }
+  /// @brief how the result is passed to the caller, multi-value results are returned as a tuple with
+  /// `Flag::Multivalue` instead of through memory
+  [[nodiscard]] VariantType::UnderlyingReturnTypeStatus underlyingReturnTypeStatus() const;
+  /// @brief result type of the wasm function
+  [[nodiscard]] BinaryenType underlyingReturnType() const;
 
   std::shared_ptr<Class> thisClassType() { return thisClassType_.lock(); }
   void setThisClassType(std::shared_ptr<Class> const &thisClassType) { thisClassType_ = thisClassType; }
 
   std::shared_ptr<Local> addLocal(std::string const &name, std::shared_ptr<VariantType> const &localType);
   std::shared_ptr<Local> addTempLocal(std::shared_ptr<VariantType> const &localType);
-  [[nodiscard]] std::shared_ptr<Local> findLocalByName(std::string const &name) const;
+  /// @brief temporary local which holds all underlying values of `localType` as one tuple
+  std::shared_ptr<Local> addTupleTempLocal(std::shared_ptr<VariantType> const &localType);
+  [[nodiscard]] uint32_t tempLocalCount() const noexcept { return tempLocalCount_; }
+  /// @brief find the innermost local visible in current scope
+  [[nodiscard]] std::shared_ptr<Local> findLocalByName(std::string const &name) const {
+    return localScopes_.find(name);
+  }
+  /// @brief locals declared in block are invisible after the block
+  void enterScope() { localScopes_.enterScope(); }
+  void exitScope() { localScopes_.exitScope(); }
 
   std::string const &createBreakLabel(std::string const &prefix);
   [[nodiscard]] std::string const &topBreakLabel() const;
@@ -167,18 +214,31 @@ public:
   [[nodiscard]] std::string const &topContinueLabel() const;
   void freeContinueLabel();
 
+  /// @brief source position of `expression` which is attached by `finalize`, the first position of an expression wins
+  void addDebugLocation(BinaryenExpressionRef expression, BinaryenIndex fileIndex, ast::Position const &position) {
+    debugLocations_.emplace(expression, std::make_pair(fileIndex, position));
+  }
+
   BinaryenFunctionRef finalize(BinaryenModuleRef module, BinaryenExpressionRef body);
   std::vector<BinaryenExpressionRef> finalizeReturn(BinaryenModuleRef module, BinaryenExpressionRef returnExpr);
 
-  void checkArgumentAndReturnType(std::vector<std::shared_ptr<ast::Expression>> const &argumentExpressions,
+  void checkArgumentAndReturnType(std::vector<ast::Expression *> const &argumentExpressions,
                                   std::shared_ptr<ir::VariantType> const &expectedReturnType) const;
 
 private:
+  std::shared_ptr<Local> addReferenceLocal(std::string const &name, std::shared_ptr<VariantType> const &localType);
+
   std::string name_;
   uint32_t argumentSize_;
+  std::vector<std::string> argumentNames_;
+  std::set<Flag> flags_;
+  bool multivalue_;
 
   std::vector<std::shared_ptr<Local>> locals_{};
+  std::set<uint32_t> tupleLocalIndices_{};
+  ScopedSymbolTable<Local> localScopes_{};
   uint32_t localIndex_{0U};
+  uint32_t tempLocalCount_{0U};
 
   std::weak_ptr<Class> thisClassType_{};
 
@@ -188,6 +248,8 @@ private:
   uint32_t continueLabelIndex_{0U};
 
   std::vector<BinaryenExpressionRef> postExprRefs_{};
+  ast::Expression const *inlineExpression_{nullptr};
+  std::map<BinaryenExpressionRef, std::pair<BinaryenIndex, ast::Position>> debugLocations_{};
 };
 
 } // namespace walang::ir
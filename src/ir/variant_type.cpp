@@ -56,17 +56,45 @@ uint32_t VariantType::getSize(BinaryenType t) {
 
 std::shared_ptr<VariantType> VariantType::from(BinaryenType t) {
   if (t == BinaryenTypeInt32()) {
-    return std::make_shared<TypeI32>();
+    return primitive(Type::I32);
   } else if (t == BinaryenTypeInt64()) {
-    return std::make_shared<TypeI64>();
+    return primitive(Type::I64);
   } else if (t == BinaryenTypeFloat32()) {
-    return std::make_shared<TypeF32>();
+    return primitive(Type::F32);
   } else if (t == BinaryenTypeFloat64()) {
-    return std::make_shared<TypeF64>();
+    return primitive(Type::F64);
   } else {
     throw std::runtime_error("not support " __FILE__ "#" + std::to_string(__LINE__));
   }
 }
+std::shared_ptr<VariantType> const &VariantType::primitive(Type type) {
+  // function local statics are initialized thread safe
+  static std::shared_ptr<VariantType> const i32 = std::make_shared<TypeI32>();
+  static std::shared_ptr<VariantType> const u32 = std::make_shared<TypeU32>();
+  static std::shared_ptr<VariantType> const i64 = std::make_shared<TypeI64>();
+  static std::shared_ptr<VariantType> const u64 = std::make_shared<TypeU64>();
+  static std::shared_ptr<VariantType> const f32 = std::make_shared<TypeF32>();
+  static std::shared_ptr<VariantType> const f64 = std::make_shared<TypeF64>();
+  static std::shared_ptr<VariantType> const none = std::make_shared<TypeNone>();
+  switch (type) {
+  case Type::I32:
+    return i32;
+  case Type::U32:
+    return u32;
+  case Type::I64:
+    return i64;
+  case Type::U64:
+    return u64;
+  case Type::F32:
+    return f32;
+  case Type::F64:
+    return f64;
+  case Type::None:
+    return none;
+  default:
+    throw std::runtime_error("not primitive type " + std::string{magic_enum::enum_name(type)});
+  }
+}
 [[nodiscard]] VariantType::UnderlyingReturnTypeStatus VariantType::underlyingReturnTypeStatus() const {
   if (underlyingType() == BinaryenTypeNone()) {
     return UnderlyingReturnTypeStatus::None;
@@ -7,7 +7,9 @@
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace walang::ir {
@@ -36,11 +38,14 @@ public:
   virtual std::string to_string() const;
 
   [[nodiscard]] static std::shared_ptr<VariantType> from(BinaryenType t);
+  /// @brief primitive types are stateless, every compiler shares one instance of each
+  [[nodiscard]] static std::shared_ptr<VariantType> const &primitive(Type type);
   [[nodiscard]] static uint32_t getSize(BinaryenType t);
 
   virtual BinaryenType underlyingType() const = 0;
   [[nodiscard]] virtual std::vector<BinaryenType> underlyingTypes() const { return {underlyingType()}; }
-  enum class UnderlyingReturnTypeStatus { None, LoadFromMemory, ByReturnValue };
+  /// @brief `ByTuple` is only chosen by functions compiled with the multi-value ABI
+  enum class UnderlyingReturnTypeStatus { None, LoadFromMemory, ByReturnValue, ByTuple };
   [[nodiscard]] UnderlyingReturnTypeStatus underlyingReturnTypeStatus() const;
   BinaryenExpressionRef underlyingDefaultValue(BinaryenModuleRef module) const;
   BinaryenExpressionRef underlyingConst(BinaryenModuleRef module, int64_t value) const;
@@ -209,8 +214,26 @@ public:
     std::shared_ptr<VariantType> memberType_;
   };
 
+  /// @brief flattened underlying types of all members and their position in memory
+  struct Layout {
+    std::vector<BinaryenType> types_{};
+    std::vector<uint32_t> offsets_{};
+    std::vector<uint32_t> sizes_{};
+    /// @brief index in `types_` of the first underlying type of each member
+    std::vector<uint32_t> memberIndices_{};
+    uint32_t size_{0U};
+    BinaryenType underlyingType_{};
+  };
+
+  /// @brief mutating methods of classes larger than this many bytes get a pointer to the receiver
+  static constexpr uint32_t referenceReceiverMinSize = 16U;
+  /// @brief classes larger than this many bytes are copied and zeroed by `memory.copy` and `memory.fill` when the
+  /// module enables bulk memory
+  static constexpr uint32_t bulkMemoryMinSize = 16U;
+
   explicit Class(std::string className);
-  void setMembers(std::vector<ClassMember> members) { member_ = std::move(members); }
+  /// @brief seal the class, member types must be sealed before
+  void setMembers(std::vector<ClassMember> members);
   void setMethodMap(std::map<std::string, std::shared_ptr<Function>> methodMap) { methodMap_ = std::move(methodMap); }
 
   std::string to_string() const override;
@@ -224,6 +247,13 @@ public:
                                        std::shared_ptr<Function> const &function) override;
   [[nodiscard]] std::string const &className() const { return className_; }
   [[nodiscard]] std::vector<ClassMember> const &member() const { return member_; }
+  [[nodiscard]] std::optional<std::size_t> memberIndex(std::string const &memberName) const;
+  /// @brief index of the first underlying type of member `position` in the flattened layout
+  [[nodiscard]] uint32_t flattenedIndex(std::size_t position) const { return layout_.memberIndices_[position]; }
+  [[nodiscard]] Layout const &layout() const noexcept { return layout_; }
+  /// @brief copying the receiver in and back out costs more than passing its address
+  [[nodiscard]] bool passReceiverByReference() const noexcept { return layout_.size_ > referenceReceiverMinSize; }
+  [[nodiscard]] bool copyInBulk(BinaryenModuleRef module) const noexcept;
   [[nodiscard]] std::map<std::string, std::shared_ptr<Function>> const &methodMap() { return methodMap_; }
 
   [[nodiscard]] std::vector<BinaryenExpressionRef> fromMemoryToLocal(BinaryenModuleRef module, uint32_t localBasisIndex,
@@ -238,6 +268,8 @@ public:
 private:
   std::string className_;
   std::vector<ClassMember> member_{};
+  std::unordered_map<std::string, std::size_t> memberIndex_{};
+  Layout layout_{};
   std::map<std::string, std::shared_ptr<Function>> methodMap_{};
 };
 
@@ -1,118 +1,305 @@
 #include "parser.hpp"
 #include "ast/expression.hpp"
 #include "ast/file.hpp"
+#include "ast/op.hpp"
 #include "ast/statement.hpp"
-#include "generated/walangBaseListener.h"
 #include "generated/walangLexer.h"
 #include "generated/walangParser.h"
 #include <cassert>
+#include <cstdint>
 #include <iostream>
 #include <memory>
-#include <unordered_map>
+#include <optional>
+#include <stdexcept>
+#include <string>
 #include <utility>
+#include <vector>
 
 namespace walang {
 
-class Listener : public walangBaseListener {
+/// @brief build AST by walking the parse tree top-down, children are returned to parents directly
+class AstBuilder {
 public:
-  explicit Listener(std::shared_ptr<ast::File> file) : file_(std::move(file)) {}
+  explicit AstBuilder(ast::File &file) : file_(file), arena_(file.arena()) {}
 
-  void exitWalang(walangParser::WalangContext *ctx) override { file_->update(ctx, astNodes_); }
+  void buildFile(walangParser::WalangContext *ctx) {
+    std::vector<ast::Statement *> statements{};
+    for (walangParser::StatementContext *statementCtx : ctx->statement()) {
+      statements.push_back(buildStatement(statementCtx));
+    }
+    file_.setStatements(std::move(statements));
+  }
+
+private:
+  ast::File &file_;
+  Arena &arena_;
 
-  void exitStatement(walangParser::StatementContext *ctx) override {
+  ast::Statement *buildStatement(walangParser::StatementContext *ctx) {
     auto *child = dynamic_cast<antlr4::ParserRuleContext *>(ctx->children.at(0));
-    assert(astNodes_.count(child) == 1);
-    astNodes_.emplace(ctx, astNodes_.find(child)->second);
-    astNodes_.find(child)->second->setRange(file_, ctx);
-  }
-  void exitDeclareStatement(walangParser::DeclareStatementContext *ctx) override {
-    astNodes_.emplace(ctx, std::make_shared<ast::DeclareStatement>(ctx, astNodes_));
-  }
-  void exitAssignStatement(walangParser::AssignStatementContext *ctx) override {
-    astNodes_.emplace(ctx, std::make_shared<ast::AssignStatement>(ctx, astNodes_));
-  }
-  void exitExpressionStatement(walangParser::ExpressionStatementContext *ctx) override {
-    astNodes_.emplace(ctx, std::make_shared<ast::ExpressionStatement>(ctx, astNodes_));
-  }
-  void exitBlockStatement(walangParser::BlockStatementContext *ctx) override {
-    astNodes_.emplace(ctx, std::make_shared<ast::BlockStatement>(ctx, astNodes_));
-  }
-  void exitIfStatement(walangParser::IfStatementContext *ctx) override {
-    astNodes_.emplace(ctx, std::make_shared<ast::IfStatement>(ctx, astNodes_));
-  }
-  void exitWhileStatement(walangParser::WhileStatementContext *ctx) override {
-    astNodes_.emplace(ctx, std::make_shared<ast::WhileStatement>(ctx, astNodes_));
+    assert(child != nullptr);
+    ast::Statement *statement = nullptr;
+    switch (child->getRuleIndex()) {
+    case walangParser::RuleExpressionStatement:
+      statement = arena_.make<ast::ExpressionStatement>(
+          buildExpression(static_cast<walangParser::ExpressionStatementContext *>(child)->expression()));
+      break;
+    case walangParser::RuleDeclareStatement:
+      statement = buildDeclareStatement(static_cast<walangParser::DeclareStatementContext *>(child));
+      break;
+    case walangParser::RuleAssignStatement: {
+      auto *assignCtx = static_cast<walangParser::AssignStatementContext *>(child);
+      ast::Expression *varExpr = buildExpression(assignCtx->expression(0));
+      statement = arena_.make<ast::AssignStatement>(varExpr, buildExpression(assignCtx->expression(1)));
+      break;
+    }
+    case walangParser::RuleBlockStatement:
+      statement = buildBlockStatement(static_cast<walangParser::BlockStatementContext *>(child));
+      break;
+    case walangParser::RuleIfStatement:
+      statement = buildIfStatement(static_cast<walangParser::IfStatementContext *>(child));
+      break;
+    case walangParser::RuleWhileStatement: {
+      auto *whileCtx = static_cast<walangParser::WhileStatementContext *>(child);
+      ast::Expression *condition = buildExpression(whileCtx->expression());
+      statement = arena_.make<ast::WhileStatement>(condition, buildBlockStatement(whileCtx->blockStatement()));
+      break;
+    }
+    case walangParser::RuleBreakStatement:
+      statement = arena_.make<ast::BreakStatement>();
+      break;
+    case walangParser::RuleContinueStatement:
+      statement = arena_.make<ast::ContinueStatement>();
+      break;
+    case walangParser::RuleReturnStatement:
+      statement = arena_.make<ast::ReturnStatement>(
+          buildExpression(static_cast<walangParser::ReturnStatementContext *>(child)->expression()));
+      break;
+    case walangParser::RuleFunctionStatement:
+      statement = buildFunctionStatement(static_cast<walangParser::FunctionStatementContext *>(child));
+      break;
+    case walangParser::RuleClassStatement:
+      statement = buildClassStatement(static_cast<walangParser::ClassStatementContext *>(child));
+      break;
+    default:
+      throw std::runtime_error("not support " __FILE__ "#" + std::to_string(__LINE__));
+    }
+    statement->setRange(&file_, ctx);
+    return statement;
   }
-  void exitBreakStatement(walangParser::BreakStatementContext *ctx) override {
-    astNodes_.emplace(ctx, std::make_shared<ast::BreakStatement>());
+  ast::DeclareStatement *buildDeclareStatement(walangParser::DeclareStatementContext *ctx) {
+    std::string variantType{};
+    if (ctx->type()) {
+      variantType = ctx->type()->Identifier()->getText();
+    }
+    return arena_.make<ast::DeclareStatement>(ctx->Identifier()->getText(), std::move(variantType),
+                                              buildExpression(ctx->expression()));
   }
-  void exitContinueStatement(walangParser::ContinueStatementContext *ctx) override {
-    astNodes_.emplace(ctx, std::make_shared<ast::ContinueStatement>());
+  ast::BlockStatement *buildBlockStatement(walangParser::BlockStatementContext *ctx) {
+    std::vector<ast::Statement *> statements{};
+    for (walangParser::StatementContext *statementCtx : ctx->statement()) {
+      statements.push_back(buildStatement(statementCtx));
+    }
+    return arena_.make<ast::BlockStatement>(std::move(statements));
   }
-  void exitReturnStatement(walangParser::ReturnStatementContext *ctx) override {
-    astNodes_.emplace(ctx, std::make_shared<ast::ReturnStatement>(ctx, astNodes_));
+  ast::IfStatement *buildIfStatement(walangParser::IfStatementContext *ctx) {
+    ast::Expression *condition = buildExpression(ctx->expression());
+    auto blockStatements = ctx->blockStatement();
+    assert(!blockStatements.empty());
+    ast::BlockStatement *thenBlock = buildBlockStatement(blockStatements.at(0));
+    ast::Statement *elseBlock = nullptr;
+    if (blockStatements.size() == 2U) {
+      // if - then - else
+      elseBlock = thenBlock;
+    } else if (ctx->ifStatement() != nullptr) {
+      // if - then - else if ...
+      elseBlock = buildIfStatement(ctx->ifStatement());
+    }
+    return arena_.make<ast::IfStatement>(condition, thenBlock, elseBlock);
   }
-  void exitFunctionStatement(walangParser::FunctionStatementContext *ctx) override {
-    astNodes_.emplace(ctx, std::make_shared<ast::FunctionStatement>(ctx, astNodes_));
+  ast::FunctionStatement *buildFunctionStatement(walangParser::FunctionStatementContext *ctx) {
+    std::vector<std::string> decorators{};
+    for (walangParser::DecoratorContext *decorator : ctx->decorator()) {
+      decorators.push_back(decorator->Identifier()->getText());
+    }
+    std::vector<ast::FunctionStatement::Argument> arguments{};
+    for (walangParser::ParameterContext *parameterCtx : ctx->parameterList()->parameter()) {
+      arguments.push_back(
+          ast::FunctionStatement::Argument{parameterCtx->Identifier()->getText(), parameterCtx->type()->getText()});
+    }
+    std::optional<std::string> returnType =
+        ctx->type() == nullptr ? std::nullopt : std::optional<std::string>{ctx->type()->getText()};
+    return arena_.make<ast::FunctionStatement>(ctx->Identifier()->getText(), std::move(arguments),
+                                               std::move(decorators), std::move(returnType),
+                                               buildBlockStatement(ctx->blockStatement()));
   }
-  void exitClassStatement(walangParser::ClassStatementContext *ctx) override {
-    astNodes_.emplace(ctx, std::make_shared<ast::ClassStatement>(ctx, astNodes_));
+  ast::ClassStatement *buildClassStatement(walangParser::ClassStatementContext *ctx) {
+    std::vector<ast::ClassStatement::Member> members{};
+    for (walangParser::MemberContext *memberCtx : ctx->member()) {
+      members.push_back(ast::ClassStatement::Member{memberCtx->Identifier()->getText(), memberCtx->type()->getText()});
+    }
+    std::vector<ast::FunctionStatement *> methods{};
+    for (walangParser::FunctionStatementContext *functionCtx : ctx->functionStatement()) {
+      methods.push_back(buildFunctionStatement(functionCtx));
+    }
+    return arena_.make<ast::ClassStatement>(ctx->Identifier()->getText(), std::move(members), std::move(methods));
   }
 
-  void exitExpression(walangParser::ExpressionContext *ctx) override {
-    auto *child = dynamic_cast<antlr4::ParserRuleContext *>(ctx->children.at(0));
-    assert(astNodes_.count(child) == 1);
-    astNodes_.emplace(ctx, astNodes_.find(child)->second);
+  ast::Expression *buildExpression(walangParser::ExpressionContext *ctx) {
+    if (ctx->prefixExpression() != nullptr) {
+      return buildPrefixExpression(ctx->prefixExpression());
+    }
+    ast::Expression *expr = buildBinaryExpression(ctx->binaryExpression());
+    if (walangParser::TernaryExpressionBodyContext *body = ctx->ternaryExpressionBody()) {
+      ast::Expression *leftExpr = buildExpression(body->expression(0));
+      expr = arena_.make<ast::TernaryExpression>(expr, leftExpr, buildExpression(body->expression(1)));
+      expr->setRange(&file_, ctx);
+    }
+    return expr;
   }
-  void exitIdentifier(walangParser::IdentifierContext *ctx) override {
-    astNodes_.emplace(ctx, std::make_shared<ast::Identifier>(ctx, astNodes_));
-    astNodes_.find(ctx)->second->setRange(file_, ctx);
+  ast::Identifier *buildIdentifier(walangParser::IdentifierContext *ctx) {
+    ast::Identifier *identifier = nullptr;
+    if (ctx->Identifier() != nullptr) {
+      identifier = arena_.make<ast::Identifier>(ctx->getText());
+    } else if (ctx->IntNumber() != nullptr) {
+      identifier = arena_.make<ast::Identifier>(static_cast<uint64_t>(std::stoull(ctx->getText())));
+    } else if (ctx->HexNumber() != nullptr) {
+      identifier = arena_.make<ast::Identifier>(static_cast<uint64_t>(std::stoull(ctx->getText(), nullptr, 16)));
+    } else if (ctx->FloatNumber() != nullptr) {
+      identifier = arena_.make<ast::Identifier>(std::stod(ctx->getText()));
+    } else {
+      throw std::runtime_error("not support " __FILE__ "#" + std::to_string(__LINE__));
+    }
+    identifier->setRange(&file_, ctx);
+    return identifier;
   }
-  void exitBinaryExpression(walangParser::BinaryExpressionContext *ctx) override {
-    astNodes_.emplace(ctx, std::make_shared<ast::BinaryExpression>(ctx, astNodes_));
-    astNodes_.find(ctx)->second->setRange(file_, ctx);
+  ast::PrefixExpression *buildPrefixExpression(walangParser::PrefixExpressionContext *ctx) {
+    auto *expr = arena_.make<ast::PrefixExpression>(ast::Operator::getOp(ctx->prefixOperator()),
+                                                    buildExpression(ctx->expression()));
+    expr->setRange(&file_, ctx);
+    return expr;
   }
-  void exitTernaryExpression(walangParser::TernaryExpressionContext *ctx) override {
-    astNodes_.emplace(ctx, std::make_shared<ast::TernaryExpression>(ctx, astNodes_));
-    astNodes_.find(ctx)->second->setRange(file_, ctx);
+  ast::Expression *buildParenthesesExpression(walangParser::ParenthesesExpressionContext *ctx) {
+    // parentheses do not create node, the inner expression takes the range of parentheses
+    ast::Expression *expr = buildExpression(ctx->expression());
+    expr->setRange(&file_, ctx);
+    return expr;
   }
-  void exitPrefixExpression(walangParser::PrefixExpressionContext *ctx) override {
-    astNodes_.emplace(ctx, std::make_shared<ast::PrefixExpression>(ctx, astNodes_));
-    astNodes_.find(ctx)->second->setRange(file_, ctx);
+  ast::Expression *buildBinaryExpression(walangParser::BinaryExpressionContext *ctx) {
+    ast::Expression *leftExpr = buildCallOrMemberExpression(ctx->callOrMemberExpression());
+    std::vector<walangParser::BinaryExpressionRightWithOpContext *> rightWithOps = ctx->binaryExpressionRightWithOp();
+    if (rightWithOps.empty()) {
+      return leftExpr;
+    }
+    std::vector<std::pair<ast::BinaryOp, ast::Expression *>> rightExprs{};
+    rightExprs.reserve(rightWithOps.size());
+    for (walangParser::BinaryExpressionRightWithOpContext *rightWithOp : rightWithOps) {
+      rightExprs.emplace_back(ast::Operator::getOp(rightWithOp->binaryOperator()),
+                              buildBinaryOperand(rightWithOp->binaryOperand()));
+    }
+    auto *expr = arena_.make<ast::BinaryExpression>(leftExpr, rightExprs, arena_);
+    expr->setRange(&file_, ctx);
+    return expr;
   }
-  void exitParenthesesExpression(walangParser::ParenthesesExpressionContext *ctx) override {
-    assert(astNodes_.count(ctx->expression()) == 1);
-    astNodes_.emplace(ctx, astNodes_.find(ctx->expression())->second);
-    astNodes_.find(ctx)->second->setRange(file_, ctx);
+  ast::Expression *buildBinaryOperand(walangParser::BinaryOperandContext *ctx) {
+    if (ctx->prefixOperator() != nullptr) {
+      auto *expr = arena_.make<ast::PrefixExpression>(ast::Operator::getOp(ctx->prefixOperator()),
+                                                      buildBinaryOperand(ctx->binaryOperand()));
+      expr->setRange(&file_, ctx);
+      return expr;
+    }
+    return buildCallOrMemberExpression(ctx->callOrMemberExpression());
   }
-  void exitCallExpression(walangParser::CallExpressionContext *ctx) override {
-    astNodes_.emplace(ctx, std::make_shared<ast::CallExpression>(ctx, astNodes_));
-    astNodes_.find(ctx)->second->setRange(file_, ctx);
+  /// @brief nested call and member expressions in the chain have no range
+  ast::Expression *buildCallOrMemberExpression(walangParser::CallOrMemberExpressionContext *ctx) {
+    walangParser::CallOrMemberExpressionLeftContext *leftCtx = ctx->callOrMemberExpressionLeft();
+    ast::Expression *expr = nullptr;
+    if (leftCtx->identifier()) {
+      expr = buildIdentifier(leftCtx->identifier());
+    } else if (leftCtx->parenthesesExpression()) {
+      expr = buildParenthesesExpression(leftCtx->parenthesesExpression());
+    } else {
+      throw std::runtime_error("not support " __FILE__ "#" + std::to_string(__LINE__));
+    }
+    std::vector<walangParser::CallOrMemberExpressionRightContext *> rights = ctx->callOrMemberExpressionRight();
+    if (rights.empty()) {
+      return expr;
+    }
+    for (walangParser::CallOrMemberExpressionRightContext *rightCtx : rights) {
+      if (rightCtx->callExpressionRight()) {
+        expr = arena_.make<ast::CallExpression>(expr, buildArguments(rightCtx->callExpressionRight()));
+      } else if (rightCtx->memberExpressionRight()) {
+        expr = arena_.make<ast::MemberExpression>(expr, rightCtx->memberExpressionRight()->Identifier()->getText());
+      } else {
+        throw std::runtime_error("not support " __FILE__ "#" + std::to_string(__LINE__));
+      }
+    }
+    expr->setRange(&file_, ctx);
+    return expr;
   }
-  void exitMemberExpression(walangParser::MemberExpressionContext *ctx) override {
-    astNodes_.emplace(ctx, std::make_shared<ast::MemberExpression>(ctx, astNodes_));
-    astNodes_.find(ctx)->second->setRange(file_, ctx);
+  std::vector<ast::Expression *> buildArguments(walangParser::CallExpressionRightContext *ctx) {
+    std::vector<ast::Expression *> arguments{};
+    for (walangParser::ExpressionContext *exprCtx : ctx->expression()) {
+      arguments.push_back(buildExpression(exprCtx));
+    }
+    return arguments;
   }
+};
 
-  void visitErrorNode(antlr4::tree::ErrorNode *node) override {
-    std::cerr << "unexpected " << node->getText() << std::endl;
-    std::terminate();
+static antlr4::tree::ErrorNode *findErrorNode(antlr4::tree::ParseTree *tree) {
+  if (auto *errorNode = dynamic_cast<antlr4::tree::ErrorNode *>(tree)) {
+    return errorNode;
+  }
+  for (antlr4::tree::ParseTree *child : tree->children) {
+    if (auto *errorNode = findErrorNode(child)) {
+      return errorNode;
+    }
   }
+  return nullptr;
+}
 
-private:
-  std::shared_ptr<ast::File> file_;
-  std::unordered_map<antlr4::ParserRuleContext *, std::shared_ptr<ast::Node>> astNodes_;
-};
+/// @brief parse with SLL prediction and bail out on the first error, the parser is reset for full LL on failure
+static walangParser::WalangContext *parseSll(walangParser &parser) {
+  auto *interpreter = parser.getInterpreter<antlr4::atn::ParserATNSimulator>();
+  parser.removeErrorListeners();
+  parser.setErrorHandler(std::make_shared<antlr4::BailErrorStrategy>());
+  interpreter->setPredictionMode(antlr4::atn::PredictionMode::SLL);
+  walangParser::WalangContext *tree = nullptr;
+  try {
+    tree = parser.walang();
+  } catch (antlr4::ParseCancellationException const &) {
+    parser.reset();
+  }
+  parser.addErrorListener(&antlr4::ConsoleErrorListener::INSTANCE);
+  parser.setErrorHandler(std::make_shared<antlr4::DefaultErrorStrategy>());
+  interpreter->setPredictionMode(antlr4::atn::PredictionMode::LL);
+  return tree;
+}
 
 std::shared_ptr<ast::File> FileParser::parse() {
   auto file = std::make_shared<ast::File>(filename_);
-  antlr4::ANTLRInputStream inputStream(content_);
-  walangLexer lexer(&inputStream);
-  antlr4::CommonTokenStream tokens(&lexer);
-  walangParser parser(&tokens);
-  Listener listener(file);
-  antlr4::tree::ParseTreeWalker::DEFAULT.walk(&listener, parser.walang());
+  {
+    // parse tree, tokens and input are only needed until the AST is built
+    antlr4::ANTLRInputStream inputStream(content_);
+    walangLexer lexer(&inputStream);
+    antlr4::CommonTokenStream tokens(&lexer);
+    walangParser parser(&tokens);
+    walangParser::WalangContext *tree = sllFirst_ ? parseSll(parser) : nullptr;
+    if (tree == nullptr) {
+      // syntax error or input beyond SLL, full LL gives the precise result and error messages
+      tree = parser.walang();
+    }
+    if (parser.getNumberOfSyntaxErrors() > 0U) {
+      // recovered errors like a missing token leave no error node but the tree is still incomplete
+      if (antlr4::tree::ErrorNode *errorNode = findErrorNode(tree)) {
+        std::cerr << "unexpected " << errorNode->getText() << std::endl;
+      } else {
+        std::cerr << parser.getNumberOfSyntaxErrors() << " syntax errors in " << filename_ << std::endl;
+      }
+      std::terminate();
+    }
+    AstBuilder{*file}.buildFile(tree);
+  }
   return file;
 }
 
-} // namespace walang
\ No newline at end of file
+} // namespace walang
@@ -13,9 +13,13 @@ public:
 
   std::shared_ptr<ast::File> parse();
 
+  /// @brief try SLL prediction before falling back to full LL, enabled by default
+  void setSllFirst(bool sllFirst) noexcept { sllFirst_ = sllFirst; }
+
 private:
   std::string filename_;
   std::string content_;
+  bool sllFirst_{true};
 };
 
 } // namespace walang
\ No newline at end of file
@@ -0,0 +1,186 @@
+#include "profile.hpp"
+#include "binaryen/runner.hpp"
+#include "wasm.h"
+#include <algorithm>
+#include <binaryen-c.h>
+#include <cstdint>
+#include <exception>
+#include <fmt/core.h>
+#include <istream>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace walang {
+
+namespace {
+
+std::optional<Profile::Kind> parseKind(std::string const &kind) {
+  if (kind == "call") {
+    return Profile::Kind::Call;
+  }
+  if (kind == "loop") {
+    return Profile::Kind::Loop;
+  }
+  return std::nullopt;
+}
+
+} // namespace
+
+std::optional<InstrumentOptions> InstrumentOptions::parse(std::string const &kinds) {
+  InstrumentOptions options{};
+  std::istringstream kindStream{kinds};
+  for (std::string kind; std::getline(kindStream, kind, ',');) {
+    if (kind == "calls") {
+      options.calls_ = true;
+    } else if (kind == "loops") {
+      options.loops_ = true;
+    } else {
+      return std::nullopt;
+    }
+  }
+  if (!options.enabled()) {
+    return std::nullopt;
+  }
+  return options;
+}
+
+Profile Profile::collect(BinaryenModuleRef module, binaryen::Runner &runner) {
+  Profile profile{};
+  for (auto const &section : reinterpret_cast<wasm::Module *>(module)->customSections) {
+    if (section.name != ProfileCounters::sectionName) {
+      continue;
+    }
+    std::istringstream names{std::string{section.data.begin(), section.data.end()}};
+    uint32_t index = 0U;
+    for (std::string line; std::getline(names, line); index++) {
+      std::istringstream lineStream{line};
+      std::string kind{};
+      std::string name{};
+      lineStream >> kind >> name;
+      auto counts = runner.invoke(ProfileCounters::dumpFunction, {std::to_string(index)});
+      profile.add(Counter{parseKind(kind).value_or(Kind::Call), name, std::stoull(counts.front())});
+    }
+  }
+  return profile;
+}
+
+Profile Profile::read(std::istream &is) {
+  Profile profile{};
+  uint32_t lineNumber = 0U;
+  for (std::string line; std::getline(is, line);) {
+    lineNumber++;
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream lineStream{line};
+    std::vector<std::string> fields{};
+    for (std::string field; lineStream >> field;) {
+      fields.push_back(field);
+    }
+    try {
+      if (fields.size() == 3U && parseKind(fields[0]).has_value()) {
+        profile.add(Counter{parseKind(fields[0]).value(), fields[1], std::stoull(fields[2])});
+        continue;
+      }
+      if (fields.size() == 2U) {
+        // folded stack of a sampling profiler, samples are attributed to the leaf frame
+        std::string const &stack = fields[0];
+        std::size_t leafStart = stack.rfind(';');
+        std::string leaf = leafStart == std::string::npos ? stack : stack.substr(leafStart + 1U);
+        uint64_t count = std::stoull(fields[1]);
+        if (leaf.rfind("loop@", 0) == 0 && leafStart != std::string::npos) {
+          std::size_t functionStart = stack.rfind(';', leafStart - 1U);
+          functionStart = functionStart == std::string::npos ? 0U : functionStart + 1U;
+          profile.add(Counter{Kind::Loop, stack.substr(functionStart, leafStart - functionStart) + leaf.substr(4U),
+                              count});
+        } else {
+          profile.add(Counter{Kind::Call, leaf, count});
+        }
+        continue;
+      }
+    } catch (std::exception const &) {
+    }
+    throw std::runtime_error(fmt::format("malformed profile line {}: {}", lineNumber, line));
+  }
+  return profile;
+}
+
+void Profile::write(std::ostream &os) const {
+  for (Counter const &counter : counters_) {
+    os << fmt::format("{} {} {}\n", kindName(counter.kind_), counter.name_, counter.count_);
+  }
+}
+
+void Profile::writeReport(std::ostream &os) const {
+  std::vector<Counter> sorted{counters_};
+  std::stable_sort(sorted.begin(), sorted.end(),
+                   [](Counter const &a, Counter const &b) { return a.count_ > b.count_; });
+  os << fmt::format("{:>16}  {:<4}  {}\n", "count", "kind", "name");
+  for (Counter const &counter : sorted) {
+    os << fmt::format("{:>16}  {:<4}  {}\n", counter.count_, kindName(counter.kind_), counter.name_);
+  }
+}
+
+void Profile::writeFolded(std::ostream &os) const {
+  for (Counter const &counter : counters_) {
+    if (counter.count_ == 0U) {
+      continue;
+    }
+    if (counter.kind_ == Kind::Call) {
+      os << fmt::format("{} {}\n", counter.name_, counter.count_);
+    } else {
+      // `function@line:column` becomes the frame `loop@line:column` under `function`
+      auto at = counter.name_.rfind('@');
+      os << fmt::format("{};loop{} {}\n", counter.name_.substr(0, at), counter.name_.substr(at), counter.count_);
+    }
+  }
+}
+
+BinaryenExpressionRef ProfileCounters::increment(BinaryenModuleRef module, Profile::Kind kind,
+                                                 std::string const &name) {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    counters_.emplace(kind, name);
+  }
+  std::string global = globalName(kind, name);
+  return BinaryenGlobalSet(module, global.c_str(),
+                           BinaryenBinary(module, BinaryenAddInt64(),
+                                          BinaryenGlobalGet(module, global.c_str(), BinaryenTypeInt64()),
+                                          BinaryenConst(module, BinaryenLiteralInt64(1))));
+}
+
+void ProfileCounters::finalize(BinaryenModuleRef module) const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  std::string names{};
+  std::vector<BinaryenExpressionRef> cases{};
+  BinaryenIndex index = 0U;
+  for (auto const &[kind, name] : counters_) {
+    std::string global = globalName(kind, name);
+    BinaryenAddGlobal(module, global.c_str(), BinaryenTypeInt64(), true,
+                      BinaryenConst(module, BinaryenLiteralInt64(0)));
+    names += fmt::format("{} {}\n", Profile::kindName(kind), name);
+    BinaryenExpressionRef isIndex =
+        BinaryenBinary(module, BinaryenEqInt32(), BinaryenLocalGet(module, 0, BinaryenTypeInt32()),
+                       BinaryenConst(module, BinaryenLiteralInt32(static_cast<int32_t>(index))));
+    cases.push_back(BinaryenIf(
+        module, isIndex, BinaryenReturn(module, BinaryenGlobalGet(module, global.c_str(), BinaryenTypeInt64())),
+        nullptr));
+    index++;
+  }
+  cases.push_back(BinaryenConst(module, BinaryenLiteralInt64(0)));
+  BinaryenAddFunction(module, dumpFunction, BinaryenTypeInt32(), BinaryenTypeInt64(), nullptr, 0,
+                      BinaryenBlock(module, nullptr, cases.data(), cases.size(), BinaryenTypeInt64()));
+  BinaryenAddFunctionExport(module, dumpFunction, dumpFunction);
+  BinaryenAddCustomSection(module, sectionName, names.data(), names.size());
+}
+
+std::string ProfileCounters::globalName(Profile::Kind kind, std::string const &name) {
+  return fmt::format("walang$profile#{}#{}", Profile::kindName(kind), name);
+}
+
+} // namespace walang
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "binaryen/runner.hpp"
+#include <binaryen-c.h>
+#include <cstdint>
+#include <istream>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace walang {
+
+/// @brief counters emitted by `--instrument`
+struct InstrumentOptions {
+  /// @brief count function entries
+  bool calls_{false};
+  /// @brief count loop back-edges, including `continue`
+  bool loops_{false};
+
+  /// @brief parse a comma separated list of `calls` and `loops`
+  static std::optional<InstrumentOptions> parse(std::string const &kinds);
+  [[nodiscard]] bool enabled() const noexcept { return calls_ || loops_; }
+};
+
+/// @brief execution counts of functions and loops
+/// the text format has one `call <function> <count>` or `loop <function>@<line>:<column> <count>` per line, folded
+/// stacks `<frame>;...;<frame> <count>` of sampling profilers are read as well
+class Profile {
+public:
+  enum class Kind { Call, Loop };
+  struct Counter {
+    Kind kind_;
+    std::string name_;
+    uint64_t count_;
+  };
+
+  static char const *kindName(Kind kind) noexcept { return kind == Kind::Call ? "call" : "loop"; }
+
+  /// @brief read the counters of an instrumented module after it was executed by `runner`
+  static Profile collect(BinaryenModuleRef module, binaryen::Runner &runner);
+  /// @throw std::runtime_error when a line is malformed
+  static Profile read(std::istream &is);
+
+  [[nodiscard]] std::vector<Counter> const &counters() const noexcept { return counters_; }
+  void add(Counter counter) { counters_.push_back(std::move(counter)); }
+
+  void write(std::ostream &os) const;
+  /// @brief counters ordered by count, hottest first
+  void writeReport(std::ostream &os) const;
+  /// @brief flamegraph folded stacks, loops are nested under their function
+  void writeFolded(std::ostream &os) const;
+
+private:
+  std::vector<Counter> counters_{};
+};
+
+/// @brief counters referenced by an instrumented compilation, shared by the lowering workers
+/// every counter is an i64 global, `finalize` adds the globals, the exported dump function which returns the counter
+/// of an index and a custom section which names the counters in index order
+class ProfileCounters {
+public:
+  static constexpr char const *dumpFunction = "walang$profileCounter";
+  static constexpr char const *sectionName = "walang.profile";
+
+  /// @brief increment counter `name`, the counter is registered on first use
+  BinaryenExpressionRef increment(BinaryenModuleRef module, Profile::Kind kind, std::string const &name);
+  void finalize(BinaryenModuleRef module) const;
+
+private:
+  mutable std::mutex mutex_{};
+  std::set<std::pair<Profile::Kind, std::string>> counters_{};
+
+  static std::string globalName(Profile::Kind kind, std::string const &name);
+};
+
+} // namespace walang
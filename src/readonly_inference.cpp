@@ -0,0 +1,198 @@
+#include "readonly_inference.hpp"
+#include "ast/expression.hpp"
+#include "ast/statement.hpp"
+#include "ir/variant.hpp"
+#include "ir/variant_type.hpp"
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace walang {
+
+char const *ReadonlyInference::resultName(Result result) noexcept {
+  switch (result) {
+  case Result::Declared:
+    return "declared";
+  case Result::Violated:
+    return "violated";
+  case Result::Inferred:
+    return "inferred";
+  case Result::Modifying:
+    return "modifying";
+  }
+  return "";
+}
+
+void ReadonlyInference::addClass(ast::ClassStatement const &statement, std::shared_ptr<ir::Class> const &classType) {
+  for (ast::FunctionStatement const *method : statement.methods()) {
+    std::string name = classType->className() + "#" + method->name();
+    bool declared = std::count(method->decorators().begin(), method->decorators().end(), "readonly") > 0;
+    indexes_.emplace(name, methods_.size());
+    Method &result = methods_.emplace_back(Method{std::move(name), declared, Result::Inferred, std::nullopt});
+    Candidate &candidate = candidates_.emplace_back(Candidate{method, classType});
+    collect(result, candidate, method->body());
+  }
+}
+
+void ReadonlyInference::run() {
+  std::vector<bool> modifying{};
+  modifying.reserve(methods_.size());
+  for (Method const &method : methods_) {
+    modifying.push_back(method.modification_.has_value());
+  }
+  // modifications spread from callees to callers until nothing changes
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (std::size_t index = 0; index < methods_.size(); index++) {
+      if (modifying[index]) {
+        continue;
+      }
+      for (auto const &[callee, range] : candidates_[index].calls_) {
+        auto it = indexes_.find(callee);
+        if (it == indexes_.end()) {
+          // unknown methods are reported when the call is lowered
+          continue;
+        }
+        std::size_t calleeIndex = it->second;
+        // `@readonly` callees never write `this` back, whatever they do with their copy
+        if (modifying[calleeIndex] && !methods_[calleeIndex].declared_) {
+          modifying[index] = true;
+          methods_[index].modification_ = range;
+          changed = true;
+          break;
+        }
+      }
+    }
+  }
+  for (std::size_t index = 0; index < methods_.size(); index++) {
+    if (methods_[index].declared_) {
+      methods_[index].result_ = modifying[index] ? Result::Violated : Result::Declared;
+    } else {
+      methods_[index].result_ = modifying[index] ? Result::Modifying : Result::Inferred;
+    }
+  }
+}
+
+bool ReadonlyInference::isInferred(std::string const &name) const {
+  auto it = indexes_.find(name);
+  return it != indexes_.end() && methods_[it->second].result_ == Result::Inferred;
+}
+
+void ReadonlyInference::collect(Method &method, Candidate &candidate, ast::Statement const *statement) {
+  if (statement == nullptr) {
+    return;
+  }
+  switch (statement->type()) {
+  case ast::TypeDeclareStatement:
+    collect(method, candidate, static_cast<ast::DeclareStatement const *>(statement)->init());
+    break;
+  case ast::TypeAssignStatement: {
+    auto const *assignStatement = static_cast<ast::AssignStatement const *>(statement);
+    if (!method.modification_.has_value() && thisMemberType(candidate, assignStatement->variant()) != nullptr) {
+      method.modification_ = statement->range();
+    }
+    collect(method, candidate, assignStatement->value());
+    break;
+  }
+  case ast::TypeExpressionStatement:
+    collect(method, candidate, static_cast<ast::ExpressionStatement const *>(statement)->expr());
+    break;
+  case ast::TypeBlockStatement:
+    for (ast::Statement const *child : static_cast<ast::BlockStatement const *>(statement)->statements()) {
+      collect(method, candidate, child);
+    }
+    break;
+  case ast::TypeIfStatement: {
+    auto const *ifStatement = static_cast<ast::IfStatement const *>(statement);
+    collect(method, candidate, ifStatement->condition());
+    collect(method, candidate, ifStatement->thenBlock());
+    // else block may share the then block node
+    if (ifStatement->elseBlock() != ifStatement->thenBlock()) {
+      collect(method, candidate, ifStatement->elseBlock());
+    }
+    break;
+  }
+  case ast::TypeWhileStatement:
+    collect(method, candidate, static_cast<ast::WhileStatement const *>(statement)->condition());
+    collect(method, candidate, static_cast<ast::WhileStatement const *>(statement)->block());
+    break;
+  case ast::TypeReturnStatement:
+    collect(method, candidate, static_cast<ast::ReturnStatement const *>(statement)->expr());
+    break;
+  case ast::TypeFunctionStatement:
+  case ast::TypeClassStatement:
+  case ast::TypeBreakStatement:
+  case ast::TypeContinueStatement:
+    break;
+  }
+}
+
+void ReadonlyInference::collect(Method &method, Candidate &candidate, ast::Expression const *expression) {
+  if (expression == nullptr) {
+    return;
+  }
+  switch (expression->type()) {
+  case ast::TypeIdentifier:
+    break;
+  case ast::TypePrefixExpression:
+    collect(method, candidate, static_cast<ast::PrefixExpression const *>(expression)->expr());
+    break;
+  case ast::TypeBinaryExpression:
+    collect(method, candidate, static_cast<ast::BinaryExpression const *>(expression)->leftExpr());
+    collect(method, candidate, static_cast<ast::BinaryExpression const *>(expression)->rightExpr());
+    break;
+  case ast::TypeTernaryExpression:
+    collect(method, candidate, static_cast<ast::TernaryExpression const *>(expression)->conditionExpr());
+    collect(method, candidate, static_cast<ast::TernaryExpression const *>(expression)->leftExpr());
+    collect(method, candidate, static_cast<ast::TernaryExpression const *>(expression)->rightExpr());
+    break;
+  case ast::TypeCallExpression: {
+    auto const *callExpression = static_cast<ast::CallExpression const *>(expression);
+    if (callExpression->caller()->type() == ast::TypeMemberExpression) {
+      auto const *caller = static_cast<ast::MemberExpression const *>(callExpression->caller());
+      auto receiverType = std::dynamic_pointer_cast<ir::Class>(thisMemberType(candidate, caller->expr()));
+      if (receiverType != nullptr) {
+        candidate.calls_.emplace_back(receiverType->className() + "#" + caller->member(), expression->range());
+      }
+    }
+    collect(method, candidate, callExpression->caller());
+    for (ast::Expression const *argument : callExpression->arguments()) {
+      collect(method, candidate, argument);
+    }
+    break;
+  }
+  case ast::TypeMemberExpression:
+    collect(method, candidate, static_cast<ast::MemberExpression const *>(expression)->expr());
+    break;
+  }
+}
+
+std::shared_ptr<ir::VariantType> ReadonlyInference::thisMemberType(Candidate const &candidate,
+                                                                   ast::Expression const *expression) const {
+  if (expression->type() == ast::TypeIdentifier) {
+    auto const *name = std::get_if<std::string>(&static_cast<ast::Identifier const *>(expression)->identifier());
+    if (name != nullptr && *name == "this") {
+      return candidate.classType_;
+    }
+    return nullptr;
+  }
+  if (expression->type() != ast::TypeMemberExpression) {
+    return nullptr;
+  }
+  auto const *memberExpression = static_cast<ast::MemberExpression const *>(expression);
+  auto objectType = thisMemberType(candidate, memberExpression->expr());
+  if (objectType == nullptr || objectType->type() != ir::VariantType::Type::Class) {
+    return nullptr;
+  }
+  auto const &classType = static_cast<ir::Class const &>(*objectType);
+  auto position = classType.memberIndex(memberExpression->member());
+  if (!position.has_value()) {
+    return nullptr;
+  }
+  return classType.member()[position.value()].memberType_;
+}
+
+} // namespace walang
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "ast/expression.hpp"
+#include "ast/statement.hpp"
+#include "helper/range.hpp"
+#include "ir/variant.hpp"
+#include "ir/variant_type.hpp"
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace walang {
+
+/// @brief find methods which never modify `this`, they can skip writing `this` back like `@readonly` methods
+/// a method modifies `this` when it assigns to `this` or one of its members, or calls a method which modifies `this` or
+/// one of its members
+class ReadonlyInference {
+public:
+  enum class Result {
+    /// @brief decorated with `@readonly` and does not modify `this`
+    Declared,
+    /// @brief decorated with `@readonly` but modifies `this`, the modification is invisible to the caller
+    Violated,
+    /// @brief proved to never modify `this`
+    Inferred,
+    Modifying,
+  };
+  struct Method {
+    /// @brief internal name `Class#method`
+    std::string name_;
+    /// @brief decorated with `@readonly`
+    bool declared_;
+    Result result_;
+    /// @brief first direct modification or call of a modifying method
+    std::optional<ast::Range> modification_;
+  };
+
+  static char const *resultName(Result result) noexcept;
+
+  /// @brief add the methods of a class whose layout is prepared, methods are not declared yet so that the calling
+  /// convention of inferred readonly methods can be the same as the one of `@readonly` methods
+  void addClass(ast::ClassStatement const &statement, std::shared_ptr<ir::Class> const &classType);
+  /// @brief solve the methods added so far
+  void run();
+
+  /// @brief methods in the order they are added
+  [[nodiscard]] std::vector<Method> const &methods() const noexcept { return methods_; }
+  /// @brief whether the method `name` is proved to never modify `this` without being decorated with `@readonly`
+  [[nodiscard]] bool isInferred(std::string const &name) const;
+
+private:
+  struct Candidate {
+    ast::FunctionStatement const *statement_;
+    std::shared_ptr<ir::Class> classType_;
+    /// @brief methods called on `this` or its members with the range of the call
+    std::vector<std::pair<std::string, ast::Range>> calls_{};
+  };
+
+  void collect(Method &method, Candidate &candidate, ast::Statement const *statement);
+  void collect(Method &method, Candidate &candidate, ast::Expression const *expression);
+  [[nodiscard]] std::shared_ptr<ir::VariantType> thisMemberType(Candidate const &candidate,
+                                                                ast::Expression const *expression) const;
+
+  std::vector<Method> methods_{};
+  std::vector<Candidate> candidates_{};
+  std::map<std::string, std::size_t> indexes_{};
+};
+
+} // namespace walang
@@ -8,24 +8,24 @@
 
 namespace walang {
 
-std::shared_ptr<ir::Symbol> Resolver::resolveExpression(std::shared_ptr<ast::Expression> const &expression) {
+std::shared_ptr<ir::Symbol> Resolver::resolveExpression(ast::Expression const *expression) {
   switch (expression->type()) {
   case ast::ExpressionType::TypeIdentifier:
-    return resolveIdentifier(std::dynamic_pointer_cast<ast::Identifier>(expression));
+    return resolveIdentifier(static_cast<ast::Identifier const *>(expression));
   case ast::ExpressionType::TypePrefixExpression:
-    return resolvePrefixExpression(std::dynamic_pointer_cast<ast::PrefixExpression>(expression));
+    return resolvePrefixExpression(static_cast<ast::PrefixExpression const *>(expression));
   case ast::ExpressionType::TypeBinaryExpression:
-    return resolveBinaryExpression(std::dynamic_pointer_cast<ast::BinaryExpression>(expression));
+    return resolveBinaryExpression(static_cast<ast::BinaryExpression const *>(expression));
   case ast::ExpressionType::TypeTernaryExpression:
-    return resolveTernaryExpression(std::dynamic_pointer_cast<ast::TernaryExpression>(expression));
+    return resolveTernaryExpression(static_cast<ast::TernaryExpression const *>(expression));
   case ast::ExpressionType::TypeCallExpression:
-    return resolveCallExpression(std::dynamic_pointer_cast<ast::CallExpression>(expression));
+    return resolveCallExpression(static_cast<ast::CallExpression const *>(expression));
   case ast::ExpressionType::TypeMemberExpression:
-    return resolveMemberExpression(std::dynamic_pointer_cast<ast::MemberExpression>(expression));
+    return resolveMemberExpression(static_cast<ast::MemberExpression const *>(expression));
   }
   throw CannotResolveSymbol{};
 }
-std::shared_ptr<ir::Symbol> Resolver::resolveIdentifier(std::shared_ptr<ast::Identifier> const &expression) {
+std::shared_ptr<ir::Symbol> Resolver::resolveIdentifier(ast::Identifier const *expression) {
   return std::visit(overloaded{[&expression](uint64_t i) -> std::shared_ptr<ir::Symbol> {
                                  CannotResolveSymbol{}.setRangeAndThrow(expression->range());
                                },
@@ -33,19 +33,24 @@ std::shared_ptr<ir::Symbol> Resolver::resolveIdentifier(std::shared_ptr<ast::Ide
                                  CannotResolveSymbol{}.setRangeAndThrow(expression->range());
                                },
                                [&expression, this](const std::string &s) -> std::shared_ptr<ir::Symbol> {
-                                 auto locals = currentFunction_->locals();
-                                 auto localIt =
-                                     std::find_if(locals.begin(), locals.end(),
-                                                  [&s](std::shared_ptr<ir::Local> const &v) { return v->name() == s; });
-                                 if (localIt != locals.end()) {
-                                   return *localIt;
+                                 if (!inlineScopes_.empty()) {
+                                   auto argumentIt = inlineScopes_.back().find(s);
+                                   if (argumentIt != inlineScopes_.back().end()) {
+                                     return argumentIt->second;
+                                   }
                                  }
-                                 auto globalIt = globals_.find(s);
-                                 if (globalIt != globals_.end()) {
+                                 if (auto local = currentFunction_->findLocalByName(s)) {
+                                   if (local->isReference()) {
+                                     return local->dereference();
+                                   }
+                                   return local;
+                                 }
+                                 auto globalIt = symbols_->globals_.find(s);
+                                 if (globalIt != symbols_->globals_.end() && isVisibleGlobal(s)) {
                                    return globalIt->second;
                                  }
-                                 auto functionIt = functions_.find(s);
-                                 if (functionIt != functions_.end()) {
+                                 auto functionIt = symbols_->functions_.find(s);
+                                 if (functionIt != symbols_->functions_.end()) {
                                    return functionIt->second;
                                  }
                                  CannotResolveSymbol{}.setRangeAndThrow(expression->range());
@@ -53,29 +58,25 @@ std::shared_ptr<ir::Symbol> Resolver::resolveIdentifier(std::shared_ptr<ast::Ide
                     expression->identifier());
 }
 
-std::shared_ptr<ir::Symbol>
-Resolver::resolvePrefixExpression(std::shared_ptr<ast::PrefixExpression> const &expression) {
+std::shared_ptr<ir::Symbol> Resolver::resolvePrefixExpression(ast::PrefixExpression const *expression) {
   return resolveExpression(expression->expr());
 }
 
-std::shared_ptr<ir::Symbol>
-Resolver::resolveBinaryExpression(std::shared_ptr<ast::BinaryExpression> const &expression) {
+std::shared_ptr<ir::Symbol> Resolver::resolveBinaryExpression(ast::BinaryExpression const *expression) {
   return resolveExpression(expression->leftExpr()); // TODO(handle right expression)
 }
 
-std::shared_ptr<ir::Symbol>
-Resolver::resolveTernaryExpression(std::shared_ptr<ast::TernaryExpression> const &expression) {
+std::shared_ptr<ir::Symbol> Resolver::resolveTernaryExpression(ast::TernaryExpression const *expression) {
   return resolveExpression(expression->leftExpr()); // TODO(handle right expression)
 }
 
-std::shared_ptr<ir::Symbol> Resolver::resolveCallExpression(std::shared_ptr<ast::CallExpression> const &expression) {
+std::shared_ptr<ir::Symbol> Resolver::resolveCallExpression(ast::CallExpression const *expression) {
   static_cast<void>(this);
   static_cast<void>(expression);
   throw CannotResolveSymbol{};
 }
 
-std::shared_ptr<ir::Symbol>
-Resolver::resolveMemberExpression(std::shared_ptr<ast::MemberExpression> const &expression) {
+std::shared_ptr<ir::Symbol> Resolver::resolveMemberExpression(ast::MemberExpression const *expression) {
   // this.a
   auto exprSymbol = resolveExpression(expression->expr());
   switch (exprSymbol->type()) {
@@ -84,7 +85,7 @@ Resolver::resolveMemberExpression(std::shared_ptr<ast::MemberExpression> const &
     if (member != nullptr) {
       return member;
     }
-    auto methodMap = std::dynamic_pointer_cast<ir::Class>(exprSymbol->variantType())->methodMap();
+    auto const &methodMap = std::dynamic_pointer_cast<ir::Class>(exprSymbol->variantType())->methodMap();
     auto it = methodMap.find(expression->member());
     if (it != methodMap.cend()) {
       return it->second;
@@ -96,7 +97,19 @@ Resolver::resolveMemberExpression(std::shared_ptr<ast::MemberExpression> const &
     if (member != nullptr) {
       return member;
     }
-    auto methodMap = std::dynamic_pointer_cast<ir::Class>(exprSymbol->variantType())->methodMap();
+    auto const &methodMap = std::dynamic_pointer_cast<ir::Class>(exprSymbol->variantType())->methodMap();
+    auto it = methodMap.find(expression->member());
+    if (it != methodMap.cend()) {
+      return it->second;
+    }
+    break;
+  }
+  case ir::Symbol::Type::TypeMemoryData: {
+    auto member = std::dynamic_pointer_cast<ir::MemoryData>(exprSymbol)->findMemberByName(expression->member());
+    if (member != nullptr) {
+      return member;
+    }
+    auto const &methodMap = std::dynamic_pointer_cast<ir::Class>(exprSymbol->variantType())->methodMap();
     auto it = methodMap.find(expression->member());
     if (it != methodMap.cend()) {
       return it->second;
@@ -104,54 +117,53 @@ Resolver::resolveMemberExpression(std::shared_ptr<ast::MemberExpression> const &
     break;
   }
   case ir::Symbol::Type::TypeFunction:
-  case ir::Symbol::Type::TypeMemoryData:
   case ir::Symbol::Type::TypeStackData:
     break;
   }
   throw CannotResolveSymbol{};
 }
 
-std::shared_ptr<ir::VariantType> Resolver::resolveTypeExpression(std::shared_ptr<ast::Expression> const &expression) {
+std::shared_ptr<ir::VariantType> Resolver::resolveTypeExpression(ast::Expression const *expression) {
   switch (expression->type()) {
   case ast::ExpressionType::TypeIdentifier:
-    return resolveTypeIdentifier(std::dynamic_pointer_cast<ast::Identifier>(expression));
+    return resolveTypeIdentifier(static_cast<ast::Identifier const *>(expression));
   case ast::ExpressionType::TypePrefixExpression:
-    return resolveTypePrefixExpression(std::dynamic_pointer_cast<ast::PrefixExpression>(expression));
+    return resolveTypePrefixExpression(static_cast<ast::PrefixExpression const *>(expression));
   case ast::ExpressionType::TypeBinaryExpression:
-    return resolveTypeBinaryExpression(std::dynamic_pointer_cast<ast::BinaryExpression>(expression));
+    return resolveTypeBinaryExpression(static_cast<ast::BinaryExpression const *>(expression));
   case ast::ExpressionType::TypeTernaryExpression:
-    return resolveTypeTernaryExpression(std::dynamic_pointer_cast<ast::TernaryExpression>(expression));
+    return resolveTypeTernaryExpression(static_cast<ast::TernaryExpression const *>(expression));
   case ast::ExpressionType::TypeCallExpression:
-    return resolveTypeCallExpression(std::dynamic_pointer_cast<ast::CallExpression>(expression));
+    return resolveTypeCallExpression(static_cast<ast::CallExpression const *>(expression));
   case ast::ExpressionType::TypeMemberExpression:
-    return resolveTypeMemberExpression(std::dynamic_pointer_cast<ast::MemberExpression>(expression));
+    return resolveTypeMemberExpression(static_cast<ast::MemberExpression const *>(expression));
   }
   throw CannotResolveSymbol{};
 }
-std::shared_ptr<ir::VariantType> Resolver::resolveTypeIdentifier(std::shared_ptr<ast::Identifier> const &expression) {
+std::shared_ptr<ir::VariantType> Resolver::resolveTypeIdentifier(ast::Identifier const *expression) {
   return std::visit(
       overloaded{
-          [this](uint64_t i) -> std::shared_ptr<ir::VariantType> { return variantTypeMap_->findVariantType("i32"); },
-          [this](double d) -> std::shared_ptr<ir::VariantType> { return variantTypeMap_->findVariantType("f32"); },
+          [](uint64_t i) -> std::shared_ptr<ir::VariantType> {
+            return ir::VariantType::primitive(ir::VariantType::Type::I32);
+          },
+          [](double d) -> std::shared_ptr<ir::VariantType> {
+            return ir::VariantType::primitive(ir::VariantType::Type::F32);
+          },
           [&expression, this](const std::string &s) -> std::shared_ptr<ir::VariantType> {
             return resolveIdentifier(expression)->variantType();
           }},
       expression->identifier());
 }
-std::shared_ptr<ir::VariantType>
-Resolver::resolveTypePrefixExpression(std::shared_ptr<ast::PrefixExpression> const &expression) {
+std::shared_ptr<ir::VariantType> Resolver::resolveTypePrefixExpression(ast::PrefixExpression const *expression) {
   return resolveTypeExpression(expression->expr());
 }
-std::shared_ptr<ir::VariantType>
-Resolver::resolveTypeBinaryExpression(std::shared_ptr<ast::BinaryExpression> const &expression) {
+std::shared_ptr<ir::VariantType> Resolver::resolveTypeBinaryExpression(ast::BinaryExpression const *expression) {
   return resolveTypeExpression(expression->leftExpr());
 }
-std::shared_ptr<ir::VariantType>
-Resolver::resolveTypeTernaryExpression(std::shared_ptr<ast::TernaryExpression> const &expression) {
+std::shared_ptr<ir::VariantType> Resolver::resolveTypeTernaryExpression(ast::TernaryExpression const *expression) {
   return resolveTypeExpression(expression->leftExpr());
 }
-std::shared_ptr<ir::VariantType>
-Resolver::resolveTypeCallExpression(std::shared_ptr<ast::CallExpression> const &expression) {
+std::shared_ptr<ir::VariantType> Resolver::resolveTypeCallExpression(ast::CallExpression const *expression) {
   auto callerSymbol = resolveExpression(expression->caller());
   switch (callerSymbol->type()) {
   case ir::Symbol::Type::TypeFunction:
@@ -164,17 +176,14 @@ Resolver::resolveTypeCallExpression(std::shared_ptr<ast::CallExpression> const &
   }
   throw CannotResolveSymbol{};
 }
-std::shared_ptr<ir::VariantType>
-Resolver::resolveTypeMemberExpression(std::shared_ptr<ast::MemberExpression> const &expression) {
+std::shared_ptr<ir::VariantType> Resolver::resolveTypeMemberExpression(ast::MemberExpression const *expression) {
   // this.a
   auto type = resolveTypeExpression(expression->expr());
   if (type->type() == ir::VariantType::Type::Class) {
-    auto classMember = std::dynamic_pointer_cast<ir::Class>(type)->member();
-    auto it = std::find_if(classMember.begin(), classMember.end(), [&expression](ir::Class::ClassMember const &member) {
-      return member.memberName_ == expression->member();
-    });
-    if (it != classMember.end()) {
-      return it->memberType_;
+    auto const &classType = static_cast<ir::Class const &>(*type);
+    auto position = classType.memberIndex(expression->member());
+    if (position.has_value()) {
+      return classType.member()[position.value()].memberType_;
     }
   }
   throw CannotResolveSymbol{};
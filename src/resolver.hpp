@@ -4,7 +4,11 @@
 #include "helper/diagnose.hpp"
 #include "ir/variant.hpp"
 #include "variant_type_table.hpp"
+#include <cstddef>
+#include <limits>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -14,50 +18,80 @@ class Resolver {
 public:
   explicit Resolver(std::shared_ptr<VariantTypeMap> variantTypeMap) : variantTypeMap_(std::move(variantTypeMap)) {}
 
-  std::shared_ptr<ir::Symbol> resolveExpression(std::shared_ptr<ast::Expression> const &expression);
-  std::shared_ptr<ir::Symbol> resolveIdentifier(std::shared_ptr<ast::Identifier> const &expression);
-  std::shared_ptr<ir::Symbol> resolvePrefixExpression(std::shared_ptr<ast::PrefixExpression> const &expression);
-  std::shared_ptr<ir::Symbol> resolveBinaryExpression(std::shared_ptr<ast::BinaryExpression> const &expression);
-  std::shared_ptr<ir::Symbol> resolveTernaryExpression(std::shared_ptr<ast::TernaryExpression> const &expression);
-  std::shared_ptr<ir::Symbol> resolveCallExpression(std::shared_ptr<ast::CallExpression> const &expression);
-  std::shared_ptr<ir::Symbol> resolveMemberExpression(std::shared_ptr<ast::MemberExpression> const &expression);
-
-  std::shared_ptr<ir::VariantType> resolveTypeExpression(std::shared_ptr<ast::Expression> const &expression);
-  std::shared_ptr<ir::VariantType> resolveTypeIdentifier(std::shared_ptr<ast::Identifier> const &expression);
-  std::shared_ptr<ir::VariantType>
-  resolveTypePrefixExpression(std::shared_ptr<ast::PrefixExpression> const &expression);
-  std::shared_ptr<ir::VariantType>
-  resolveTypeBinaryExpression(std::shared_ptr<ast::BinaryExpression> const &expression);
-  std::shared_ptr<ir::VariantType>
-  resolveTypeTernaryExpression(std::shared_ptr<ast::TernaryExpression> const &expression);
-  std::shared_ptr<ir::VariantType> resolveTypeCallExpression(std::shared_ptr<ast::CallExpression> const &expression);
-  std::shared_ptr<ir::VariantType>
-  resolveTypeMemberExpression(std::shared_ptr<ast::MemberExpression> const &expression);
-
-  std::unordered_map<std::string, std::shared_ptr<ir::Global>> const &globals() { return globals_; }
-  std::unordered_map<std::string, std::shared_ptr<ir::Function>> const &functions() { return functions_; }
+  std::shared_ptr<ir::Symbol> resolveExpression(ast::Expression const *expression);
+  std::shared_ptr<ir::Symbol> resolveIdentifier(ast::Identifier const *expression);
+  std::shared_ptr<ir::Symbol> resolvePrefixExpression(ast::PrefixExpression const *expression);
+  std::shared_ptr<ir::Symbol> resolveBinaryExpression(ast::BinaryExpression const *expression);
+  std::shared_ptr<ir::Symbol> resolveTernaryExpression(ast::TernaryExpression const *expression);
+  std::shared_ptr<ir::Symbol> resolveCallExpression(ast::CallExpression const *expression);
+  std::shared_ptr<ir::Symbol> resolveMemberExpression(ast::MemberExpression const *expression);
+
+  std::shared_ptr<ir::VariantType> resolveTypeExpression(ast::Expression const *expression);
+  std::shared_ptr<ir::VariantType> resolveTypeIdentifier(ast::Identifier const *expression);
+  std::shared_ptr<ir::VariantType> resolveTypePrefixExpression(ast::PrefixExpression const *expression);
+  std::shared_ptr<ir::VariantType> resolveTypeBinaryExpression(ast::BinaryExpression const *expression);
+  std::shared_ptr<ir::VariantType> resolveTypeTernaryExpression(ast::TernaryExpression const *expression);
+  std::shared_ptr<ir::VariantType> resolveTypeCallExpression(ast::CallExpression const *expression);
+  std::shared_ptr<ir::VariantType> resolveTypeMemberExpression(ast::MemberExpression const *expression);
+
+  [[nodiscard]] std::unordered_map<std::string, std::shared_ptr<ir::Global>> const &globals() const {
+    return symbols_->globals_;
+  }
+  [[nodiscard]] std::unordered_map<std::string, std::shared_ptr<ir::Function>> const &functions() const {
+    return symbols_->functions_;
+  }
+  /// @brief number of globals declared so far
+  [[nodiscard]] std::size_t globalCount() const noexcept { return symbols_->globalOrder_.size(); }
+
+  /// @brief create a view which shares symbols with this resolver but resolves locals of another function
+  /// @param visibleGlobalCount only the first `visibleGlobalCount` declared globals can be resolved in the view
+  [[nodiscard]] Resolver createView(std::shared_ptr<ir::Function> currentFunction,
+                                    std::size_t visibleGlobalCount) const {
+    Resolver view{*this};
+    view.currentFunction_ = std::move(currentFunction);
+    view.visibleGlobalCount_ = visibleGlobalCount;
+    return view;
+  }
 
   void setCurrentFunction(std::shared_ptr<ir::Function> currentFunction) {
     currentFunction_ = std::move(currentFunction);
   }
+  /// @brief resolve the arguments of a function inlined at the current call site before any other symbol
+  void enterInlineScope(std::unordered_map<std::string, std::shared_ptr<ir::Symbol>> arguments) {
+    inlineScopes_.push_back(std::move(arguments));
+  }
+  void exitInlineScope() { inlineScopes_.pop_back(); }
   void addGlobal(std::string const &name, std::shared_ptr<ir::Global> const &value) {
-    auto it = globals_.emplace(name, value);
+    auto it = symbols_->globals_.emplace(name, value);
     if (!it.second) {
       throw RedefinedSymbol{name};
     }
+    symbols_->globalOrder_.emplace(name, symbols_->globalOrder_.size());
   }
   void addFunction(std::string const &name, std::shared_ptr<ir::Function> const &value) {
-    auto it = functions_.emplace(name, value);
+    auto it = symbols_->functions_.emplace(name, value);
     if (!it.second) {
       throw RedefinedSymbol{name};
     }
   }
 
 private:
+  struct Symbols {
+    std::unordered_map<std::string, std::shared_ptr<ir::Global>> globals_{};
+    std::unordered_map<std::string, std::size_t> globalOrder_{};
+    std::unordered_map<std::string, std::shared_ptr<ir::Function>> functions_{};
+  };
+
   std::shared_ptr<VariantTypeMap> variantTypeMap_{};
-  std::unordered_map<std::string, std::shared_ptr<ir::Global>> globals_{};
-  std::unordered_map<std::string, std::shared_ptr<ir::Function>> functions_{};
+  std::shared_ptr<Symbols> symbols_{std::make_shared<Symbols>()};
   std::shared_ptr<ir::Function> currentFunction_{};
+  std::size_t visibleGlobalCount_{std::numeric_limits<std::size_t>::max()};
+  std::vector<std::unordered_map<std::string, std::shared_ptr<ir::Symbol>>> inlineScopes_{};
+
+  [[nodiscard]] bool isVisibleGlobal(std::string const &name) const {
+    auto it = symbols_->globalOrder_.find(name);
+    return it != symbols_->globalOrder_.end() && it->second < visibleGlobalCount_;
+  }
 };
 
 } // namespace walang
\ No newline at end of file
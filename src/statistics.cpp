@@ -0,0 +1,211 @@
+#include "statistics.hpp"
+#include "ast/expression.hpp"
+#include "ast/file.hpp"
+#include "ast/statement.hpp"
+#include "helper/json.hpp"
+#include "ir/utils.h"
+#include "ir/variant_type.hpp"
+#include <binaryen-c.h>
+#include <cstdint>
+#include <fmt/core.h>
+#include <magic_enum.hpp>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace walang {
+
+namespace {
+
+class AstCounter {
+public:
+  explicit AstCounter(std::map<std::string, uint64_t> &counts) : counts_(counts) {}
+
+  void count(ast::Statement const *statement) {
+    if (statement == nullptr) {
+      return;
+    }
+    add(magic_enum::enum_name(statement->type()));
+    switch (statement->type()) {
+    case ast::TypeDeclareStatement:
+      count(static_cast<ast::DeclareStatement const *>(statement)->init());
+      break;
+    case ast::TypeAssignStatement:
+      count(static_cast<ast::AssignStatement const *>(statement)->variant());
+      count(static_cast<ast::AssignStatement const *>(statement)->value());
+      break;
+    case ast::TypeExpressionStatement:
+      count(static_cast<ast::ExpressionStatement const *>(statement)->expr());
+      break;
+    case ast::TypeBlockStatement:
+      for (ast::Statement const *child : static_cast<ast::BlockStatement const *>(statement)->statements()) {
+        count(child);
+      }
+      break;
+    case ast::TypeIfStatement: {
+      auto const *ifStatement = static_cast<ast::IfStatement const *>(statement);
+      count(ifStatement->condition());
+      count(ifStatement->thenBlock());
+      // else block may share the then block node
+      if (ifStatement->elseBlock() != ifStatement->thenBlock()) {
+        count(ifStatement->elseBlock());
+      }
+      break;
+    }
+    case ast::TypeWhileStatement:
+      count(static_cast<ast::WhileStatement const *>(statement)->condition());
+      count(static_cast<ast::WhileStatement const *>(statement)->block());
+      break;
+    case ast::TypeReturnStatement:
+      count(static_cast<ast::ReturnStatement const *>(statement)->expr());
+      break;
+    case ast::TypeFunctionStatement:
+      count(static_cast<ast::FunctionStatement const *>(statement)->body());
+      break;
+    case ast::TypeClassStatement:
+      for (ast::FunctionStatement const *method : static_cast<ast::ClassStatement const *>(statement)->methods()) {
+        count(method);
+      }
+      break;
+    case ast::TypeBreakStatement:
+    case ast::TypeContinueStatement:
+      break;
+    }
+  }
+  void count(ast::Expression const *expression) {
+    if (expression == nullptr) {
+      return;
+    }
+    add(magic_enum::enum_name(expression->type()));
+    switch (expression->type()) {
+    case ast::TypeIdentifier:
+      break;
+    case ast::TypePrefixExpression:
+      count(static_cast<ast::PrefixExpression const *>(expression)->expr());
+      break;
+    case ast::TypeBinaryExpression:
+      count(static_cast<ast::BinaryExpression const *>(expression)->leftExpr());
+      count(static_cast<ast::BinaryExpression const *>(expression)->rightExpr());
+      break;
+    case ast::TypeTernaryExpression:
+      count(static_cast<ast::TernaryExpression const *>(expression)->conditionExpr());
+      count(static_cast<ast::TernaryExpression const *>(expression)->leftExpr());
+      count(static_cast<ast::TernaryExpression const *>(expression)->rightExpr());
+      break;
+    case ast::TypeCallExpression:
+      count(static_cast<ast::CallExpression const *>(expression)->caller());
+      for (ast::Expression const *argument : static_cast<ast::CallExpression const *>(expression)->arguments()) {
+        count(argument);
+      }
+      break;
+    case ast::TypeMemberExpression:
+      count(static_cast<ast::MemberExpression const *>(expression)->expr());
+      break;
+    }
+  }
+
+private:
+  std::map<std::string, uint64_t> &counts_;
+
+  void add(std::string_view kind) {
+    // enum values are prefixed by `Type`
+    if (kind.rfind("Type", 0) == 0) {
+      kind.remove_prefix(4U);
+    }
+    counts_[std::string{kind}]++;
+  }
+};
+
+} // namespace
+
+void Statistics::collectAst(std::vector<std::shared_ptr<ast::File>> const &files) {
+  AstCounter counter{astNodes_};
+  for (auto const &file : files) {
+    astNodes_["File"]++;
+    for (ast::Statement const *statement : file->statement()) {
+      counter.count(statement);
+    }
+    arenaAllocatedBytes_ += file->arena().allocatedBytes();
+    arenaUsedBytes_ += file->arena().usedBytes();
+  }
+}
+
+void Statistics::collectModule(BinaryenModuleRef module) {
+  expressionsBeforeOptimization_ = 0U;
+  for (BinaryenIndex i = 0; i < BinaryenGetNumFunctions(module); i++) {
+    BinaryenFunctionRef function = BinaryenGetFunctionByIndex(module, i);
+    uint64_t expressions = countExpressions(function);
+    expressionsBeforeOptimization_ += expressions;
+    functions_.push_back(FunctionStatistics{BinaryenFunctionGetName(function),
+                                            BinaryenTypeArity(BinaryenFunctionGetParams(function)),
+                                            BinaryenFunctionGetNumVars(function), 0U, expressions});
+  }
+  for (BinaryenIndex i = 0; i < BinaryenGetNumGlobals(module); i++) {
+    BinaryenGlobalRef global = BinaryenGetGlobalByIndex(module, i);
+    globals_.push_back(
+        GlobalStatistics{BinaryenGlobalGetName(global), ir::VariantType::getSize(BinaryenGlobalGetType(global))});
+  }
+}
+
+uint64_t Statistics::countExpressions(BinaryenFunctionRef function) {
+  BinaryenExpressionRef body = BinaryenFunctionGetBody(function);
+  return body == nullptr ? 0U : wasm::Measurer::measure(reinterpret_cast<wasm::Expression *>(body));
+}
+uint64_t Statistics::countExpressions(BinaryenModuleRef module) {
+  uint64_t expressions = 0U;
+  for (BinaryenIndex i = 0; i < BinaryenGetNumFunctions(module); i++) {
+    expressions += countExpressions(BinaryenGetFunctionByIndex(module, i));
+  }
+  return expressions;
+}
+
+void Statistics::writeJson(std::ostream &os) const {
+  os << "{\n  \"astNodes\": {";
+  char const *separator = "";
+  for (auto const &[kind, count] : astNodes_) {
+    os << fmt::format("{}\n    \"{}\": {}", separator, escapeJson(kind), count);
+    separator = ",";
+  }
+  os << "\n  },\n  \"functions\": [";
+  separator = "";
+  for (FunctionStatistics const &function : functions_) {
+    os << fmt::format("{}\n    {{\"name\": \"{}\", \"params\": {}, \"locals\": {}, \"tempLocals\": {}, "
+                      "\"expressions\": {}}}",
+                      separator, escapeJson(function.name_), function.params_, function.locals_, function.tempLocals_,
+                      function.expressions_);
+    separator = ",";
+  }
+  os << "\n  ],\n  \"classes\": [";
+  separator = "";
+  for (ClassStatistics const &classStatistics : classes_) {
+    os << fmt::format("{}\n    {{\"name\": \"{}\", \"size\": {}, \"flattenedTypes\": {}}}", separator,
+                      escapeJson(classStatistics.name_), classStatistics.size_, classStatistics.flattenedTypes_);
+    separator = ",";
+  }
+  os << "\n  ],\n  \"methods\": [";
+  separator = "";
+  for (MethodStatistics const &method : methods_) {
+    os << fmt::format("{}\n    {{\"name\": \"{}\", \"readonly\": \"{}\"}}", separator, escapeJson(method.name_),
+                      method.readonly_);
+    separator = ",";
+  }
+  os << "\n  ],\n  \"globals\": [";
+  separator = "";
+  for (GlobalStatistics const &global : globals_) {
+    os << fmt::format("{}\n    {{\"name\": \"{}\", \"size\": {}}}", separator, escapeJson(global.name_),
+                      global.size_);
+    separator = ",";
+  }
+  os << "\n  ],\n";
+  os << fmt::format("  \"expressions\": {{\"beforeOptimization\": {}, \"afterOptimization\": {}}},\n",
+                    expressionsBeforeOptimization_,
+                    expressionsAfterOptimization_.has_value() ? std::to_string(expressionsAfterOptimization_.value())
+                                                              : "null");
+  os << fmt::format("  \"arena\": {{\"allocatedBytes\": {}, \"usedBytes\": {}}}\n}}\n", arenaAllocatedBytes_,
+                    arenaUsedBytes_);
+}
+
+} // namespace walang
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "ast/file.hpp"
+#include <binaryen-c.h>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace walang {
+
+/// @brief machine readable report of one compilation to track codegen size and compiler memory
+struct Statistics {
+  struct FunctionStatistics {
+    std::string name_;
+    uint32_t params_;
+    uint32_t locals_;
+    uint32_t tempLocals_;
+    uint64_t expressions_;
+  };
+  struct ClassStatistics {
+    std::string name_;
+    uint32_t size_;
+    uint32_t flattenedTypes_;
+  };
+  struct MethodStatistics {
+    std::string name_;
+    /// @brief `declared`, `violated`, `inferred` or `modifying`
+    std::string readonly_;
+  };
+  struct GlobalStatistics {
+    std::string name_;
+    uint32_t size_;
+  };
+
+  std::map<std::string, uint64_t> astNodes_{};
+  std::vector<FunctionStatistics> functions_{};
+  std::vector<ClassStatistics> classes_{};
+  std::vector<MethodStatistics> methods_{};
+  std::vector<GlobalStatistics> globals_{};
+  uint64_t expressionsBeforeOptimization_{0U};
+  std::optional<uint64_t> expressionsAfterOptimization_{};
+  uint64_t arenaAllocatedBytes_{0U};
+  uint64_t arenaUsedBytes_{0U};
+
+  void collectAst(std::vector<std::shared_ptr<ast::File>> const &files);
+  void collectModule(BinaryenModuleRef module);
+  [[nodiscard]] static uint64_t countExpressions(BinaryenFunctionRef function);
+  [[nodiscard]] static uint64_t countExpressions(BinaryenModuleRef module);
+  void writeJson(std::ostream &os) const;
+};
+
+} // namespace walang
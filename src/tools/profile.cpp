@@ -0,0 +1,49 @@
+#include "profile.hpp"
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+[[noreturn]] void printHelpAndExit() {
+  std::cerr << "walang-profile profile.data [--folded]\n"
+               "  rank the counters written by `walang run --instrument=calls,loops --profile-out=profile.data`, "
+               "--folded prints flamegraph folded stacks instead"
+            << std::endl;
+  std::exit(-1);
+}
+
+int main(int argc, const char *argv[]) {
+  std::string profilePath{};
+  bool folded = false;
+  for (int i = 1; i < argc; i++) {
+    std::string argument{argv[i]};
+    if (argument == "--folded") {
+      folded = true;
+    } else if (profilePath.empty()) {
+      profilePath = argument;
+    } else {
+      printHelpAndExit();
+    }
+  }
+  if (profilePath.empty()) {
+    printHelpAndExit();
+  }
+  std::ifstream profileFile{profilePath};
+  if (!profileFile.is_open()) {
+    std::cerr << "profile path invalid " << profilePath << std::endl;
+    return -1;
+  }
+  try {
+    walang::Profile profile = walang::Profile::read(profileFile);
+    if (folded) {
+      profile.writeFolded(std::cout);
+    } else {
+      profile.writeReport(std::cout);
+    }
+  } catch (std::exception const &e) {
+    std::cerr << e.what() << std::endl;
+    return -1;
+  }
+  return 0;
+}
@@ -33,13 +33,13 @@ std::shared_ptr<ir::VariantType> VariantTypeMap::tryFindVariantType(std::string
   return it->second;
 }
 void VariantTypeMap::registerDefault() {
-  registerType("i32", std::make_shared<ir::TypeI32>());
-  registerType("u32", std::make_shared<ir::TypeU32>());
-  registerType("i64", std::make_shared<ir::TypeI64>());
-  registerType("u64", std::make_shared<ir::TypeU64>());
-  registerType("f32", std::make_shared<ir::TypeF32>());
-  registerType("f64", std::make_shared<ir::TypeF64>());
-  registerType("void", std::make_shared<ir::TypeNone>());
+  registerType("i32", ir::VariantType::primitive(ir::VariantType::Type::I32));
+  registerType("u32", ir::VariantType::primitive(ir::VariantType::Type::U32));
+  registerType("i64", ir::VariantType::primitive(ir::VariantType::Type::I64));
+  registerType("u64", ir::VariantType::primitive(ir::VariantType::Type::U64));
+  registerType("f32", ir::VariantType::primitive(ir::VariantType::Type::F32));
+  registerType("f64", ir::VariantType::primitive(ir::VariantType::Type::F64));
+  registerType("void", ir::VariantType::primitive(ir::VariantType::Type::None));
 }
 
 } // namespace walang
\ No newline at end of file
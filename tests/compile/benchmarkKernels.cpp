@@ -0,0 +1,53 @@
+#include "binaryen/runner.hpp"
+#include "compiler.hpp"
+#include "interpreter.hpp"
+#include "parser.hpp"
+#include <binaryen-c.h>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace walang;
+using namespace walang::ast;
+
+namespace {
+
+std::filesystem::path const kernelDirectory =
+    std::filesystem::path(__FILE__).parent_path().parent_path().parent_path() / "src" / "bench" / "kernels";
+
+std::string readFile(std::filesystem::path const &path) {
+  std::ifstream file{path, std::ios::binary};
+  std::ostringstream tmp;
+  tmp << file.rdbuf();
+  return tmp.str();
+}
+
+} // namespace
+
+// the benchmark corpus is only executed by the benchmarks target, keep every kernel runnable from the test suite
+TEST(CompileBenchmarkKernelsTest, RunMain) {
+  std::size_t kernelCount = 0U;
+  for (auto const &entry : std::filesystem::directory_iterator{kernelDirectory}) {
+    if (entry.path().extension() != ".wa") {
+      continue;
+    }
+    kernelCount++;
+    SCOPED_TRACE(entry.path().filename().string());
+    std::string source = readFile(entry.path());
+    Compiler compile{{FileParser(entry.path().string(), source).parse()}};
+    compile.compile();
+    ASSERT_TRUE(BinaryenModuleValidate(compile.module()));
+    std::ostringstream hostOutput{};
+    binaryen::Runner runner{compile.module(), hostOutput};
+    auto result = runner.invoke("main", {});
+    ASSERT_EQ(result.size(), 1U);
+
+    Interpreter interpreter{{FileParser(entry.path().string(), source).parse()}};
+    interpreter.start();
+    EXPECT_EQ(interpreter.invoke("main", {}), result);
+  }
+  EXPECT_GT(kernelCount, 0U);
+}
@@ -0,0 +1,86 @@
+#include "compiler.hpp"
+#include "helper/option_result.hpp"
+#include "parser.hpp"
+#include <binaryen-c.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace walang;
+using namespace walang::ast;
+
+namespace {
+
+char const *source = R"(
+class Big {
+  a:i64;
+  b:i64;
+  c:i64;
+}
+class Holder {
+  x:Big;
+  y:Big;
+  function swap():void {
+    let t = this.x;
+    this.x = this.y;
+    this.y = t;
+  }
+}
+function make():Big {
+  return Big();
+}
+function main(n:i64):i64 {
+  let h = Holder();
+  h.x.a = n;
+  h.y.b = 2;
+  h.swap();
+  let m = make();
+  return h.y.a * 10 + h.x.b + m.c;
+}
+    )";
+
+char const *globalSource = R"(
+class Big {
+  a:i64;
+  b:i64;
+  c:i64;
+}
+class Holder {
+  x:Big;
+  y:Big;
+}
+let g = Holder();
+function main(n:i64):i64 {
+  g.x.a = n;
+  g.y.b = 2;
+  let t = g.x;
+  g.x = g.y;
+  g.y = t;
+  return g.y.a * 10 + g.x.b;
+}
+    )";
+
+} // namespace
+
+TEST(CompileBulkMemoryTest, CopyAndFill) {
+  Compiler compile{{FileParser("test.wa", source).parse()}};
+  compile.setBulkMemory(true);
+  compile.compile();
+  ASSERT_TRUE(BinaryenModuleValidate(compile.module()));
+  EXPECT_NE(BinaryenModuleGetFeatures(compile.module()) & BinaryenFeatureBulkMemory(), 0U);
+  std::string wat = compile.wat();
+  EXPECT_NE(wat.find("memory.copy"), std::string::npos);
+  EXPECT_NE(wat.find("memory.fill"), std::string::npos);
+}
+
+TEST(CompileBulkMemoryTest, SameResultAsScalar) {
+  auto results = test_helper::mainResultsWithOption(source, &Compiler::setBulkMemory, {"7"});
+  EXPECT_EQ(results[0], std::vector<std::string>{"72"});
+  EXPECT_EQ(results[0], results[1]);
+}
+
+TEST(CompileBulkMemoryTest, GlobalMembers) {
+  auto results = test_helper::mainResultsWithOption(globalSource, &Compiler::setBulkMemory, {"7"});
+  EXPECT_EQ(results[0], std::vector<std::string>{"72"});
+  EXPECT_EQ(results[0], results[1]);
+}
@@ -0,0 +1,66 @@
+#include "binaryen/runner.hpp"
+#include "compiler.hpp"
+#include "helper/snapshot.hpp"
+#include "parser.hpp"
+#include <binaryen-c.h>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace walang;
+using namespace walang::ast;
+
+class CompileCopyElisionTest : public ::testing::Test {
+public:
+  static test_helper::SnapShot snapshot;
+};
+test_helper::SnapShot CompileCopyElisionTest::snapshot{std::filesystem::path(__FILE__).replace_extension("xml")};
+
+namespace {
+
+// `Pair` is returned through memory 0, every elided path is one statement
+char const *source = R"(
+class Pair {
+  a:i32;
+  b:i64;
+}
+function make(n:i32):Pair {
+  let p = Pair();
+  p.a = n;
+  return p;
+}
+function forward(n:i32):Pair {
+  return make(n);
+}
+function main(n:i32):i32 {
+  let q = forward(n);
+  let first = q.a;
+  q = Pair();
+  return first + q.a;
+}
+    )";
+
+std::string functionText(std::string const &wat, std::string const &name) {
+  auto begin = wat.find("(func $" + name + " ");
+  return wat.substr(begin, wat.find("(func $", begin + 1U) - begin);
+}
+
+} // namespace
+
+TEST_F(CompileCopyElisionTest, ElideMemoryRoundTrip) {
+  Compiler compile{{FileParser("test.wa", source).parse()}};
+  compile.compile();
+  ASSERT_TRUE(BinaryenModuleValidate(compile.module()));
+  std::string wat = compile.wat();
+  snapshot.check(wat);
+  // `let p = Pair()` and `q = Pair()` assign the default values without calling the constructor
+  EXPECT_EQ(wat.find("call $Pair#constructor"), std::string::npos);
+  // `return make(n)` leaves the callee's result at 0 instead of loading and storing it again
+  EXPECT_EQ(functionText(wat, "forward").find("load"), std::string::npos);
+  EXPECT_EQ(functionText(wat, "forward").find("store"), std::string::npos);
+
+  std::ostringstream hostOutput{};
+  binaryen::Runner runner{compile.module(), hostOutput};
+  EXPECT_EQ(runner.invoke("main", {"7"}), std::vector<std::string>{"7"});
+}
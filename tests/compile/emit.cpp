@@ -0,0 +1,53 @@
+#include "compiler.hpp"
+#include "parser.hpp"
+#include <binaryen-c.h>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+using namespace walang;
+using namespace walang::ast;
+
+namespace {
+
+constexpr char const *source = R"(
+let a = 1;
+function foo(v:i32):i32{
+  return v + a;
+}
+class B {
+  x:i32;
+  y:f64;
+}
+let b = B();
+    )";
+
+} // namespace
+
+TEST(CompileEmitTest, WatSameAsBinaryenText) {
+  FileParser parser("test.wa", source);
+  Compiler compile{{parser.parse()}};
+  compile.compile();
+  std::ostringstream watStream{};
+  compile.writeWat(watStream);
+  char *text = BinaryenModuleAllocateAndWriteText(compile.module());
+  ASSERT_EQ(watStream.str(), std::string{text});
+  std::free(text);
+  ASSERT_EQ(watStream.str(), compile.wat());
+}
+
+TEST(CompileEmitTest, WasmRoundTrip) {
+  FileParser parser("test.wa", source);
+  Compiler compile{{parser.parse()}};
+  compile.compile();
+  std::ostringstream wasmStream{};
+  compile.writeWasm(wasmStream);
+  std::string binary = wasmStream.str();
+  ASSERT_EQ(binary.substr(0, 4), std::string("\0asm", 4));
+  BinaryenModuleRef module = BinaryenModuleRead(binary.data(), binary.size());
+  EXPECT_TRUE(BinaryenModuleValidate(module));
+  EXPECT_EQ(BinaryenGetNumFunctions(module), BinaryenGetNumFunctions(compile.module()));
+  EXPECT_EQ(BinaryenGetNumGlobals(module), BinaryenGetNumGlobals(compile.module()));
+  BinaryenModuleDispose(module);
+}
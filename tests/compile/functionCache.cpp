@@ -0,0 +1,104 @@
+#include "binaryen/function_cache.hpp"
+#include "compiler.hpp"
+#include "parser.hpp"
+#include <binaryen-c.h>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+using namespace walang;
+using namespace walang::ast;
+
+namespace {
+
+class CompileFunctionCacheTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    directory_ = std::filesystem::temp_directory_path() /
+                 ("walang-cache-" + std::string{::testing::UnitTest::GetInstance()->current_test_info()->name()});
+    std::filesystem::remove_all(directory_);
+  }
+  void TearDown() override { std::filesystem::remove_all(directory_); }
+
+  std::size_t entryCount() const {
+    std::size_t count = 0;
+    for (auto const &entry : std::filesystem::directory_iterator{directory_}) {
+      count += entry.path().extension() == ".wfc" ? 1U : 0U;
+    }
+    return count;
+  }
+  std::string compileWithCache(std::string const &source, uint32_t threads = 1U) {
+    FileParser parser("test.wa", source);
+    Compiler compile{{parser.parse()}};
+    compile.setThreads(threads);
+    compile.setFunctionCache(std::make_shared<binaryen::FunctionCache>(directory_, binaryen::OptimizeOptions{2U, 1U}));
+    compile.compile();
+    EXPECT_TRUE(BinaryenModuleValidate(compile.module()));
+    return compile.wat();
+  }
+
+  std::filesystem::path directory_;
+};
+
+std::string const source = R"(
+let g : i32 = 1;
+class A {
+  a:i32;
+  b:f64;
+  function get():i32 {
+    return this.a + g;
+  }
+}
+function foo(v:i32):i32 {
+  return v + g;
+}
+function bar(v:i32):i32 {
+  return foo(v) * 2;
+}
+let r = bar(1);
+)";
+
+} // namespace
+
+TEST_F(CompileFunctionCacheTest, ReuseEntries) {
+  compileWithCache(source);
+  EXPECT_EQ(entryCount(), 3U);
+  std::string wat = compileWithCache(source);
+  EXPECT_EQ(entryCount(), 3U);
+  EXPECT_NE(wat.find("(func $bar"), std::string::npos);
+  EXPECT_EQ(compileWithCache(source, 4U), wat);
+  EXPECT_EQ(entryCount(), 3U);
+}
+
+TEST_F(CompileFunctionCacheTest, BodyChangeOnlyInvalidatesChangedFunction) {
+  compileWithCache(source);
+  std::string changed = source;
+  changed.replace(changed.find("foo(v) * 2"), std::string{"foo(v) * 2"}.size(), "foo(v) * 3");
+  compileWithCache(changed);
+  EXPECT_EQ(entryCount(), 4U);
+}
+
+TEST_F(CompileFunctionCacheTest, LayoutChangeInvalidatesUsersOfClass) {
+  compileWithCache(source);
+  std::string changed = source;
+  changed.replace(changed.find("b:f64"), std::string{"b:f64"}.size(), "b:i64");
+  compileWithCache(changed);
+  // only `A#get` observes the layout of `A`
+  EXPECT_EQ(entryCount(), 4U);
+}
+
+TEST_F(CompileFunctionCacheTest, DeclarationChangeInvalidatesCallers) {
+  compileWithCache(source);
+  std::string changed = source;
+  changed.replace(changed.find("function foo"), std::string{"function foo"}.size(), "@noinline function foo");
+  compileWithCache(changed);
+  // `foo` and `bar` which calls it are lowered again
+  EXPECT_EQ(entryCount(), 5U);
+}
+
+TEST_F(CompileFunctionCacheTest, UnrelatedDeclarationKeepsEntries) {
+  compileWithCache(source);
+  compileWithCache(source + "let h : i64 = 2;\nfunction baz():i64 {\n  return h;\n}\nclass B {\n  c:i32;\n}\n");
+  EXPECT_EQ(entryCount(), 4U);
+}
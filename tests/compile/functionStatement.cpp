@@ -1,4 +1,5 @@
 #include "compiler.hpp"
+#include "helper/diagnose.hpp"
 #include "helper/snapshot.hpp"
 #include "parser.hpp"
 #include <gtest/gtest.h>
@@ -40,3 +41,50 @@ function foo(a:i32, b: f32) {}
       }(),
       std::runtime_error);
 }
+
+TEST_F(CompileFunctionStatementTest, LocalScope) {
+  {
+    FileParser parser("test.wa", R"(
+function foo(a:i32) : i32 {
+  let b = a;
+  {
+    let b = 2.5;
+    let a = b;
+  }
+  return b;
+}
+    )");
+    auto file = parser.parse();
+    Compiler compile{{file}};
+    compile.compile();
+    ASSERT_TRUE(BinaryenModuleValidate(compile.module()));
+  }
+  EXPECT_THROW(
+      [] {
+        FileParser parser("test.wa", R"(
+function foo() : void {
+  let c = 1;
+  let c = 2;
+}
+    )");
+        auto file = parser.parse();
+        Compiler compile{{file}};
+        compile.compile();
+      }(),
+      RedefinedSymbol);
+  EXPECT_THROW(
+      [] {
+        FileParser parser("test.wa", R"(
+function foo() : void {
+  {
+    let c = 1;
+  }
+  c = 2;
+}
+    )");
+        auto file = parser.parse();
+        Compiler compile{{file}};
+        compile.compile();
+      }(),
+      CannotResolveSymbol);
+}
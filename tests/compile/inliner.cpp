@@ -0,0 +1,86 @@
+#include "binaryen/runner.hpp"
+#include "compiler.hpp"
+#include "helper/diagnose.hpp"
+#include "interpreter.hpp"
+#include "parser.hpp"
+#include <binaryen-c.h>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace walang;
+using namespace walang::ast;
+
+namespace {
+
+char const *source = R"(
+class Counter {
+  v:i32;
+  w:i32;
+  function getValue():i32 {
+    return this.v;
+  }
+  @inline function total(k:i32):i32 {
+    return this.v * k + this.w;
+  }
+  @noinline function getW():i32 {
+    return this.w;
+  }
+  @inline function bump():i32 {
+    this.v = this.v + 1;
+    return this.v;
+  }
+}
+function identity(x:i32):i32 {
+  return x;
+}
+function main(n:i32):i32 {
+  let c = Counter();
+  c.v = identity(n);
+  c.w = 2;
+  return c.getValue() + c.total(3) + c.getW() + c.bump();
+}
+    )";
+
+} // namespace
+
+TEST(CompileInlinerTest, InlineCalls) {
+  Compiler compile{{FileParser("test.wa", source).parse()}};
+  compile.compile();
+  ASSERT_TRUE(BinaryenModuleValidate(compile.module()));
+  std::string wat = compile.wat();
+  auto begin = wat.find("(func $main ");
+  std::string mainText = wat.substr(begin, wat.find("(func $", begin + 1U) - begin);
+  EXPECT_EQ(mainText.find("call $identity"), std::string::npos);
+  EXPECT_EQ(mainText.find("call $Counter#getValue"), std::string::npos);
+  EXPECT_EQ(mainText.find("call $Counter#total"), std::string::npos);
+  EXPECT_NE(mainText.find("call $Counter#getW"), std::string::npos);
+  EXPECT_NE(mainText.find("call $Counter#bump"), std::string::npos);
+  ASSERT_EQ(compile.warnings().size(), 1U);
+  EXPECT_NE(compile.warnings().front().find("Counter#bump"), std::string::npos);
+
+  std::ostringstream hostOutput{};
+  binaryen::Runner runner{compile.module(), hostOutput};
+  Interpreter interpreter{{FileParser("test.wa", source).parse()}};
+  interpreter.start();
+  EXPECT_EQ(runner.invoke("main", {"4"}), std::vector<std::string>{"25"});
+  EXPECT_EQ(interpreter.invoke("main", {"4"}), runner.invoke("main", {"4"}));
+}
+
+TEST(CompileInlinerTest, MaxSize) {
+  Compiler compile{{FileParser("test.wa", source).parse()}};
+  compile.setInlineMaxSize(0U);
+  compile.compile();
+  ASSERT_TRUE(BinaryenModuleValidate(compile.module()));
+  std::string wat = compile.wat();
+  EXPECT_NE(wat.find("call $Counter#getValue"), std::string::npos);
+  EXPECT_EQ(wat.find("call $Counter#total"), std::string::npos);
+}
+
+TEST(CompileInlinerTest, ConflictDecorators) {
+  char const *conflictSource = "@inline @noinline function f():i32 { return 1; }";
+  Compiler compile{{FileParser("test.wa", conflictSource).parse()}};
+  EXPECT_THROW(compile.compile(), ErrorDecorator);
+  EXPECT_THROW(Interpreter({FileParser("test.wa", conflictSource).parse()}), ErrorDecorator);
+}
@@ -0,0 +1,41 @@
+#include "binaryen/instruction_counter.hpp"
+#include "binaryen/runner.hpp"
+#include "compiler.hpp"
+#include "parser.hpp"
+#include <binaryen-c.h>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace walang;
+using namespace walang::ast;
+
+TEST(CompileInstructionCounterTest, CountGrowsWithIterations) {
+  FileParser parser("test.wa", R"(
+function sum(n:i32):i32 {
+  let s = 0;
+  while (n > 0) {
+    s = s + n;
+    n = n - 1;
+  }
+  return s;
+}
+    )");
+  Compiler compile{{parser.parse()}};
+  compile.compile();
+  binaryen::InstructionCounter::instrument(compile.module());
+  ASSERT_TRUE(BinaryenModuleValidate(compile.module()));
+
+  auto count = [&compile](std::string const &n) {
+    std::ostringstream hostOutput{};
+    binaryen::Runner runner{compile.module(), hostOutput};
+    EXPECT_EQ(runner.invoke("sum", {n}), std::vector<std::string>{n == "1" ? "1" : "55"});
+    return std::stoull(runner.invoke(binaryen::InstructionCounter::counterFunction, {}).front());
+  };
+  uint64_t once = count("1");
+  uint64_t tenTimes = count("10");
+  EXPECT_GT(once, 0U);
+  EXPECT_GT(tenTimes, once);
+}
@@ -0,0 +1,103 @@
+#include "binaryen/runner.hpp"
+#include "compiler.hpp"
+#include "helper/diagnose.hpp"
+#include "interpreter.hpp"
+#include "parser.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace walang;
+using namespace walang::ast;
+
+namespace {
+
+char const *source = R"(
+let a = 1;
+let b:i64 = 10;
+class Pair {
+  x:i32;
+  y:f64;
+  function sum():f64 {
+    return this.y + 1.5;
+  }
+}
+function foo(v:i32):i32 {
+  return v + a;
+}
+function bar(v:i64):i64 {
+  return -v * b % 7;
+}
+function loop(n:i32):i32 {
+  let s = 0;
+  let i = 0;
+  while (i < n) {
+    i = i + 1;
+    if (i % 3 == 0) {
+      continue;
+    }
+    if (i > 20) {
+      break;
+    }
+    s = s + (i << 2 ^ i >> 1);
+  }
+  return s > 100 && s < 1000 ? s : 0 - s;
+}
+function fib(n:i32):i32 {
+  if (n < 2) {
+    return n;
+  }
+  return fib(n - 1) + fib(n - 2);
+}
+function pair(x:i32):Pair {
+  let p = Pair();
+  p.x = x;
+  p.y = 0.25;
+  return p;
+}
+function usePair(x:i32):f64 {
+  let p = pair(x);
+  a = a + p.x;
+  return p.sum() + p.y;
+}
+function div(x:i32, y:i32):i32 {
+  return x / y;
+}
+    )";
+
+} // namespace
+
+TEST(InterpreterTest, SameResultsAsWasm) {
+  Compiler compile{{FileParser("test.wa", source).parse()}};
+  compile.compile();
+  std::ostringstream hostOutput{};
+  binaryen::Runner runner{compile.module(), hostOutput};
+  Interpreter interpreter{{FileParser("test.wa", source).parse()}};
+  interpreter.start();
+
+  std::vector<std::pair<std::string, std::vector<std::string>>> calls{
+      {"foo", {"2"}},  {"bar", {"3"}},     {"bar", {"-4"}}, {"loop", {"30"}}, {"loop", {"5"}},
+      {"fib", {"15"}}, {"usePair", {"4"}}, {"foo", {"0"}},  {"div", {"-7", "2"}}};
+  for (auto const &[name, arguments] : calls) {
+    EXPECT_EQ(interpreter.invoke(name, arguments), runner.invoke(name, arguments)) << name;
+  }
+}
+
+TEST(InterpreterTest, Errors) {
+  Interpreter interpreter{{FileParser("test.wa", source).parse()}};
+  interpreter.start();
+  EXPECT_THROW(interpreter.invoke("div", {"1", "0"}), binaryen::RuntimeTrap);
+  EXPECT_THROW(interpreter.invoke("div", {"-2147483648", "-1"}), binaryen::RuntimeTrap);
+  EXPECT_THROW(interpreter.invoke("unknown", {}), std::invalid_argument);
+  EXPECT_THROW(interpreter.invoke("foo", {}), std::invalid_argument);
+  EXPECT_THROW(interpreter.invoke("foo", {"x"}), std::invalid_argument);
+  EXPECT_THROW(interpreter.invoke("foo", {"1x"}), std::invalid_argument);
+  EXPECT_THROW(interpreter.invoke("foo", {"1.5"}), std::invalid_argument);
+
+  EXPECT_THROW(Interpreter({FileParser("test.wa", "let a:i32 = 1.5;").parse()}), TypeConvertError);
+  EXPECT_THROW(Interpreter({FileParser("test.wa", "break;").parse()}), JumpStatementError);
+  Interpreter recursion{{FileParser("test.wa", "function f(v:i32):i32 { return f(v); }").parse()}};
+  EXPECT_THROW(recursion.invoke("f", {"1"}), binaryen::RuntimeTrap);
+}
@@ -0,0 +1,45 @@
+#include "compiler.hpp"
+#include "helper/diagnose.hpp"
+#include "parser.hpp"
+#include <binaryen-c.h>
+#include <gtest/gtest.h>
+
+using namespace walang;
+using namespace walang::ast;
+
+TEST(CompileMultiFileTest, CrossFileReference) {
+  FileParser parser1("a.wa", R"(
+let a = createB();
+function foo(v:i32):i32{
+  return v;
+}
+    )");
+  FileParser parser2("b.wa", R"(
+class B {
+  v:i32;
+}
+function createB():B{
+  return B();
+}
+let c = foo(1);
+    )");
+  Compiler compile{{parser1.parse(), parser2.parse()}};
+  compile.compile();
+  ASSERT_TRUE(BinaryenModuleValidate(compile.module()));
+  ASSERT_NE(BinaryenGetFunction(compile.module(), "foo"), nullptr);
+  ASSERT_NE(BinaryenGetFunction(compile.module(), "createB"), nullptr);
+  ASSERT_NE(BinaryenGetFunction(compile.module(), "_start"), nullptr);
+  ASSERT_NE(BinaryenGetGlobal(compile.module(), "a"), nullptr);
+  ASSERT_NE(BinaryenGetGlobal(compile.module(), "c"), nullptr);
+}
+
+TEST(CompileMultiFileTest, RedefinedAcrossFiles) {
+  FileParser parser1("a.wa", R"(
+function foo():void{}
+    )");
+  FileParser parser2("b.wa", R"(
+function foo():void{}
+    )");
+  Compiler compile{{parser1.parse(), parser2.parse()}};
+  EXPECT_THROW(compile.compile(), RedefinedSymbol);
+}
@@ -0,0 +1,62 @@
+#include "compiler.hpp"
+#include "helper/option_result.hpp"
+#include "parser.hpp"
+#include <binaryen-c.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace walang;
+using namespace walang::ast;
+
+namespace {
+
+char const *source = R"(
+class U8 {
+  v:i32;
+  w:i64;
+}
+let g = U8();
+function add(a:U8, b:U8):U8 {
+  let r = U8();
+  r.v = a.v + b.v;
+  r.w = a.w + b.w;
+  return r;
+}
+function main(n:i32):i64 {
+  let s = U8();
+  let one = U8();
+  one.v = 1;
+  one.w = 2;
+  let i = 0;
+  while (i < n) {
+    s = add(s, one);
+    i = i + 1;
+  }
+  g = add(s, s);
+  let r = g;
+  return r.w;
+}
+    )";
+
+} // namespace
+
+TEST(CompileMultivalueTest, ReturnClassAsTuple) {
+  Compiler compile{{FileParser("test.wa", source).parse()}};
+  compile.setMultivalue(true);
+  compile.compile();
+  ASSERT_TRUE(BinaryenModuleValidate(compile.module()));
+  EXPECT_NE(BinaryenModuleGetFeatures(compile.module()) & BinaryenFeatureMultivalue(), 0U);
+  EXPECT_EQ(BinaryenTypeArity(BinaryenFunctionGetResults(BinaryenGetFunction(compile.module(), "add"))), 2U);
+  EXPECT_EQ(BinaryenTypeArity(BinaryenFunctionGetResults(BinaryenGetFunction(compile.module(), "U8#constructor"))),
+            2U);
+  std::string wat = compile.wat();
+  EXPECT_NE(wat.find("tuple.make"), std::string::npos);
+  EXPECT_EQ(wat.find("store"), std::string::npos);
+}
+
+TEST(CompileMultivalueTest, SameResultAsMemory) {
+  auto results = test_helper::mainResultsWithOption(source, &Compiler::setMultivalue, {"5"});
+  EXPECT_EQ(results[0], std::vector<std::string>{"20"});
+  EXPECT_EQ(results[0], results[1]);
+}
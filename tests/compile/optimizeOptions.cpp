@@ -0,0 +1,74 @@
+#include "binaryen/optimize_options.hpp"
+#include "compiler.hpp"
+#include "helper/hash.hpp"
+#include "parser.hpp"
+#include <binaryen-c.h>
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace walang;
+using namespace walang::ast;
+
+TEST(CompileOptimizeOptionsTest, FromLevel) {
+  EXPECT_FALSE(binaryen::OptimizeOptions::fromLevel("-O0")->enabled());
+  EXPECT_EQ(binaryen::OptimizeOptions::fromLevel("-O3")->optimizeLevel_, 3U);
+  EXPECT_EQ(binaryen::OptimizeOptions::fromLevel("-O3")->shrinkLevel_, 0U);
+  EXPECT_EQ(binaryen::OptimizeOptions::fromLevel("-Os")->optimizeLevel_, 2U);
+  EXPECT_EQ(binaryen::OptimizeOptions::fromLevel("-Os")->shrinkLevel_, 1U);
+  EXPECT_EQ(binaryen::OptimizeOptions::fromLevel("-Oz")->shrinkLevel_, 2U);
+  EXPECT_FALSE(binaryen::OptimizeOptions::fromLevel("-O5").has_value());
+  EXPECT_FALSE(binaryen::OptimizeOptions::fromLevel("-o").has_value());
+}
+
+TEST(CompileOptimizeOptionsTest, HashDistinguishesPipelines) {
+  auto digest = [](binaryen::OptimizeOptions const &options) {
+    Fnv1a hash{};
+    options.hash(hash);
+    return hash.digest();
+  };
+  binaryen::OptimizeOptions withPasses{2U, 0U};
+  withPasses.passes_ = {"vacuum"};
+  binaryen::OptimizeOptions withInline{2U, 0U};
+  withInline.alwaysInlineMaxSize_ = 10U;
+  EXPECT_NE(digest(binaryen::OptimizeOptions{2U, 0U}), digest(binaryen::OptimizeOptions{2U, 1U}));
+  EXPECT_NE(digest(binaryen::OptimizeOptions{2U, 0U}), digest(withPasses));
+  EXPECT_NE(digest(binaryen::OptimizeOptions{2U, 0U}), digest(withInline));
+}
+
+TEST(CompileOptimizeOptionsTest, ApplyResetsInlineSizes) {
+  binaryen::OptimizeOptions{2U, 0U}.apply();
+  BinaryenIndex alwaysInline = BinaryenGetAlwaysInlineMaxSize();
+  BinaryenIndex flexibleInline = BinaryenGetFlexibleInlineMaxSize();
+  BinaryenIndex oneCallerInline = BinaryenGetOneCallerInlineMaxSize();
+  binaryen::OptimizeOptions withInline{2U, 0U};
+  withInline.alwaysInlineMaxSize_ = alwaysInline + 1U;
+  withInline.flexibleInlineMaxSize_ = flexibleInline + 1U;
+  withInline.oneCallerInlineMaxSize_ = 7U;
+  withInline.apply();
+  EXPECT_EQ(BinaryenGetAlwaysInlineMaxSize(), alwaysInline + 1U);
+  EXPECT_EQ(BinaryenGetOneCallerInlineMaxSize(), 7U);
+  // a later pipeline without explicit sizes does not inherit them
+  binaryen::OptimizeOptions{2U, 0U}.apply();
+  EXPECT_EQ(BinaryenGetAlwaysInlineMaxSize(), alwaysInline);
+  EXPECT_EQ(BinaryenGetFlexibleInlineMaxSize(), flexibleInline);
+  EXPECT_EQ(BinaryenGetOneCallerInlineMaxSize(), oneCallerInline);
+}
+
+TEST(CompileOptimizeOptionsTest, ExplicitPasses) {
+  FileParser parser("test.wa", R"(
+function foo(a:i32):i32 {
+  let b = a;
+  let c = b;
+  return c;
+}
+    )");
+  Compiler compile{{parser.parse()}};
+  compile.compile();
+  std::string before = compile.wat();
+  binaryen::OptimizeOptions options{};
+  options.passes_ = {"simplify-locals", "vacuum"};
+  ASSERT_TRUE(options.enabled());
+  options.run(compile.module());
+  EXPECT_TRUE(BinaryenModuleValidate(compile.module()));
+  EXPECT_NE(compile.wat(), before);
+}
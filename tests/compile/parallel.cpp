@@ -0,0 +1,77 @@
+#include "compiler.hpp"
+#include "helper/diagnose.hpp"
+#include "parser.hpp"
+#include <binaryen-c.h>
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace walang;
+using namespace walang::ast;
+
+namespace {
+
+std::string compileWat(std::string const &source, uint32_t threads) {
+  FileParser parser("test.wa", source);
+  Compiler compile{{parser.parse()}};
+  compile.setThreads(threads);
+  compile.compile();
+  EXPECT_TRUE(BinaryenModuleValidate(compile.module()));
+  return compile.wat();
+}
+
+} // namespace
+
+TEST(CompileParallelTest, SameOutputAsSerial) {
+  std::string source = R"(
+let g : i32 = 1;
+class Vec {
+  x:f64;
+  y:f64;
+  function len2():f64 {
+    return this.x * this.x + this.y * this.y;
+  }
+  function scale(k:f64):void {
+    this.x = this.x * k;
+    this.y = this.y * k;
+  }
+}
+function fib(n:i32):i32 {
+  if (n < 2) {
+    return n;
+  }
+  return fib(n - 1) + fib(n - 2);
+}
+function make(x:f64, y:f64):Vec {
+  let v = Vec();
+  v.x = x;
+  v.y = y;
+  return v;
+}
+function sum(n:i32):i32 {
+  let s = 0;
+  while (n > 0) {
+    s = s + n + g;
+    n = n - 1;
+  }
+  return s;
+}
+let v = make(1.0, 2.0);
+let r = fib(10) + sum(5);
+    )";
+  EXPECT_EQ(compileWat(source, 1U), compileWat(source, 4U));
+}
+
+TEST(CompileParallelTest, GlobalDeclaredAfterFunction) {
+  std::string source = R"(
+function foo():i32 {
+  return g;
+}
+let g : i32 = 1;
+    )";
+  for (uint32_t threads : {1U, 4U}) {
+    FileParser parser("test.wa", source);
+    Compiler compile{{parser.parse()}};
+    compile.setThreads(threads);
+    EXPECT_THROW(compile.compile(), CannotResolveSymbol);
+  }
+}
@@ -0,0 +1,75 @@
+#include "binaryen/runner.hpp"
+#include "compiler.hpp"
+#include "parser.hpp"
+#include "profile.hpp"
+#include <algorithm>
+#include <binaryen-c.h>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using namespace walang;
+using namespace walang::ast;
+
+namespace {
+
+uint64_t countOf(Profile const &profile, Profile::Kind kind, std::string const &name) {
+  auto const &counters = profile.counters();
+  auto it = std::find_if(counters.begin(), counters.end(), [&](Profile::Counter const &counter) {
+    return counter.kind_ == kind && counter.name_ == name;
+  });
+  EXPECT_NE(it, counters.end()) << name;
+  return it == counters.end() ? 0U : it->count_;
+}
+
+} // namespace
+
+TEST(CompileProfileTest, CountCallsAndLoops) {
+  FileParser parser("test.wa", R"(
+function foo(v:i32):i32 {
+  return v + 1;
+}
+let s = 0;
+let i = 0;
+while (i < 10) {
+  i = i + 1;
+  if (i < 4) {
+    continue;
+  }
+  s = foo(s);
+}
+    )");
+  Compiler compile{{parser.parse()}};
+  compile.setInstrumentOptions(InstrumentOptions::parse("calls,loops").value());
+  compile.compile();
+  ASSERT_TRUE(BinaryenModuleValidate(compile.module()));
+
+  std::ostringstream hostOutput{};
+  binaryen::Runner runner{compile.module(), hostOutput};
+  Profile profile = Profile::collect(compile.module(), runner);
+  EXPECT_EQ(countOf(profile, Profile::Kind::Call, "foo"), 7U);
+  // back-edges by `continue` and by the end of the body
+  EXPECT_EQ(countOf(profile, Profile::Kind::Loop, "_start@7:1"), 10U);
+
+  std::ostringstream text{};
+  profile.write(text);
+  std::istringstream input{text.str()};
+  Profile reread = Profile::read(input);
+  ASSERT_EQ(reread.counters().size(), profile.counters().size());
+  EXPECT_EQ(countOf(reread, Profile::Kind::Call, "foo"), 7U);
+
+  std::ostringstream folded{};
+  profile.writeFolded(folded);
+  EXPECT_NE(folded.str().find("foo 7\n"), std::string::npos);
+  EXPECT_NE(folded.str().find("_start;loop@7:1 10\n"), std::string::npos);
+}
+
+TEST(CompileProfileTest, ParseErrors) {
+  EXPECT_FALSE(InstrumentOptions::parse("").has_value());
+  EXPECT_FALSE(InstrumentOptions::parse("calls,branches").has_value());
+  EXPECT_TRUE(InstrumentOptions::parse("loops").value().loops_);
+  std::istringstream input{"call foo\n"};
+  EXPECT_THROW(Profile::read(input), std::runtime_error);
+}
@@ -0,0 +1,49 @@
+#include "binaryen/optimize_options.hpp"
+#include "binaryen/profile_guided_optimizer.hpp"
+#include "compiler.hpp"
+#include "parser.hpp"
+#include "profile.hpp"
+#include <binaryen-c.h>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+using namespace walang;
+using namespace walang::ast;
+
+TEST(CompileProfileGuidedTest, Temperature) {
+  std::istringstream input{"call hot 1000\n"
+                           "loop hot@3:1 8000\n"
+                           "call warm 10\n"
+                           "call cold 0\n"
+                           "main;sampled 50\n"};
+  Profile profile = Profile::read(input);
+  binaryen::ProfileGuidedOptimizer optimizer{binaryen::OptimizeOptions{2U, 0U}, profile};
+  using Temperature = binaryen::ProfileGuidedOptimizer::Temperature;
+  EXPECT_EQ(optimizer.temperature("hot"), Temperature::Hot);
+  EXPECT_EQ(optimizer.temperature("warm"), Temperature::Warm);
+  EXPECT_EQ(optimizer.temperature("sampled"), Temperature::Warm);
+  EXPECT_EQ(optimizer.temperature("cold"), Temperature::Cold);
+  EXPECT_EQ(optimizer.temperature("unknown"), Temperature::Warm);
+}
+
+TEST(CompileProfileGuidedTest, HotFunctionsFirst) {
+  FileParser parser("test.wa", R"(
+function cold(v:i32):i32 {
+  return v - 1;
+}
+function hot(v:i32):i32 {
+  return v + 1;
+}
+let a = cold(1) + hot(2);
+    )");
+  Compiler compile{{parser.parse()}};
+  compile.compile();
+  std::istringstream input{"call hot 100\ncall cold 0\n"};
+  binaryen::ProfileGuidedOptimizer{binaryen::OptimizeOptions{}, Profile::read(input)}.run(compile.module());
+  ASSERT_TRUE(BinaryenModuleValidate(compile.module()));
+  EXPECT_EQ(std::string{BinaryenFunctionGetName(BinaryenGetFunctionByIndex(compile.module(), 0))}, "hot");
+  EXPECT_EQ(std::string{BinaryenFunctionGetName(
+                BinaryenGetFunctionByIndex(compile.module(), BinaryenGetNumFunctions(compile.module()) - 1U))},
+            "cold");
+}
@@ -0,0 +1,101 @@
+#include "binaryen/runner.hpp"
+#include "compiler.hpp"
+#include "parser.hpp"
+#include "statistics.hpp"
+#include <binaryen-c.h>
+#include <gtest/gtest.h>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace walang;
+using namespace walang::ast;
+
+namespace {
+
+char const *source = R"(
+class Inner {
+  v:i32;
+  function get():i32 {
+    return this.v;
+  }
+  function set(v:i32):void {
+    this.v = v;
+  }
+}
+class Outer {
+  inner:Inner;
+  w:i32;
+  function total():i32 {
+    let copy = this.inner;
+    copy.set(1);
+    return this.inner.get() + this.w + copy.v;
+  }
+  function reset():void {
+    this.inner.set(0);
+  }
+  function resetAll():void {
+    if (this.w > 0) {
+      this.reset();
+    }
+  }
+  @readonly function peek():i32 {
+    return this.w;
+  }
+  @readonly function bump():i32 {
+    this.w = this.w + 1;
+    return this.w;
+  }
+}
+function main():i32 {
+  let i = Inner();
+  i.set(3);
+  return i.get();
+}
+    )";
+
+} // namespace
+
+TEST(CompileReadonlyInferenceTest, Report) {
+  Compiler compile{{FileParser("test.wa", source).parse()}};
+  compile.compile();
+  ASSERT_TRUE(BinaryenModuleValidate(compile.module()));
+  Statistics statistics{};
+  compile.collectStatistics(statistics);
+
+  std::map<std::string, std::string> readonly{};
+  for (auto const &method : statistics.methods_) {
+    readonly.emplace(method.name_, method.readonly_);
+  }
+  EXPECT_EQ(readonly, (std::map<std::string, std::string>{{"Inner#get", "inferred"},
+                                                          {"Inner#set", "modifying"},
+                                                          {"Outer#total", "inferred"},
+                                                          {"Outer#reset", "modifying"},
+                                                          {"Outer#resetAll", "modifying"},
+                                                          {"Outer#peek", "declared"},
+                                                          {"Outer#bump", "violated"}}));
+  ASSERT_EQ(compile.warnings().size(), 1U);
+  EXPECT_NE(compile.warnings().front().find("Outer#bump"), std::string::npos);
+
+  std::ostringstream json{};
+  statistics.writeJson(json);
+  EXPECT_NE(json.str().find(R"({"name": "Inner#get", "readonly": "inferred"})"), std::string::npos);
+}
+
+TEST(CompileReadonlyInferenceTest, SkipWriteBack) {
+  Compiler compile{{FileParser("test.wa", source).parse()}};
+  compile.compile();
+  ASSERT_TRUE(BinaryenModuleValidate(compile.module()));
+  std::string wat = compile.wat();
+  auto functionText = [&wat](std::string const &name) {
+    auto begin = wat.find("(func $" + name + " ");
+    return wat.substr(begin, wat.find("(func $", begin + 1U) - begin);
+  };
+  EXPECT_EQ(functionText("Inner#get").find("store"), std::string::npos);
+  EXPECT_EQ(functionText("Outer#total").find("store"), std::string::npos);
+  EXPECT_NE(functionText("Inner#set").find("store"), std::string::npos);
+  std::ostringstream hostOutput{};
+  binaryen::Runner runner{compile.module(), hostOutput};
+  EXPECT_EQ(runner.invoke("main", {}), std::vector<std::string>{"3"});
+}
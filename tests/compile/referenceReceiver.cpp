@@ -0,0 +1,176 @@
+#include "binaryen/runner.hpp"
+#include "compiler.hpp"
+#include "interpreter.hpp"
+#include "parser.hpp"
+#include <binaryen-c.h>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace walang;
+using namespace walang::ast;
+
+namespace {
+
+char const *source = R"(
+class Vec3 {
+  x:i64;
+  y:i64;
+  z:i64;
+  function setX(v:i64):void {
+    this.x = v;
+  }
+  function scale(k:i64):i64 {
+    this.x = this.x * k;
+    this.y = this.y * k;
+    this.z = this.z * k;
+    this.setX(this.x + 1);
+    return this.x + this.y + this.z;
+  }
+  @readonly function sum():i64 {
+    return this.x + this.y + this.z;
+  }
+  function diff():i64 {
+    return this.x - this.y - this.z;
+  }
+}
+class Pair {
+  a:i32;
+  b:i32;
+  function inc():void {
+    this.a = this.a + 1;
+  }
+}
+let g = Vec3();
+function main(n:i32):i64 {
+  let v = Vec3();
+  v.y = 2;
+  v.z = 3;
+  let i = 0;
+  while (i < n) {
+    v.setX(v.x + 1);
+    i = i + 1;
+  }
+  g.setX(5);
+  let s = v.scale(2);
+  let h = g;
+  return s + v.sum() + h.x;
+}
+function order():i64 {
+  let v = Vec3();
+  v.y = 2;
+  v.setX(v.scale(2));
+  return v.x * 100 + v.y;
+}
+function counter(n:i32):i32 {
+  let p = Pair();
+  let i = 0;
+  while (i < n) {
+    p.inc();
+    i = i + 1;
+  }
+  return p.a;
+}
+    )";
+
+char const *deepSource = R"(
+class L0 {
+  a:i64;
+  b:i64;
+  c:i64;
+}
+class L1 {
+  p:L0;
+  q:L0;
+  r:L0;
+  s:L0;
+}
+class L2 {
+  p:L1;
+  q:L1;
+  r:L1;
+  s:L1;
+}
+class L3 {
+  p:L2;
+  q:L2;
+  r:L2;
+  s:L2;
+  function down(n:i32):i64 {
+    this.q.q.q.b = 1;
+    if (n == 0) {
+      return this.p.p.p.a;
+    }
+    let t = L3();
+    t.p.p.p.a = this.p.p.p.a + 1;
+    return t.down(n - 1);
+  }
+}
+function main(n:i32):i64 {
+  let t = L3();
+  return t.down(n);
+}
+    )";
+
+} // namespace
+
+TEST(CompileReferenceReceiverTest, PassThisByLayout) {
+  Compiler compile{{FileParser("test.wa", source).parse()}};
+  compile.compile();
+  ASSERT_TRUE(BinaryenModuleValidate(compile.module()));
+  std::vector<BinaryenType> setXParams{BinaryenTypeInt64(), BinaryenTypeInt32()};
+  EXPECT_EQ(BinaryenFunctionGetParams(BinaryenGetFunction(compile.module(), "Vec3#setX")),
+            BinaryenTypeCreate(setXParams.data(), setXParams.size()));
+  EXPECT_EQ(BinaryenTypeArity(BinaryenFunctionGetParams(BinaryenGetFunction(compile.module(), "Vec3#sum"))), 3U);
+  // inferred readonly methods take `this` by value like `@readonly` methods
+  EXPECT_EQ(BinaryenTypeArity(BinaryenFunctionGetParams(BinaryenGetFunction(compile.module(), "Vec3#diff"))), 3U);
+  EXPECT_EQ(BinaryenTypeArity(BinaryenFunctionGetParams(BinaryenGetFunction(compile.module(), "Pair#inc"))), 2U);
+  EXPECT_NE(BinaryenGetGlobal(compile.module(), Compiler::stackPointerGlobal), nullptr);
+}
+
+TEST(CompileReferenceReceiverTest, ModifyReceiver) {
+  Compiler compile{{FileParser("test.wa", source).parse()}};
+  compile.compile();
+  ASSERT_TRUE(BinaryenModuleValidate(compile.module()));
+  std::ostringstream hostOutput{};
+  binaryen::Runner runner{compile.module(), hostOutput};
+  Interpreter interpreter{{FileParser("test.wa", source).parse()}};
+  interpreter.start();
+
+  EXPECT_EQ(runner.invoke("main", {"3"}), std::vector<std::string>{"39"});
+  EXPECT_EQ(runner.invoke("counter", {"4"}), std::vector<std::string>{"4"});
+  EXPECT_EQ(interpreter.invoke("main", {"3"}), runner.invoke("main", {"3"}));
+  EXPECT_EQ(interpreter.invoke("counter", {"4"}), runner.invoke("counter", {"4"}));
+}
+
+TEST(CompileReferenceReceiverTest, EvaluateArgumentsBeforeSpill) {
+  Compiler compile{{FileParser("test.wa", source).parse()}};
+  compile.compile();
+  ASSERT_TRUE(BinaryenModuleValidate(compile.module()));
+  std::ostringstream hostOutput{};
+  binaryen::Runner runner{compile.module(), hostOutput};
+  Interpreter interpreter{{FileParser("test.wa", source).parse()}};
+  interpreter.start();
+
+  // `scale` modifies `v` before `setX` receives it
+  EXPECT_EQ(runner.invoke("order", {}), std::vector<std::string>{"504"});
+  EXPECT_EQ(interpreter.invoke("order", {}), runner.invoke("order", {}));
+}
+
+TEST(CompileReferenceReceiverTest, TrapOnStackOverflow) {
+  Compiler compile{{FileParser("test.wa", deepSource).parse()}};
+  compile.compile();
+  ASSERT_TRUE(BinaryenModuleValidate(compile.module()));
+  std::ostringstream hostOutput{};
+  binaryen::Runner runner{compile.module(), hostOutput};
+
+  EXPECT_EQ(runner.invoke("main", {"8"}), std::vector<std::string>{"8"});
+  // each level spills 1536 bytes, the shadow stack is exhausted before the call depth limit
+  try {
+    runner.invoke("main", {"64"});
+    ADD_FAILURE() << "expected a trap";
+  } catch (binaryen::RuntimeTrap const &e) {
+    EXPECT_NE(std::string{e.what()}.find("unreachable"), std::string::npos);
+  }
+}
@@ -0,0 +1,38 @@
+#include "binaryen/runner.hpp"
+#include "compiler.hpp"
+#include "parser.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace walang;
+using namespace walang::ast;
+
+TEST(CompileRunTest, InvokeAfterStart) {
+  FileParser parser("test.wa", R"(
+let a = 1;
+function foo(v:i32):i32 {
+  return v + a;
+}
+function div(x:i32, y:i32):i32 {
+  return x / y;
+}
+    )");
+  Compiler compile{{parser.parse()}};
+  compile.compile();
+  std::ostringstream hostOutput{};
+  binaryen::Runner runner{compile.module(), hostOutput};
+
+  // `a` is initialized by `_start` during instantiation
+  EXPECT_EQ(runner.invoke("foo", {"2"}), std::vector<std::string>{"3"});
+  EXPECT_TRUE(runner.invoke("_start", {}).empty());
+  EXPECT_THROW(runner.invoke("div", {"1", "0"}), binaryen::RuntimeTrap);
+  EXPECT_THROW(runner.invoke("unknown", {}), std::invalid_argument);
+  EXPECT_THROW(runner.invoke("foo", {}), std::invalid_argument);
+  EXPECT_THROW(runner.invoke("foo", {"x"}), std::invalid_argument);
+  EXPECT_THROW(runner.invoke("foo", {"1x"}), std::invalid_argument);
+  EXPECT_THROW(runner.invoke("foo", {"1.5"}), std::invalid_argument);
+  EXPECT_THROW(runner.invoke("foo", {"4294967296"}), std::invalid_argument);
+}
@@ -0,0 +1,41 @@
+#include "compiler.hpp"
+#include "parser.hpp"
+#include <binaryen-c.h>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+using namespace walang;
+using namespace walang::ast;
+
+TEST(CompileSourceMapTest, MapsToSourceFile) {
+  FileParser parser("test.wa", R"(
+let a = 1;
+function foo(v:i32):i32 {
+  return v + a;
+}
+    )");
+  Compiler compile{{parser.parse()}};
+  compile.setDebugInfo(true);
+  compile.compile();
+  ASSERT_TRUE(BinaryenModuleValidate(compile.module()));
+
+  std::ostringstream wasm{};
+  std::ostringstream sourceMap{};
+  compile.writeWasm(wasm, "test.wasm.map", sourceMap);
+  EXPECT_NE(wasm.str().find("test.wasm.map"), std::string::npos);
+  EXPECT_NE(sourceMap.str().find(R"("sources":["test.wa"])"), std::string::npos);
+  EXPECT_EQ(sourceMap.str().find(R"("mappings":"")"), std::string::npos);
+}
+
+TEST(CompileSourceMapTest, NoDebugInfoByDefault) {
+  FileParser parser("test.wa", R"(
+let a = 1;
+    )");
+  Compiler compile{{parser.parse()}};
+  compile.compile();
+  std::ostringstream wasm{};
+  std::ostringstream sourceMap{};
+  compile.writeWasm(wasm, "test.wasm.map", sourceMap);
+  EXPECT_EQ(sourceMap.str().find("test.wa\""), std::string::npos);
+}
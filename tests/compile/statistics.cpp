@@ -0,0 +1,59 @@
+#include "compiler.hpp"
+#include "parser.hpp"
+#include "statistics.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+using namespace walang;
+using namespace walang::ast;
+
+TEST(CompileStatisticsTest, Collect) {
+  FileParser parser("test.wa", R"(
+class A {
+  a:i32;
+  b:f64;
+}
+let ga = A();
+function foo(v:i32):i32 {
+  let x = v + 1;
+  return x;
+}
+    )");
+  Compiler compile{{parser.parse()}};
+  compile.compile();
+  Statistics statistics{};
+  compile.collectStatistics(statistics);
+
+  EXPECT_EQ(statistics.astNodes_["File"], 1U);
+  EXPECT_EQ(statistics.astNodes_["ClassStatement"], 1U);
+  EXPECT_EQ(statistics.astNodes_["FunctionStatement"], 1U);
+  EXPECT_EQ(statistics.astNodes_["BinaryExpression"], 1U);
+  EXPECT_GT(statistics.arenaAllocatedBytes_, 0U);
+  EXPECT_GE(statistics.arenaAllocatedBytes_, statistics.arenaUsedBytes_);
+
+  ASSERT_EQ(statistics.classes_.size(), 1U);
+  EXPECT_EQ(statistics.classes_[0].name_, "A");
+  EXPECT_EQ(statistics.classes_[0].size_, 12U);
+  EXPECT_EQ(statistics.classes_[0].flattenedTypes_, 2U);
+
+  auto hasGlobal = [&statistics](std::string const &name) {
+    return std::any_of(statistics.globals_.begin(), statistics.globals_.end(),
+                       [&name](Statistics::GlobalStatistics const &global) { return global.name_ == name; });
+  };
+  EXPECT_TRUE(hasGlobal("ga#0"));
+  EXPECT_TRUE(hasGlobal("ga#1"));
+
+  auto foo = std::find_if(statistics.functions_.begin(), statistics.functions_.end(),
+                          [](Statistics::FunctionStatistics const &function) { return function.name_ == "foo"; });
+  ASSERT_NE(foo, statistics.functions_.end());
+  EXPECT_EQ(foo->params_, 1U);
+  EXPECT_GE(foo->locals_, 1U);
+  EXPECT_GT(foo->expressions_, 0U);
+  EXPECT_EQ(statistics.expressionsBeforeOptimization_, Statistics::countExpressions(compile.module()));
+
+  std::ostringstream json{};
+  statistics.writeJson(json);
+  EXPECT_NE(json.str().find(R"("afterOptimization": null)"), std::string::npos);
+}
@@ -0,0 +1,48 @@
+#include "compiler.hpp"
+#include "helper/trace.hpp"
+#include "parser.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <memory>
+#include <sstream>
+#include <string>
+
+using namespace walang;
+using namespace walang::ast;
+
+TEST(CompileTraceTest, RecordPhasesAndFunctions) {
+  FileParser parser("test.wa", R"(
+class A {
+  a:i32;
+  function get():i32 { return this.a; }
+}
+function foo(v:i32):i32 {
+  return v;
+}
+let b = foo(1);
+    )");
+  auto tracer = std::make_shared<Tracer>();
+  Compiler compile{{parser.parse()}};
+  compile.setTracer(tracer);
+  compile.compile();
+
+  auto events = tracer->events();
+  auto contains = [&events](std::string const &name, std::string const &detail) {
+    return std::any_of(events.begin(), events.end(), [&](Tracer::Event const &event) {
+      return event.name_ == name && event.detail_ == detail;
+    });
+  };
+  EXPECT_TRUE(contains("compile", ""));
+  EXPECT_TRUE(contains("prepare classes level 1", ""));
+  EXPECT_TRUE(contains("prepare classes level 2", ""));
+  EXPECT_TRUE(contains("prepare functions", ""));
+  EXPECT_TRUE(contains("lower statements", ""));
+  EXPECT_TRUE(contains("lower function", "foo"));
+  EXPECT_TRUE(contains("lower function", "A#get"));
+  EXPECT_TRUE(contains("finalize function", "_start"));
+
+  std::ostringstream trace{};
+  tracer->writeChromeTrace(trace);
+  EXPECT_EQ(trace.str().rfind("{\"traceEvents\":[", 0), 0U);
+  EXPECT_NE(trace.str().find(R"("args":{"detail":"foo"})"), std::string::npos);
+}
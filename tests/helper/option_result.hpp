@@ -0,0 +1,37 @@
+#pragma once
+
+#include "binaryen/runner.hpp"
+#include "compiler.hpp"
+#include "parser.hpp"
+#include <binaryen-c.h>
+#include <functional>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace test_helper {
+
+/// @brief run `main(arguments)` of `source` compiled with `setOption(compiler, false)`, then with `true`
+/// @return results of both runs, an invalid module fails the test and yields no result
+inline std::vector<std::vector<std::string>>
+mainResultsWithOption(char const *source, std::function<void(walang::Compiler &, bool)> const &setOption,
+                      std::vector<std::string> const &arguments) {
+  std::vector<std::vector<std::string>> results{};
+  for (bool enabled : {false, true}) {
+    walang::Compiler compile{{walang::FileParser("test.wa", source).parse()}};
+    setOption(compile, enabled);
+    compile.compile();
+    if (!BinaryenModuleValidate(compile.module())) {
+      ADD_FAILURE() << "invalid module with option " << enabled;
+      results.emplace_back();
+      continue;
+    }
+    std::ostringstream hostOutput{};
+    walang::binaryen::Runner runner{compile.module(), hostOutput};
+    results.push_back(runner.invoke("main", arguments));
+  }
+  return results;
+}
+
+} // namespace test_helper
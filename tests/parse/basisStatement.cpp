@@ -10,7 +10,7 @@ TEST(ParseBasisStatement, DeclareStatement) {
   auto file = parser.parse();
 
   ASSERT_EQ(file->statement().size(), 1);
-  ASSERT_NE(std::dynamic_pointer_cast<DeclareStatement>(file->statement()[0]), nullptr);
+  ASSERT_NE(dynamic_cast<DeclareStatement *>(file->statement()[0]), nullptr);
   ASSERT_EQ(file->statement()[0]->to_string(), "declare 'a' <- 4\n");
 }
 
@@ -19,7 +19,7 @@ TEST(ParseBasisStatement, TypedDeclareStatement) {
   auto file = parser.parse();
 
   ASSERT_EQ(file->statement().size(), 1);
-  ASSERT_NE(std::dynamic_pointer_cast<DeclareStatement>(file->statement()[0]), nullptr);
+  ASSERT_NE(dynamic_cast<DeclareStatement *>(file->statement()[0]), nullptr);
   ASSERT_EQ(file->statement()[0]->to_string(), "declare i32'a' <- 4\n");
 }
 
@@ -28,7 +28,7 @@ TEST(ParseBasisStatement, ExpressionStatement) {
   auto file = parser.parse();
 
   ASSERT_EQ(file->statement().size(), 1);
-  ASSERT_NE(std::dynamic_pointer_cast<ExpressionStatement>(file->statement()[0]), nullptr);
+  ASSERT_NE(dynamic_cast<ExpressionStatement *>(file->statement()[0]), nullptr);
   ASSERT_EQ(file->statement()[0]->to_string(), "4\n");
 }
 
@@ -37,7 +37,7 @@ TEST(ParseBasisStatement, AssignStatement) {
   auto file = parser.parse();
 
   ASSERT_EQ(file->statement().size(), 1);
-  ASSERT_NE(std::dynamic_pointer_cast<AssignStatement>(file->statement()[0]), nullptr);
+  ASSERT_NE(dynamic_cast<AssignStatement *>(file->statement()[0]), nullptr);
   ASSERT_EQ(file->statement()[0]->to_string(), "a <- 4\n");
 }
 
@@ -46,6 +46,6 @@ TEST(ParseBasisStatement, ReturnStatement) {
   auto file = parser.parse();
 
   ASSERT_EQ(file->statement().size(), 1);
-  ASSERT_NE(std::dynamic_pointer_cast<ReturnStatement>(file->statement()[0]), nullptr);
+  ASSERT_NE(dynamic_cast<ReturnStatement *>(file->statement()[0]), nullptr);
   ASSERT_EQ(file->statement()[0]->to_string(), "return a\n");
 }
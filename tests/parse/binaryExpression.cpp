@@ -13,7 +13,7 @@ a + 4;
   auto file = parser.parse();
 
   ASSERT_EQ(file->statement().size(), 1);
-  ASSERT_NE(std::dynamic_pointer_cast<ExpressionStatement>(file->statement()[0]), nullptr);
+  ASSERT_NE(dynamic_cast<ExpressionStatement *>(file->statement()[0]), nullptr);
   ASSERT_EQ(file->statement()[0]->to_string(), "(ADD a 4)\n");
 }
 TEST(ParserBinaryExpression, sub) {
@@ -23,7 +23,7 @@ a - 0x4;
   auto file = parser.parse();
 
   ASSERT_EQ(file->statement().size(), 1);
-  ASSERT_NE(std::dynamic_pointer_cast<ExpressionStatement>(file->statement()[0]), nullptr);
+  ASSERT_NE(dynamic_cast<ExpressionStatement *>(file->statement()[0]), nullptr);
   ASSERT_EQ(file->statement()[0]->to_string(), "(SUB a 4)\n");
 }
 TEST(ParserBinaryExpression, mul) {
@@ -33,7 +33,7 @@ a * 4.2;
   auto file = parser.parse();
 
   ASSERT_EQ(file->statement().size(), 1);
-  ASSERT_NE(std::dynamic_pointer_cast<ExpressionStatement>(file->statement()[0]), nullptr);
+  ASSERT_NE(dynamic_cast<ExpressionStatement *>(file->statement()[0]), nullptr);
   ASSERT_EQ(file->statement()[0]->to_string(), "(MUL a 4.2)\n");
 }
 TEST(ParserBinaryExpression, div) {
@@ -43,7 +43,7 @@ a / 4.1;
   auto file = parser.parse();
 
   ASSERT_EQ(file->statement().size(), 1);
-  ASSERT_NE(std::dynamic_pointer_cast<ExpressionStatement>(file->statement()[0]), nullptr);
+  ASSERT_NE(dynamic_cast<ExpressionStatement *>(file->statement()[0]), nullptr);
   ASSERT_EQ(file->statement()[0]->to_string(), "(DIV a 4.1)\n");
 }
 TEST(ParserBinaryExpression, mod) {
@@ -53,7 +53,7 @@ a % 4;
   auto file = parser.parse();
 
   ASSERT_EQ(file->statement().size(), 1);
-  ASSERT_NE(std::dynamic_pointer_cast<ExpressionStatement>(file->statement()[0]), nullptr);
+  ASSERT_NE(dynamic_cast<ExpressionStatement *>(file->statement()[0]), nullptr);
   ASSERT_EQ(file->statement()[0]->to_string(), "(MOD a 4)\n");
 }
 TEST(ParserBinaryExpression, shift) {
@@ -64,7 +64,7 @@ a << 4;
   auto file = parser.parse();
   ASSERT_EQ(file->statement().size(), 2);
   for (auto statement : file->statement()) {
-    ASSERT_NE(std::dynamic_pointer_cast<ExpressionStatement>(statement), nullptr);
+    ASSERT_NE(dynamic_cast<ExpressionStatement *>(statement), nullptr);
   }
   ASSERT_EQ(file->statement()[0]->to_string(), "(RIGHT_SHIFT a 4)\n");
   ASSERT_EQ(file->statement()[1]->to_string(), "(LEFT_SHIFT a 4)\n");
@@ -82,7 +82,7 @@ a != 4;
 
   ASSERT_EQ(file->statement().size(), 6);
   for (auto statement : file->statement()) {
-    ASSERT_NE(std::dynamic_pointer_cast<ExpressionStatement>(statement), nullptr);
+    ASSERT_NE(dynamic_cast<ExpressionStatement *>(statement), nullptr);
   }
   ASSERT_EQ(file->statement()[0]->to_string(), "(GREATER_THAN a 4)\n");
   ASSERT_EQ(file->statement()[1]->to_string(), "(LESS_THAN a 4)\n");
@@ -134,3 +134,20 @@ a * (1 + 2);
   auto file = parser.parse();
   ASSERT_EQ(file->statement()[0]->to_string(), "(MUL a (ADD 1 2))\n");
 }
+
+TEST(ParserBinaryExpression, priority_call_and_member) {
+  FileParser parser("test.wa", R"(
+a * f(1) + b.c * 2;
+  )");
+  auto file = parser.parse();
+  ASSERT_EQ(file->statement()[0]->to_string(), "(ADD (MUL a f(1)) (MUL b.c 2))\n");
+}
+
+TEST(ParserBinaryExpression, full_ll_prediction) {
+  FileParser parser("test.wa", R"(
+a * f(1) + b.c * 2;
+  )");
+  parser.setSllFirst(false);
+  auto file = parser.parse();
+  ASSERT_EQ(file->statement()[0]->to_string(), "(ADD (MUL a f(1)) (MUL b.c 2))\n");
+}
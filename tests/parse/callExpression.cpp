@@ -13,7 +13,7 @@ foo(a,b,1,2.5);
   auto file = parser.parse();
 
   ASSERT_EQ(file->statement().size(), 1);
-  ASSERT_NE(std::dynamic_pointer_cast<ExpressionStatement>(file->statement()[0]), nullptr);
+  ASSERT_NE(dynamic_cast<ExpressionStatement *>(file->statement()[0]), nullptr);
   ASSERT_EQ(file->statement()[0]->to_string(), "foo(a, b, 1, 2.5)\n");
 }
 TEST(ParseCallExpression, repeat) {
@@ -23,7 +23,7 @@ foo(a)(b)(c);
   auto file = parser.parse();
 
   ASSERT_EQ(file->statement().size(), 1);
-  ASSERT_NE(std::dynamic_pointer_cast<ExpressionStatement>(file->statement()[0]), nullptr);
+  ASSERT_NE(dynamic_cast<ExpressionStatement *>(file->statement()[0]), nullptr);
   ASSERT_EQ(file->statement()[0]->to_string(), "foo(a)(b)(c)\n");
 }
 TEST(ParseCallExpression, mix) {
@@ -33,6 +33,6 @@ a.foo(a).a(b)(c);
   auto file = parser.parse();
 
   ASSERT_EQ(file->statement().size(), 1);
-  ASSERT_NE(std::dynamic_pointer_cast<ExpressionStatement>(file->statement()[0]), nullptr);
+  ASSERT_NE(dynamic_cast<ExpressionStatement *>(file->statement()[0]), nullptr);
   ASSERT_EQ(file->statement()[0]->to_string(), "a.foo(a).a(b)(c)\n");
 }
@@ -13,7 +13,7 @@ class foo {
   auto file = parser.parse();
 
   ASSERT_EQ(file->statement().size(), 1);
-  ASSERT_NE(std::dynamic_pointer_cast<ClassStatement>(file->statement()[0]), nullptr);
+  ASSERT_NE(dynamic_cast<ClassStatement *>(file->statement()[0]), nullptr);
   ASSERT_EQ(file->statement()[0]->to_string(), "class foo {\n}\n");
 }
 TEST(ParseClass, withMember) {
@@ -26,7 +26,7 @@ class foo {
   auto file = parser.parse();
 
   ASSERT_EQ(file->statement().size(), 1);
-  ASSERT_NE(std::dynamic_pointer_cast<ClassStatement>(file->statement()[0]), nullptr);
+  ASSERT_NE(dynamic_cast<ClassStatement *>(file->statement()[0]), nullptr);
   ASSERT_EQ(file->statement()[0]->to_string(), "class foo {\na:i32\nb:f64\n}\n");
 }
 TEST(ParseClass, withFunction) {
@@ -39,6 +39,6 @@ class foo {
   auto file = parser.parse();
 
   ASSERT_EQ(file->statement().size(), 1);
-  ASSERT_NE(std::dynamic_pointer_cast<ClassStatement>(file->statement()[0]), nullptr);
+  ASSERT_NE(dynamic_cast<ClassStatement *>(file->statement()[0]), nullptr);
   ASSERT_EQ(file->statement()[0]->to_string(), "class foo {\nfn a () -> i32 {\n}\nfn b () -> f32 {\n}\n}\n");
 }
@@ -16,7 +16,7 @@ TEST(ParseFlowStatement, Block) {
   auto file = parser.parse();
 
   ASSERT_EQ(file->statement().size(), 1);
-  ASSERT_NE(std::dynamic_pointer_cast<BlockStatement>(file->statement()[0]), nullptr);
+  ASSERT_NE(dynamic_cast<BlockStatement *>(file->statement()[0]), nullptr);
   ASSERT_EQ(file->statement()[0]->to_string(), R"({
 (ADD a 1)
 (ADD b 2)
@@ -30,7 +30,7 @@ if (1) {}
   auto file = parser.parse();
 
   ASSERT_EQ(file->statement().size(), 1);
-  ASSERT_NE(std::dynamic_pointer_cast<IfStatement>(file->statement()[0]), nullptr);
+  ASSERT_NE(dynamic_cast<IfStatement *>(file->statement()[0]), nullptr);
   ASSERT_EQ(file->statement()[0]->to_string(), R"(if 1 then {
 })");
 }
@@ -44,7 +44,7 @@ if (1) {
   auto file = parser.parse();
 
   ASSERT_EQ(file->statement().size(), 1);
-  ASSERT_NE(std::dynamic_pointer_cast<IfStatement>(file->statement()[0]), nullptr);
+  ASSERT_NE(dynamic_cast<IfStatement *>(file->statement()[0]), nullptr);
   ASSERT_EQ(file->statement()[0]->to_string(), R"(if 1 then {
 } else {
 })");
@@ -60,7 +60,7 @@ if (1) {
   auto file = parser.parse();
 
   ASSERT_EQ(file->statement().size(), 1);
-  ASSERT_NE(std::dynamic_pointer_cast<IfStatement>(file->statement()[0]), nullptr);
+  ASSERT_NE(dynamic_cast<IfStatement *>(file->statement()[0]), nullptr);
   ASSERT_EQ(file->statement()[0]->to_string(), R"(if 1 then {
 } else if 2 then {
 } else {
@@ -75,7 +75,7 @@ while (1) {
   auto file = parser.parse();
 
   ASSERT_EQ(file->statement().size(), 1);
-  ASSERT_NE(std::dynamic_pointer_cast<WhileStatement>(file->statement()[0]), nullptr);
+  ASSERT_NE(dynamic_cast<WhileStatement *>(file->statement()[0]), nullptr);
   ASSERT_EQ(file->statement()[0]->to_string(), R"(while 1 {
 })");
 }
@@ -12,7 +12,7 @@ function foo() {}
   auto file = parser.parse();
 
   ASSERT_EQ(file->statement().size(), 1);
-  ASSERT_NE(std::dynamic_pointer_cast<FunctionStatement>(file->statement()[0]), nullptr);
+  ASSERT_NE(dynamic_cast<FunctionStatement *>(file->statement()[0]), nullptr);
   ASSERT_EQ(file->statement()[0]->to_string(), "fn foo () -> __unknown__ {\n}\n");
 }
 
@@ -23,7 +23,7 @@ function foo(a1:t1,a2:t2) {}
   auto file = parser.parse();
 
   ASSERT_EQ(file->statement().size(), 1);
-  ASSERT_NE(std::dynamic_pointer_cast<FunctionStatement>(file->statement()[0]), nullptr);
+  ASSERT_NE(dynamic_cast<FunctionStatement *>(file->statement()[0]), nullptr);
   ASSERT_EQ(file->statement()[0]->to_string(), "fn foo (a1:t1, a2:t2) -> __unknown__ {\n}\n");
 }
 
@@ -34,6 +34,11 @@ function foo() : i32 {}
   auto file = parser.parse();
 
   ASSERT_EQ(file->statement().size(), 1);
-  ASSERT_NE(std::dynamic_pointer_cast<FunctionStatement>(file->statement()[0]), nullptr);
+  ASSERT_NE(dynamic_cast<FunctionStatement *>(file->statement()[0]), nullptr);
   ASSERT_EQ(file->statement()[0]->to_string(), "fn foo () -> i32 {\n}\n");
 }
+
+TEST(ParseFunction, AbortOnRecoveredSyntaxError) {
+  // the missing `}` at the end of input must not be silently conjured up
+  EXPECT_DEATH(FileParser("test.wa", "function foo() : i32 {").parse(), "unexpected|syntax errors");
+}
@@ -13,7 +13,7 @@ a.b;
   auto file = parser.parse();
 
   ASSERT_EQ(file->statement().size(), 1);
-  ASSERT_NE(std::dynamic_pointer_cast<ExpressionStatement>(file->statement()[0]), nullptr);
+  ASSERT_NE(dynamic_cast<ExpressionStatement *>(file->statement()[0]), nullptr);
   ASSERT_EQ(file->statement()[0]->to_string(), "a.b\n");
 }
 TEST(ParseMemberExpression, Priority) {
@@ -23,7 +23,7 @@ a.b + 1;
   auto file = parser.parse();
 
   ASSERT_EQ(file->statement().size(), 1);
-  ASSERT_NE(std::dynamic_pointer_cast<ExpressionStatement>(file->statement()[0]), nullptr);
+  ASSERT_NE(dynamic_cast<ExpressionStatement *>(file->statement()[0]), nullptr);
   ASSERT_EQ(file->statement()[0]->to_string(), "(ADD a.b 1)\n");
 }
 TEST(ParseMemberExpression, PriorityWithCall) {
@@ -33,6 +33,6 @@ a.b(c.d,e.f);
   auto file = parser.parse();
 
   ASSERT_EQ(file->statement().size(), 1);
-  ASSERT_NE(std::dynamic_pointer_cast<ExpressionStatement>(file->statement()[0]), nullptr);
+  ASSERT_NE(dynamic_cast<ExpressionStatement *>(file->statement()[0]), nullptr);
   ASSERT_EQ(file->statement()[0]->to_string(), "a.b(c.d, e.f)\n");
 }